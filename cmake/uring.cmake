@@ -0,0 +1,15 @@
+INCLUDE(CheckIncludeFiles)
+IF(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+  OPTION(WITH_URING "Use io_uring for asynchronous I/O instead of libaio" OFF)
+  IF(WITH_URING)
+    FIND_LIBRARY(LIBURING uring)
+    CHECK_INCLUDE_FILES(liburing.h HAVE_LIBURING_H)
+    IF (NOT LIBURING)
+      MESSAGE(FATAL_ERROR "Can't find liburing")
+    ELSEIF(NOT HAVE_LIBURING_H)
+      MESSAGE(FATAL_ERROR "Can't find liburing.h")
+    ELSE()
+      ADD_DEFINITIONS(-DHAVE_URING)
+    ENDIF()
+  ENDIF()
+ENDIF()
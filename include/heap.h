@@ -51,6 +51,7 @@ typedef struct st_heapinfo		/* Struct from heap_info */
   int errkey;
   ulonglong auto_increment;
   time_t create_time;
+  uchar *dupp_key_pos;			/* Record with the duplicate key */
 } HEAPINFO;
 
 
@@ -109,6 +110,12 @@ typedef struct st_heap_block
 
 struct st_heap_info;			/* For referense */
 
+typedef struct st_hp_blob_desc		/* A BLOB column of the table */
+{
+  uint offset;				/* Offset of the blob in record */
+  uint packlength;			/* Number of bytes storing the length */
+} HP_BLOB_DESC;
+
 typedef struct st_hp_keydef		/* Key definition with open */
 {
   uint flag;				/* HA_NOSAME | HA_NULL_PART_KEY */
@@ -158,6 +165,11 @@ typedef struct st_heap_share
   LIST open_list;
   uint auto_key;
   uint auto_key_type;			/* real type of the auto key segment */
+  HP_BLOB_DESC *blob_descs;
+  uint blobs;				/* Number of BLOB columns */
+  HP_BLOCK blob_block;			/* Where the data of blobs is saved */
+  ulong blob_chunks;			/* Chunks taken from blob_block */
+  uchar *blob_del_link;			/* Link to next free chunk */
 } HP_SHARE;
 
 struct st_hp_hash_info;
@@ -179,6 +191,12 @@ typedef struct st_heap_info
   uint key_version;                     /* Version at last read */
   uint file_version;                    /* Version at scan */
   uint lastkey_len;
+  uchar *blob_record;			/* Record buffer for heap_update() */
+  uchar *blob_buffer;			/* The data of the blobs of last read */
+  size_t blob_buffer_length;
+  uchar *blob_key_buffer;		/* Blob of a record compared in a key */
+  size_t blob_key_buffer_length;
+  uchar *dupp_key_pos;			/* Record with the duplicate key */
   my_bool implicit_emptied;
   THR_LOCK_DATA lock;
   LIST open_list;
@@ -188,6 +206,8 @@ typedef struct st_heap_info
 typedef struct st_heap_create_info
 {
   HP_KEYDEF *keydef;
+  HP_BLOB_DESC *blob_descs;
+  uint blobs;
   uint auto_key;                        /* keynr [1 - maxkey] for auto key */
   uint auto_key_type;
   uint keys;
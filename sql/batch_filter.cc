@@ -0,0 +1,657 @@
+/*
+   Copyright (c) 2021, MariaDB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "mariadb.h"
+#include "sql_class.h"
+#include "sql_select.h"
+#include "batch_filter.h"
+#include <functional>
+
+
+/*
+  Loaders of the field values from the record buffer.
+  Integer fields are stored in the little-endian format, DATE fields are
+  stored as 3-byte unsigned integers year*512 + month*32 + day.
+*/
+
+static inline longlong load_tiny(const uchar *ptr)
+{ return (longlong) (signed char) ptr[0]; }
+static inline ulonglong load_utiny(const uchar *ptr)
+{ return (ulonglong) ptr[0]; }
+static inline longlong load_short(const uchar *ptr)
+{ return (longlong) sint2korr(ptr); }
+static inline ulonglong load_ushort(const uchar *ptr)
+{ return (ulonglong) uint2korr(ptr); }
+static inline longlong load_medium(const uchar *ptr)
+{ return (longlong) sint3korr(ptr); }
+static inline ulonglong load_umedium(const uchar *ptr)
+{ return (ulonglong) uint3korr(ptr); }
+static inline longlong load_long(const uchar *ptr)
+{ return (longlong) sint4korr(ptr); }
+static inline ulonglong load_ulong(const uchar *ptr)
+{ return (ulonglong) uint4korr(ptr); }
+static inline longlong load_longlong(const uchar *ptr)
+{ return sint8korr(ptr); }
+static inline ulonglong load_ulonglong(const uchar *ptr)
+{ return uint8korr(ptr); }
+
+
+/*
+  The kernels.
+
+  Each kernel leaves in sel[] only the numbers of the records for which
+  the field is not NULL and the comparison holds. The selection vector is
+  compacted without branches so that the loop can be vectorized.
+*/
+
+template <typename T, T (*load)(const uchar *), class Cmp>
+static uint filter_int(const Batch_filter::Kernel *kernel,
+                       const uchar *records, size_t reclength,
+                       uint *sel, uint n)
+{
+  const T value= (T) kernel->value;
+  const uchar *val_ptr= records + kernel->offset;
+  const uchar *null_ptr= records + kernel->null_offset;
+  const uchar null_bit= kernel->null_bit;
+  Cmp cmp;
+  uint res= 0;
+  for (uint i= 0; i < n; i++)
+  {
+    size_t pos= sel[i] * reclength;
+    sel[res]= sel[i];
+    res+= !(null_ptr[pos] & null_bit) & cmp(load(val_ptr + pos), value);
+  }
+  return res;
+}
+
+
+/*
+  DECIMAL values with the same precision and scale are compared as
+  binary strings: this is how they are compared in indexes.
+*/
+
+template <class Cmp>
+static uint filter_decimal(const Batch_filter::Kernel *kernel,
+                           const uchar *records, size_t reclength,
+                           uint *sel, uint n)
+{
+  const uchar *value= kernel->bin_value;
+  const uint length= kernel->bin_length;
+  const uchar *val_ptr= records + kernel->offset;
+  const uchar *null_ptr= records + kernel->null_offset;
+  const uchar null_bit= kernel->null_bit;
+  Cmp cmp;
+  uint res= 0;
+  for (uint i= 0; i < n; i++)
+  {
+    size_t pos= sel[i] * reclength;
+    sel[res]= sel[i];
+    res+= !(null_ptr[pos] & null_bit) &
+          cmp(memcmp(val_ptr + pos, value, length), 0);
+  }
+  return res;
+}
+
+
+template <typename T, T (*load)(const uchar *)>
+static Batch_filter::Kernel_func int_kernel(Batch_filter::Cmp_op op)
+{
+  switch (op) {
+  case Batch_filter::CMP_EQ:
+    return filter_int<T, load, std::equal_to<T> >;
+  case Batch_filter::CMP_NE:
+    return filter_int<T, load, std::not_equal_to<T> >;
+  case Batch_filter::CMP_LT:
+    return filter_int<T, load, std::less<T> >;
+  case Batch_filter::CMP_LE:
+    return filter_int<T, load, std::less_equal<T> >;
+  case Batch_filter::CMP_GT:
+    return filter_int<T, load, std::greater<T> >;
+  case Batch_filter::CMP_GE:
+    return filter_int<T, load, std::greater_equal<T> >;
+  }
+  DBUG_ASSERT(0);
+  return NULL;
+}
+
+
+static Batch_filter::Kernel_func decimal_kernel(Batch_filter::Cmp_op op)
+{
+  switch (op) {
+  case Batch_filter::CMP_EQ:
+    return filter_decimal<std::equal_to<int> >;
+  case Batch_filter::CMP_NE:
+    return filter_decimal<std::not_equal_to<int> >;
+  case Batch_filter::CMP_LT:
+    return filter_decimal<std::less<int> >;
+  case Batch_filter::CMP_LE:
+    return filter_decimal<std::less_equal<int> >;
+  case Batch_filter::CMP_GT:
+    return filter_decimal<std::greater<int> >;
+  case Batch_filter::CMP_GE:
+    return filter_decimal<std::greater_equal<int> >;
+  }
+  DBUG_ASSERT(0);
+  return NULL;
+}
+
+
+/*
+  An error handler that suppresses all conditions raised when the constant
+  arguments of the compiled predicates are evaluated and remembers whether
+  there were any.
+*/
+
+class Batch_filter_error_handler : public Internal_error_handler
+{
+public:
+  bool raised;
+  Batch_filter_error_handler() : raised(false) {}
+  bool handle_condition(THD *thd,
+                        uint sql_errno,
+                        const char* sqlstate,
+                        Sql_condition::enum_warning_level *level,
+                        const char* msg,
+                        Sql_condition ** cond_hdl)
+  {
+    raised= true;
+    return true;
+  }
+};
+
+
+Batch_filter::Batch_filter(JOIN_TAB *tab_arg)
+  : tab(tab_arg), table(tab_arg->table), n_kernels(0),
+    records(NULL), sel(NULL), max_records(0), n_records(0), n_selected(0),
+    sel_pos(0), next_record(0), read_error(0), read_func(NULL)
+{}
+
+
+Batch_filter::Cmp_op Batch_filter::swap_op(Cmp_op op)
+{
+  switch (op) {
+  case CMP_LT: return CMP_GT;
+  case CMP_LE: return CMP_GE;
+  case CMP_GT: return CMP_LT;
+  case CMP_GE: return CMP_LE;
+  default:     return op;
+  }
+}
+
+
+/**
+  @brief
+    Reserve a new kernel for a predicate over a field of the table
+
+  @param field       the field whose values are checked by the kernel
+  @param kernel OUT  the reserved kernel
+
+  @retval false  the kernel is reserved
+  @retval true   the field does not belong to the table or there are
+                 too many kernels
+*/
+
+bool Batch_filter::add_kernel(Field *field, Kernel **kernel)
+{
+  if (n_kernels == MAX_KERNELS || field->table != table)
+    return true;
+  Kernel *k= &kernels[n_kernels];
+  k->offset= field->offset(table->record[0]);
+  if (field->null_ptr)
+  {
+    k->null_offset= (uint) (field->null_ptr - table->record[0]);
+    k->null_bit= field->null_bit;
+  }
+  else
+  {
+    k->null_offset= 0;
+    k->null_bit= 0;
+  }
+  k->value= 0;
+  k->bin_value= NULL;
+  k->bin_length= 0;
+  *kernel= k;
+  return false;
+}
+
+
+/**
+  @brief
+    Compile the predicate 'field <op> value' over an integer field
+
+  @param field           the field of the table
+  @param op              the comparison operation
+  @param value           the constant to compare with
+  @param value_unsigned  whether value is unsigned
+
+  @retval true   a kernel has been added to the filter
+  @retval false  the predicate cannot be checked by the filter
+*/
+
+bool Batch_filter::add_int_cmp(Field *field, Cmp_op op, longlong value,
+                               bool value_unsigned)
+{
+  Kernel *k;
+  Kernel_func func;
+  bool field_unsigned;
+  switch (field->real_type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    break;
+  default:
+    return false;
+  }
+  field_unsigned= ((Field_num *) field)->unsigned_flag;
+  /*
+    The kernels compare the values in the domain of the field: values
+    that do not fit into this domain are not supported.
+  */
+  if (value < 0 && field_unsigned != value_unsigned)
+    return false;
+  switch (field->real_type()) {
+  case MYSQL_TYPE_TINY:
+    func= field_unsigned ? int_kernel<ulonglong, load_utiny>(op) :
+                           int_kernel<longlong, load_tiny>(op);
+    break;
+  case MYSQL_TYPE_SHORT:
+    func= field_unsigned ? int_kernel<ulonglong, load_ushort>(op) :
+                           int_kernel<longlong, load_short>(op);
+    break;
+  case MYSQL_TYPE_INT24:
+    func= field_unsigned ? int_kernel<ulonglong, load_umedium>(op) :
+                           int_kernel<longlong, load_medium>(op);
+    break;
+  case MYSQL_TYPE_LONG:
+    func= field_unsigned ? int_kernel<ulonglong, load_ulong>(op) :
+                           int_kernel<longlong, load_long>(op);
+    break;
+  case MYSQL_TYPE_LONGLONG:
+    func= field_unsigned ? int_kernel<ulonglong, load_ulonglong>(op) :
+                           int_kernel<longlong, load_longlong>(op);
+    break;
+  default:
+    return false;
+  }
+  if (add_kernel(field, &k))
+    return false;
+  k->func= func;
+  k->value= value;
+  n_kernels++;
+  return true;
+}
+
+
+/**
+  @brief
+    Compile the predicate 'field <op> value' over a DECIMAL field
+
+  @details
+    The predicate is compiled only if the binary image of value for the
+    precision and the scale of the field represents value exactly.
+*/
+
+bool Batch_filter::add_decimal_cmp(Field_new_decimal *field, Cmp_op op,
+                                   const my_decimal *value)
+{
+  Kernel *k;
+  uchar *bin;
+  my_decimal tmp;
+  uint length= field->pack_length();
+  /*
+    Zero may have two binary images (for 0 and for -0), they are not
+    equal as binary strings.
+  */
+  if (my_decimal_is_zero(value))
+    return false;
+  if (!(bin= (uchar *) table->in_use->alloc(length)) ||
+      value->to_binary(bin, field->precision, field->dec, 0) ||
+      binary2my_decimal(0, bin, &tmp, field->precision, field->dec) ||
+      my_decimal_cmp(&tmp, value))
+    return false;
+  if (add_kernel(field, &k))
+    return false;
+  k->func= decimal_kernel(op);
+  k->bin_value= bin;
+  k->bin_length= length;
+  n_kernels++;
+  return true;
+}
+
+
+/**
+  @brief
+    Compile the predicate 'field <op> value' over a DATE field
+
+  @details
+    The predicate is compiled only if value does not have a time part,
+    so that it can be represented in the storage format of DATE.
+*/
+
+bool Batch_filter::add_date_cmp(Field *field, Cmp_op op,
+                                const MYSQL_TIME *value)
+{
+  Kernel *k;
+  if (value->neg || value->hour || value->minute || value->second ||
+      value->second_part || value->month > 12 || value->day > 31 ||
+      add_kernel(field, &k))
+    return false;
+  k->func= int_kernel<ulonglong, load_umedium>(op);
+  k->value= (longlong) (value->year * 16 * 32 + value->month * 32 +
+                        value->day);
+  n_kernels++;
+  return true;
+}
+
+
+/**
+  @brief
+    Compile the predicate 'field <op> value' into a kernel of the filter
+
+  @param thd          the thread handle
+  @param field        the field of the table
+  @param op           the comparison operation
+  @param value        the constant item to compare with
+  @param cmp_handler  the type handler used to compare the arguments
+
+  @details
+    The method evaluates value and, if the way the predicate compares the
+    arguments is supported by the filter, adds a kernel for it. Any
+    warnings raised when evaluating value are suppressed and make the
+    predicate to be skipped: they will be raised again when the predicate
+    is evaluated in the usual way.
+
+  @retval true   a kernel has been added to the filter
+  @retval false  the predicate cannot be checked by the filter
+*/
+
+bool Batch_filter::add_cmp(THD *thd, Field *field, Cmp_op op, Item *value,
+                           const Type_handler *cmp_handler)
+{
+  bool res= false;
+  if (!value->const_item() || value->is_expensive() ||
+      field->table != table || n_kernels == MAX_KERNELS)
+    return false;
+
+  Batch_filter_error_handler error_handler;
+  thd->push_internal_handler(&error_handler);
+  switch (cmp_handler->cmp_type()) {
+  case INT_RESULT:
+  {
+    longlong val= value->val_int();
+    if (!value->null_value && !error_handler.raised)
+      res= add_int_cmp(field, op, val, value->unsigned_flag);
+    break;
+  }
+  case DECIMAL_RESULT:
+  {
+    my_decimal buf;
+    my_decimal *val;
+    if (field->real_type() != MYSQL_TYPE_NEWDECIMAL)
+      break;
+    val= value->val_decimal(&buf);
+    if (!value->null_value && val && !error_handler.raised)
+      res= add_decimal_cmp((Field_new_decimal *) field, op, val);
+    break;
+  }
+  case TIME_RESULT:
+  {
+    MYSQL_TIME ltime;
+    longlong packed;
+    if (field->real_type() != MYSQL_TYPE_NEWDATE ||
+        (cmp_handler->field_type() != MYSQL_TYPE_DATE &&
+         cmp_handler->field_type() != MYSQL_TYPE_DATETIME))
+      break;
+    packed= value->val_datetime_packed(thd);
+    if (value->null_value || error_handler.raised)
+      break;
+    unpack_time(packed, &ltime, MYSQL_TIMESTAMP_DATETIME);
+    res= add_date_cmp(field, op, &ltime);
+    break;
+  }
+  default:
+    break;
+  }
+  thd->pop_internal_handler();
+  return res;
+}
+
+
+/**
+  @brief
+    Allocate the buffers for the batches of records
+
+  @retval false  ok
+  @retval true   out of memory
+*/
+
+bool Batch_filter::alloc_buffers(THD *thd)
+{
+  size_t reclength= table->s->reclength;
+  max_records= (uint) MY_MIN(MAX_BATCH_RECORDS,
+                             thd->variables.read_buff_size / reclength);
+  set_if_bigger(max_records, 2);
+  return !(records= (uchar *) thd->alloc(max_records * reclength)) ||
+         !(sel= (uint *) thd->alloc(max_records * sizeof(uint)));
+}
+
+
+/**
+  @brief
+    Apply the kernels of the filter to a batch of records
+
+  @param batch     the records of the batch
+  @param selected  OUT the numbers of the records that passed the filter
+  @param n         the number of records in the batch
+
+  @return  the number of records that passed the filter
+*/
+
+uint Batch_filter::filter(uchar *batch, uint *selected, uint n) const
+{
+  size_t reclength= table->s->reclength;
+  for (uint i= 0; i < n; i++)
+    selected[i]= i;
+  for (uint i= 0; i < n_kernels && n; i++)
+    n= kernels[i].func(&kernels[i], batch, reclength, selected, n);
+  return n;
+}
+
+
+/*
+  The implementations of Item::add_to_batch_filter()
+*/
+
+bool Item_bool_rowready_func2::add_to_batch_filter(THD *thd,
+                                                   Batch_filter *filter)
+{
+  Batch_filter::Cmp_op op;
+  switch (functype()) {
+  case EQ_FUNC: op= Batch_filter::CMP_EQ; break;
+  case NE_FUNC: op= Batch_filter::CMP_NE; break;
+  case LT_FUNC: op= Batch_filter::CMP_LT; break;
+  case LE_FUNC: op= Batch_filter::CMP_LE; break;
+  case GT_FUNC: op= Batch_filter::CMP_GT; break;
+  case GE_FUNC: op= Batch_filter::CMP_GE; break;
+  default:
+    /* In particular NULL-safe equality is not supported */
+    return false;
+  }
+  for (uint i= 0; i < 2; i++)
+  {
+    Item *field_item= args[i]->real_item();
+    if (field_item->type() == FIELD_ITEM &&
+        filter->add_cmp(thd, ((Item_field *) field_item)->field,
+                        i ? Batch_filter::swap_op(op) : op, args[1 - i],
+                        cmp.compare_type_handler()))
+      return true;
+  }
+  return false;
+}
+
+
+bool Item_func_between::add_to_batch_filter(THD *thd, Batch_filter *filter)
+{
+  Item *field_item= args[0]->real_item();
+  if (negated || field_item->type() != FIELD_ITEM)
+    return false;
+  Field *field= ((Item_field *) field_item)->field;
+  const Type_handler *handler= m_comparator.type_handler();
+  bool res= filter->add_cmp(thd, field, Batch_filter::CMP_GE, args[1],
+                            handler);
+  return filter->add_cmp(thd, field, Batch_filter::CMP_LE, args[2],
+                         handler) || res;
+}
+
+
+bool Item_cond_and::add_to_batch_filter(THD *thd, Batch_filter *filter)
+{
+  List_iterator_fast<Item> li(list);
+  Item *item;
+  bool res= false;
+  while ((item= li++))
+  {
+    if (item->add_to_batch_filter(thd, filter))
+      res= true;
+  }
+  return res;
+}
+
+
+static int rr_batch_filter(READ_RECORD *info)
+{
+  return info->batch_filter->read_record(info);
+}
+
+
+/**
+  @brief
+    Make the filter read the records of the table for info
+
+  @details
+    The function is called after init_read_record() has set up the
+    function reading the records of the table. This function is replaced
+    for a function that reads the records by batches.
+*/
+
+void Batch_filter::init_read(READ_RECORD *info)
+{
+  read_func= info->read_record_func;
+  n_records= n_selected= sel_pos= next_record= 0;
+  read_error= 0;
+  info->batch_filter= this;
+  info->read_record_func= rr_batch_filter;
+}
+
+
+/*
+  The records of a batch rejected by the filter are accounted for as if
+  they were rejected by the condition pushed to the table.
+*/
+
+void Batch_filter::count_skipped_records(uint n)
+{
+  Diagnostics_area *da= table->in_use->get_stmt_da();
+  tab->tracker->r_rows+= n;
+  while (n--)
+    da->inc_current_row_for_warning();
+}
+
+
+int Batch_filter::read_batch(READ_RECORD *info)
+{
+  size_t reclength= table->s->reclength;
+  uchar *pos= records;
+  for (n_records= 0; n_records < max_records; n_records++, pos+= reclength)
+  {
+    if ((read_error= read_func(info)))
+      break;
+    memcpy(pos, table->record[0], reclength);
+  }
+  if (read_error > 0)
+    return read_error;
+  n_selected= filter(records, sel, n_records);
+  sel_pos= next_record= 0;
+  return 0;
+}
+
+
+/**
+  @brief
+    Read the next record of the table that has passed the filter
+
+  @details
+    The record is copied into table->record[0].
+
+  @retval 0    ok
+  @retval -1   there are no more records
+  @retval > 0  error
+*/
+
+int Batch_filter::read_record(READ_RECORD *info)
+{
+  int error;
+  for ( ; ; )
+  {
+    if (sel_pos < n_selected)
+    {
+      uint rec= sel[sel_pos++];
+      count_skipped_records(rec - next_record);
+      next_record= rec + 1;
+      memcpy(table->record[0], records + rec * table->s->reclength,
+             table->s->reclength);
+      return 0;
+    }
+    count_skipped_records(n_records - next_record);
+    next_record= n_records;
+    if (read_error)
+      return read_error;
+    if ((error= read_batch(info)))
+      return error;
+  }
+}
+
+
+/**
+  @brief
+    Create a batch filter for the condition pushed to a table
+
+  @param thd  the thread handle
+  @param tab  the join table whose records are to be filtered
+
+  @details
+    The function compiles the conjuncts of tab->select_cond supported by
+    the batch filters into kernels.
+
+  @retval
+    the created filter if at least one kernel has been compiled
+  @retval
+    NULL otherwise
+*/
+
+Batch_filter *Batch_filter::create(THD *thd, JOIN_TAB *tab)
+{
+  Batch_filter *filter;
+  if (!tab->select_cond ||
+      !(filter= new (thd->mem_root) Batch_filter(tab)))
+    return NULL;
+  if (!tab->select_cond->add_to_batch_filter(thd, filter) ||
+      filter->alloc_buffers(thd))
+    return NULL;
+  return filter;
+}
@@ -0,0 +1,150 @@
+/*
+   Copyright (c) 2021, MariaDB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef BATCH_FILTER_INCLUDED
+#define BATCH_FILTER_INCLUDED
+
+#include "mariadb.h"
+#include "sql_class.h"
+#include "records.h"
+
+/*
+
+  Batch filters
+  -------------
+
+  When a table is scanned the condition pushed to the table is evaluated
+  by evaluate_join_record() for every row with a call of the virtual
+  method val_int() of the condition, which in its turn calls val_int(),
+  val_decimal() etc. of the arguments of the condition. For full scans
+  with selective conditions the cost of this interpretation dominates.
+
+  A batch filter is built for such a scan out of the simple conjuncts of
+  the condition that compare a field of the table with a constant:
+    field <op> const,  field BETWEEN const1 AND const2
+  where <op> is one of =, <>, <, <=, >, >= and the comparison is performed
+  on integer, decimal or date values. Each such conjunct is compiled into
+  a kernel: a function specialized for the storage format of the field and
+  the comparison operation that checks the conjunct for the field value
+  taken directly from a record buffer.
+
+  The records of the table are then read in batches: up to
+  Batch_filter::max_records records are read one after another and copied
+  into the buffer of the filter, after which each kernel is applied to all
+  records of the batch that have passed the previous kernels. Only the
+  records that have passed all kernels are returned to the caller of
+  READ_RECORD::read_record(). As the kernels are necessary conditions for
+  the pushed condition the latter is still evaluated for each returned
+  record.
+
+  A kernel is a tight loop over the batch without any calls of virtual
+  functions, which the compiler can unroll and vectorize.
+
+  The items that can be compiled into kernels implement the virtual method
+  Item::add_to_batch_filter().
+*/
+
+class Field_new_decimal;
+class my_decimal;
+
+class Batch_filter : public Sql_alloc
+{
+public:
+  /* Comparison operations supported by the kernels */
+  enum Cmp_op { CMP_EQ, CMP_NE, CMP_LT, CMP_LE, CMP_GT, CMP_GE };
+
+  struct Kernel;
+  /*
+    The function that checks the conjunct for the records of the batch
+    whose numbers are in sel[0..n-1]. It leaves the numbers of the records
+    that meet the conjunct at the beginning of sel and returns their count.
+  */
+  typedef uint (*Kernel_func)(const Kernel *kernel, const uchar *records,
+                              size_t reclength, uint *sel, uint n);
+
+  /* Description of a kernel checking a conjunct for a batch of records */
+  struct Kernel
+  {
+    Kernel_func func;
+    /* Offset of the field value in the record */
+    uint offset;
+    /* Offset of the null byte of the field in the record, and the null bit */
+    uint null_offset;
+    uchar null_bit;
+    /* The constant to compare with for integer and date comparisons */
+    longlong value;
+    /* The binary image of the constant for decimal comparisons */
+    uchar *bin_value;
+    uint bin_length;
+  };
+
+private:
+  /* Maximum number of kernels in a filter */
+  static const uint MAX_KERNELS= 16;
+  /* Maximum number of records in a batch */
+  static const uint MAX_BATCH_RECORDS= 1024;
+
+  JOIN_TAB *tab;
+  TABLE *table;
+
+  Kernel kernels[MAX_KERNELS];
+  uint n_kernels;
+
+  /* The buffer with the records of the current batch */
+  uchar *records;
+  /* Numbers of the records from the batch that have passed the filter */
+  uint *sel;
+  /* Maximum number of records in a batch */
+  uint max_records;
+  /* Number of records in the current batch */
+  uint n_records;
+  /* Number of records from the batch that have passed the filter */
+  uint n_selected;
+  /* Position of the next record to return in sel */
+  uint sel_pos;
+  /* Number of the last record of the batch returned to the caller plus 1 */
+  uint next_record;
+  /* The error returned by the last read of the underlying read function */
+  int read_error;
+  /* The function reading the records of the table */
+  READ_RECORD::Read_func read_func;
+
+  bool add_kernel(Field *field, Kernel **kernel);
+  bool add_int_cmp(Field *field, Cmp_op op, longlong value,
+                   bool value_unsigned);
+  bool add_decimal_cmp(Field_new_decimal *field, Cmp_op op,
+                       const my_decimal *value);
+  bool add_date_cmp(Field *field, Cmp_op op, const MYSQL_TIME *value);
+  bool alloc_buffers(THD *thd);
+  void count_skipped_records(uint n);
+  int read_batch(READ_RECORD *info);
+
+public:
+  Batch_filter(JOIN_TAB *tab_arg);
+
+  bool add_cmp(THD *thd, Field *field, Cmp_op op, Item *value,
+               const Type_handler *cmp_handler);
+
+  uint filter(uchar *batch, uint *selected, uint n) const;
+
+  void init_read(READ_RECORD *info);
+  int read_record(READ_RECORD *info);
+
+  static Cmp_op swap_op(Cmp_op op);
+  static Batch_filter *create(THD *thd, JOIN_TAB *tab);
+};
+
+#endif /* BATCH_FILTER_INCLUDED */
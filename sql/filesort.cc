@@ -35,6 +35,7 @@
 #include "filesort_utils.h"
 #include "sql_select.h"
 #include "debug_sync.h"
+#include "mysys_err.h"
 
 	/* functions defined in this file */
 
@@ -1615,6 +1616,187 @@ static bool check_if_pq_applicable(Sort_param *param,
 }
 
 
+/**
+  write_function of the IO_CACHE that a merge task writes with:
+  the tasks of a merge pass write to the same file at the same time.
+*/
+static int merge_task_write(IO_CACHE *info, const uchar *buffer, size_t count)
+{
+  if (mysql_file_pwrite(info->file, buffer, count, info->pos_in_file,
+                        info->myflags | MY_NABP))
+    return info->error= -1;
+  info->pos_in_file+= count;
+  return 0;
+}
+
+
+namespace {
+/**
+  One merge_many_buff() pass, done by the filesort helper threads.
+
+  The pass merges the same groups of chunks as the sequential one. As
+  every record is written, the result of a group takes the same place in
+  to_file as its chunks take in from_file, so each group is written at
+  the file position of its first chunk, independently of the others.
+  Each task uses its own part of the sort buffer and its own write cache,
+  and takes the next group to merge until none is left.
+*/
+struct Parallel_merge
+{
+  Sort_param *param;
+  IO_CACHE *from_file, *to_file;
+  Sort_buffer sort_buffer;
+  Merge_chunk *buffpek;
+  uint maxbuffer;
+  /** number of groups, and of tasks */
+  uint groups, tasks;
+  /** result of each group */
+  Merge_chunk *result;
+  std::atomic<uint> next_group;
+  /** my_errno of the first failed task, or 0 */
+  std::atomic<int> error;
+  /** EE_READ, EE_WRITE or 0 (out of memory) for the first failed task */
+  int error_code;
+  /** the file that error_code refers to */
+  File error_file;
+
+  /** Note the error of a task, unless another task failed first. */
+  void set_error(int code, File file)
+  {
+    int expected= 0;
+    if (error.compare_exchange_strong(expected, my_errno ? my_errno : -1))
+    {
+      error_code= code;
+      error_file= file;
+    }
+  }
+
+  uint group_first(uint g) const { return g * MERGEBUFF; }
+  uint group_last(uint g) const
+  {
+    return g + 1 == groups ? maxbuffer : group_first(g) + MERGEBUFF - 1;
+  }
+
+  static void merge_task(void *arg, uint i)
+  {
+    Parallel_merge *m= static_cast<Parallel_merge*>(arg);
+    const size_t size= m->sort_buffer.size() / m->tasks;
+    Sort_buffer buffer(m->sort_buffer.array() + i * size, size);
+    Sort_param param= *m->param;
+    param.max_keys_per_buffer/= m->tasks;
+    /* The caller checks for KILL between the passes. */
+    param.not_killable= true;
+    /* Errors are reported by the caller, which has a THD. */
+    IO_CACHE from= *m->from_file;
+    from.myflags&= ~MY_WME;
+
+    for (uint g; !m->error && (g= m->next_group++) < m->groups; )
+    {
+      Merge_chunk *first= m->buffpek + m->group_first(g);
+      IO_CACHE to;
+      if (init_io_cache(&to, m->to_file->file, DISK_BUFFER_SIZE, WRITE_CACHE,
+                        first->file_position(), 0, MYF(0)))
+      {
+        m->set_error(0, -1);
+        return;
+      }
+      to.write_function= merge_task_write;
+      m->result[g]= *first;
+      bool failed= merge_buffers(&param, &from, &to, buffer, &m->result[g],
+                                 first, m->buffpek + m->group_last(g), 0);
+      if (end_io_cache(&to) || failed)
+      {
+        if (to.error)
+          m->set_error(EE_WRITE, to.file);
+        else if (from.error)
+          m->set_error(EE_READ, from.file);
+        else
+          m->set_error(0, -1);
+      }
+    }
+  }
+};
+}
+
+
+/**
+  Do one pass of merge_many_buff() by the filesort helper threads,
+  if possible.
+
+  @retval -1 the pass cannot be done in parallel
+  @retval 0  ok
+  @retval 1  error
+*/
+static int merge_many_buff_parallel(Sort_param *param, Sort_buffer sort_buffer,
+                                    Merge_chunk *buffpek, uint *maxbuffer,
+                                    IO_CACHE *from_file, IO_CACHE *to_file)
+{
+  if (!filesort_threads_enabled() || param->unique_buff ||
+      ((from_file->myflags | to_file->myflags) & MY_ENCRYPT))
+    return -1;
+
+  ha_rows rows= 0;
+  for (uint i= 0; i <= *maxbuffer; i++)
+    rows+= buffpek[i].rowcount();
+  /* With a LIMIT, the groups would not fill their place in to_file. */
+  if (rows > param->max_rows)
+    return -1;
+
+  Parallel_merge m;
+  m.groups= (*maxbuffer - MERGEBUFF*3/2) / MERGEBUFF + 2;
+  m.tasks= MY_MIN(MY_MIN(filesort_threads, m.groups),
+                  param->max_keys_per_buffer / (MERGEBUFF2 * 2));
+  if (m.tasks < 2)
+    return -1;
+
+  /* Make sure that to_file is open: the tasks write to it directly. */
+  if (flush_io_cache(to_file))
+    return 1;
+
+  if (!(m.result= (Merge_chunk*) my_malloc(PSI_INSTRUMENT_ME,
+                                           m.groups * sizeof *m.result,
+                                           MYF(MY_WME | MY_THREAD_SPECIFIC))))
+    return 1;
+  m.param= param;
+  m.from_file= from_file;
+  m.to_file= to_file;
+  m.sort_buffer= sort_buffer;
+  m.buffpek= buffpek;
+  m.maxbuffer= *maxbuffer;
+  m.next_group= 0;
+  m.error= 0;
+
+  filesort_run_tasks(m.tasks, Parallel_merge::merge_task, &m);
+
+  THD *thd= current_thd;
+  /* Report a kill that arrived during the pass before any task failure. */
+  if (!param->not_killable && thd->check_killed())
+  {
+    my_free(m.result);
+    return 1;
+  }
+  if (m.error)
+  {
+    if (m.error_code)
+      my_error(m.error_code, MYF(0), my_filename(m.error_file), m.error);
+    else
+      my_error(ER_OUT_OF_RESOURCES, MYF(0));
+    my_free(m.result);
+    return 1;
+  }
+
+  for (uint g= 0; g < m.groups; g++)
+    thd->inc_status_sort_merge_passes();
+  thd->query_plan_fsort_passes+= m.groups;
+
+  memcpy(buffpek, m.result, m.groups * sizeof *m.result);
+  my_free(m.result);
+  *maxbuffer= m.groups - 1;
+  /* The result is as long as the input. */
+  return reinit_io_cache(to_file, WRITE_CACHE, from_file->end_of_file, 0, 1);
+}
+
+
 /** Merge buffers to make < MERGEBUFF2 buffers. */
 
 int merge_many_buff(Sort_param *param, Sort_buffer sort_buffer,
@@ -1639,6 +1821,15 @@ int merge_many_buff(Sort_param *param, Sort_buffer sort_buffer,
       goto cleanup;
     if (reinit_io_cache(to_file,WRITE_CACHE,0L,0,0))
       goto cleanup;
+    int res= merge_many_buff_parallel(param, sort_buffer, buffpek, maxbuffer,
+                                      from_file, to_file);
+    if (res > 0)
+      goto cleanup;
+    if (!res)
+    {
+      temp=from_file; from_file=to_file; to_file=temp;
+      continue;
+    }
     lastbuff=buffpek;
     for (i=0 ; i <= *maxbuffer-MERGEBUFF*3/2 ; i+=MERGEBUFF)
     {
@@ -1823,8 +2014,12 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
   THD* const thd=current_thd;
   DBUG_ENTER("merge_buffers");
 
-  thd->inc_status_sort_merge_passes();
-  thd->query_plan_fsort_passes++;
+  /* NULL in the tasks of merge_many_buff_parallel() */
+  if (thd)
+  {
+    thd->inc_status_sort_merge_passes();
+    thd->query_plan_fsort_passes++;
+  }
 
   rec_length= param->rec_length;
   res_length= param->res_length;
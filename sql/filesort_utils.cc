@@ -19,10 +19,86 @@
 #include "sql_const.h"
 #include "sql_sort.h"
 #include "table.h"
+#include <tpool.h>
+#include <algorithm>
+#include <vector>
 
 
 PSI_memory_key key_memory_Filesort_buffer_sort_keys;
 
+/** Helper threads of filesort, or NULL if filesort_threads == 0 */
+static tpool::thread_pool *filesort_pool;
+
+static void filesort_thread_init()
+{
+  my_thread_init();
+}
+
+static void filesort_thread_end()
+{
+  my_thread_end();
+}
+
+bool filesort_threads_init()
+{
+  DBUG_ASSERT(!filesort_pool);
+  /* The sort and merge passes only use the pool with two or more threads */
+  if (filesort_threads <= 1)
+    return false;
+  if (!(filesort_pool= tpool::create_thread_pool_generic(1, filesort_threads)))
+    return true;
+  filesort_pool->set_thread_callbacks(filesort_thread_init,
+                                      filesort_thread_end);
+  return false;
+}
+
+void filesort_threads_end()
+{
+  delete filesort_pool;
+  filesort_pool= NULL;
+}
+
+bool filesort_threads_enabled()
+{
+  return filesort_pool != NULL;
+}
+
+namespace {
+struct Filesort_task
+{
+  void (*func)(void *arg, uint i);
+  void *arg;
+  uint i;
+
+  static void run(void *task)
+  {
+    Filesort_task *t= static_cast<Filesort_task*>(task);
+    t->func(t->arg, t->i);
+  }
+};
+}
+
+void filesort_run_tasks(uint n, void (*func)(void *arg, uint i), void *arg)
+{
+  DBUG_ASSERT(filesort_pool);
+  std::vector<Filesort_task> args(n);
+  std::vector<tpool::waitable_task*> tasks(n);
+
+  for (uint i= 0; i < n; i++)
+  {
+    args[i]= {func, arg, i};
+    tasks[i]= new tpool::waitable_task(Filesort_task::run, &args[i]);
+    filesort_pool->submit_task(tasks[i]);
+  }
+  tpool::tpool_wait_begin();
+  for (uint i= 0; i < n; i++)
+  {
+    tasks[i]->wait();
+    delete tasks[i];
+  }
+  tpool::tpool_wait_end();
+}
+
 namespace {
 /**
   A local helper function. See comments for get_merge_buffers_cost().
@@ -159,6 +235,225 @@ void Filesort_buffer::free_sort_buffer()
 }
 
 
+/** Minimum number of keys for sort_keys_by_prefix() */
+static const uint PREFIX_SORT_MIN_KEYS= 256;
+/** Buckets of fewer keys are sorted by comparison */
+static const uint PREFIX_SORT_MIN_BUCKET= 64;
+
+namespace {
+/** Pointer to a sort key, with the first 8 bytes of the key */
+struct Prefix_key
+{
+  /** first bytes of the key, in big-endian order */
+  ulonglong prefix;
+  uchar *key;
+};
+
+/**
+  MSD radix sort of Prefix_key by the bytes of the prefix, in place
+  (American flag sort). Buckets of fewer than PREFIX_SORT_MIN_BUCKET keys,
+  and keys with equal prefixes, are sorted by comparison, which only
+  reads the key itself when the prefixes are equal.
+*/
+class Prefix_sort
+{
+  /** length of the keys, compared with memcmp() */
+  const size_t length;
+
+  bool less(const Prefix_key &a, const Prefix_key &b) const
+  {
+    if (a.prefix != b.prefix)
+      return a.prefix < b.prefix;
+    return length > 8 && memcmp(a.key + 8, b.key + 8, length - 8) < 0;
+  }
+
+public:
+  explicit Prefix_sort(size_t length_arg) : length(length_arg) {}
+
+  static ulonglong prefix(const uchar *key, size_t length)
+  {
+    ulonglong prefix= 0;
+    for (size_t i= 0; i < MY_MIN(length, 8); i++)
+      prefix|= (ulonglong) key[i] << (56 - 8 * i);
+    return prefix;
+  }
+
+  /**
+    Sort keys that have equal prefix bytes before byte.
+  */
+  void sort(Prefix_key *keys, uint n, uint byte) const
+  {
+    uint count[256], next[256], end[256];
+
+    for (;; byte++)
+    {
+      if (byte >= length)
+        return;                                 // All keys are equal
+      if (n < PREFIX_SORT_MIN_BUCKET || byte == 8)
+      {
+        std::sort(keys, keys + n,
+                  [this](const Prefix_key &a, const Prefix_key &b)
+                  { return less(a, b); });
+        return;
+      }
+
+      const uint shift= 56 - 8 * byte;
+      memset(count, 0, sizeof count);
+      for (uint i= 0; i < n; i++)
+        count[(keys[i].prefix >> shift) & 0xff]++;
+      if (count[(keys[0].prefix >> shift) & 0xff] < n)
+        break;
+    }
+
+    const uint shift= 56 - 8 * byte;
+    for (uint b= 0, pos= 0; b < 256; b++)
+    {
+      next[b]= pos;
+      end[b]= pos+= count[b];
+    }
+    for (uint b= 0; b < 256; b++)
+    {
+      while (next[b] < end[b])
+      {
+        Prefix_key k= keys[next[b]];
+        for (uint kb; (kb= (uint) (k.prefix >> shift) & 0xff) != b; )
+          std::swap(k, keys[next[kb]++]);
+        keys[next[b]++]= k;
+      }
+    }
+    for (uint b= 0; b < 256; b++)
+      if (count[b] > 1)
+        sort(keys + end[b] - count[b], count[b], byte + 1);
+  }
+};
+}
+
+
+/**
+  Sort pointers to keys that are compared with memcmp() of length bytes.
+
+  The first 8 bytes of each key are copied next to its pointer, so that
+  the radix passes and most comparisons do not follow the pointer.
+
+  @return whether memory could not be allocated; the keys are not sorted
+*/
+static bool sort_keys_by_prefix(uchar **keys, uint count, size_t length,
+                                myf flags)
+{
+  Prefix_key *prefix_keys;
+  if (!(prefix_keys= (Prefix_key*) my_malloc(PSI_INSTRUMENT_ME,
+                                             count * sizeof *prefix_keys,
+                                             flags)))
+    return true;
+  for (uint i= 0; i < count; i++)
+  {
+    prefix_keys[i].prefix= Prefix_sort::prefix(keys[i], length);
+    prefix_keys[i].key= keys[i];
+  }
+  Prefix_sort(length).sort(prefix_keys, count, 0);
+  for (uint i= 0; i < count; i++)
+    keys[i]= prefix_keys[i].key;
+  my_free(prefix_keys);
+  return false;
+}
+
+
+/**
+  Minimum number of keys in each part of the sort buffer that a helper
+  thread sorts, see sort_keys_parallel()
+*/
+static const uint PARALLEL_SORT_MIN_KEYS= 16384;
+
+namespace {
+/** Sort of the sort buffer by the filesort helper threads */
+struct Parallel_sort
+{
+  const Sort_param *param;
+  /** the keys to sort, and a buffer of the same size */
+  uchar **keys, **buffer;
+  uint count;
+  /** number of sorted runs; run i starts at key begin(i) */
+  uint runs;
+  /** number of runs that one merge task merges to one run */
+  uint width;
+
+  uint begin(uint i) const
+  {
+    return i >= runs ? count : (uint) ((ulonglong) count * i / runs);
+  }
+
+  /** Sort run i of keys */
+  static void sort_run(void *arg, uint i)
+  {
+    Parallel_sort *s= static_cast<Parallel_sort*>(arg);
+    uchar **keys= s->keys + s->begin(i);
+    const uint n= s->begin(i + 1) - s->begin(i);
+    size_t size= s->param->sort_length;
+
+    if (s->param->using_packed_sortkeys() ||
+        sort_keys_by_prefix(keys, n, size, MYF(0)))
+      my_qsort2(keys, n, sizeof(uchar*), s->param->get_compare_function(),
+                s->param->get_compare_argument(&size));
+  }
+
+  /**
+    Merge the runs i * width .. (i + 1) * width - 1 of keys to buffer.
+    Of equal keys, the one of the earlier run goes first, so that the
+    result does not depend on the order in which the tasks are run.
+  */
+  static void merge_runs(void *arg, uint i)
+  {
+    Parallel_sort *s= static_cast<Parallel_sort*>(arg);
+    const uint mid= s->begin(i * s->width + s->width / 2);
+    uchar **a= s->keys + s->begin(i * s->width), **a_end= s->keys + mid;
+    uchar **b= a_end, **b_end= s->keys + s->begin((i + 1) * s->width);
+    uchar **to= s->buffer + (a - s->keys);
+    size_t size= s->param->sort_length;
+    qsort2_cmp cmp= s->param->get_compare_function();
+    void *cmp_arg= s->param->get_compare_argument(&size);
+
+    while (a < a_end && b < b_end)
+      *to++= cmp(cmp_arg, b, a) < 0 ? *b++ : *a++;
+    memcpy(to, a, (a_end - a) * sizeof *a);
+    to+= a_end - a;
+    memcpy(to, b, (b_end - b) * sizeof *b);
+  }
+};
+}
+
+
+/**
+  Sort the keys by the filesort helper threads: each one sorts a part of
+  the keys, and the sorted parts are merged pairwise, in parallel, until
+  one is left. The order of the result only depends on the keys and on
+  filesort_threads.
+
+  @param buffer  space for count pointers
+*/
+static void sort_keys_parallel(const Sort_param *param, uchar **keys,
+                               uint count, uchar **buffer)
+{
+  Parallel_sort s;
+  s.param= param;
+  s.keys= keys;
+  s.buffer= buffer;
+  s.count= count;
+  s.runs= MY_MIN(filesort_threads, count / PARALLEL_SORT_MIN_KEYS);
+  DBUG_ASSERT(s.runs > 1);
+
+  filesort_run_tasks(s.runs, Parallel_sort::sort_run, &s);
+
+  for (s.width= 2; s.width < 2 * s.runs; s.width*= 2)
+  {
+    filesort_run_tasks((s.runs + s.width - 1) / s.width,
+                       Parallel_sort::merge_runs, &s);
+    std::swap(s.keys, s.buffer);
+  }
+  if (s.keys != keys)
+    memcpy(keys, s.keys, count * sizeof *keys);
+}
+
+
 void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
 {
   size_t size= param->sort_length;
@@ -172,6 +467,21 @@ void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
     reverse_record_pointers();
 
   uchar **buffer= NULL;
+  if (filesort_threads_enabled() && filesort_threads > 1 &&
+      count >= 2 * PARALLEL_SORT_MIN_KEYS &&
+      (buffer= (uchar**) my_malloc(PSI_INSTRUMENT_ME, count*sizeof(char*),
+                                   MYF(MY_THREAD_SPECIFIC))))
+  {
+    sort_keys_parallel(param, m_sort_keys, count, buffer);
+    my_free(buffer);
+    return;
+  }
+
+  if (!param->using_packed_sortkeys() && count >= PREFIX_SORT_MIN_KEYS &&
+      !sort_keys_by_prefix(m_sort_keys, count, param->sort_length,
+                           MYF(MY_THREAD_SPECIFIC)))
+    return;
+
   if (!param->using_packed_sortkeys() &&
       radixsort_is_appliccable(count, param->sort_length) &&
       (buffer= (uchar**) my_malloc(PSI_INSTRUMENT_ME, count*sizeof(char*),
@@ -20,6 +20,27 @@
 #include "sql_array.h"
 
 class Sort_param;
+
+/**
+  Start the helper threads of filesort, if filesort_threads > 1.
+  @retval true on error
+*/
+bool filesort_threads_init();
+/** Stop the helper threads of filesort. */
+void filesort_threads_end();
+/** @return whether filesort may use helper threads */
+bool filesort_threads_enabled();
+/**
+  Run func(arg, i) for i = 0 .. n-1 as tasks of the filesort helper
+  threads, and wait for all of them to complete. At most filesort_threads
+  tasks run at a time, for all sessions together.
+
+  The tasks run without a THD: they must not access current_thd, must not
+  allocate memory with MY_THREAD_SPECIFIC and must not report errors
+  with my_error().
+*/
+void filesort_run_tasks(uint n, void (*func)(void *arg, uint i), void *arg);
+
 /*
   Calculate cost of merge sort
 
@@ -4677,6 +4677,35 @@ int ha_partition::delete_row(const uchar *buf)
     Called from sql_union.cc by st_select_lex_unit::exec().
 */
 
+/**
+  Pass the number of rows expected to be read by a scan to the partitions
+
+  @param rows  Number of rows the optimizer expects a scan of the table
+               to read, 0 if unknown
+
+  @note The rows are assumed to be evenly spread over the used partitions.
+*/
+
+void ha_partition::set_estimation_rows_to_read(ha_rows rows)
+{
+  uint i;
+  uint n_parts= bitmap_bits_set(&m_part_info->read_partitions);
+  DBUG_ENTER("ha_partition::set_estimation_rows_to_read");
+
+  handler::set_estimation_rows_to_read(rows);
+  if (n_parts > 1)
+    rows= rows / n_parts + 1;
+  for (i= bitmap_get_first_set(&m_part_info->read_partitions);
+       i < m_tot_parts;
+       i= bitmap_get_next_set(&m_part_info->read_partitions, i))
+  {
+    if (bitmap_is_set(&m_opened_partitions, i))
+      m_file[i]->set_estimation_rows_to_read(rows);
+  }
+  DBUG_VOID_RETURN;
+}
+
+
 int ha_partition::delete_all_rows()
 {
   int error;
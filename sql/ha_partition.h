@@ -735,6 +735,7 @@ class ha_partition :public handler
   int truncate() override;
   void start_bulk_insert(ha_rows rows, uint flags) override;
   int end_bulk_insert() override;
+  void set_estimation_rows_to_read(ha_rows rows) override;
 private:
   ha_rows guess_bulk_insert_rows();
   void start_part_bulk_insert(THD *thd, uint part_id);
@@ -6609,6 +6609,9 @@ int handler::binlog_log_row(TABLE *table,
       thd->binlog_write_table_maps())
     DBUG_RETURN(HA_ERR_RBR_LOGGING_FAILED);
 
+  thd->binlog_update_writeset(table, row_logging_has_trans,
+                              before_record, after_record);
+
   error= (*log_func)(thd, table, row_logging_has_trans,
                      before_record, after_record);
   DBUG_RETURN(error ? HA_ERR_RBR_LOGGING_FAILED : 0);
@@ -6711,6 +6714,7 @@ int handler::ha_reset()
   pushed_cond= NULL;
   tracker= NULL;
   mark_trx_read_write_done= 0;
+  estimation_rows_to_read= 0;
   /*
     Disable row logging.
   */
@@ -3083,6 +3083,11 @@ class handler :public Sql_alloc
   Table_flags cached_table_flags;       /* Set on init() and open() */
 
   ha_rows estimation_rows_to_insert;
+  /*
+    The number of rows the optimizer expects one scan of the table (or one
+    index lookup) to read, 0 if unknown. See set_estimation_rows_to_read().
+  */
+  ha_rows estimation_rows_to_read;
   handler *lookup_handler;
 public:
   handlerton *ht;                 /* storage engine of this handler */
@@ -3282,7 +3287,7 @@ class handler :public Sql_alloc
 public:
   handler(handlerton *ht_arg, TABLE_SHARE *share_arg)
     :table_share(share_arg), table(0),
-    estimation_rows_to_insert(0),
+    estimation_rows_to_insert(0), estimation_rows_to_read(0),
     lookup_handler(this),
     ht(ht_arg), ref(0), lookup_buffer(NULL), end_range(NULL),
     implicit_emptied(0),
@@ -3443,6 +3448,15 @@ class handler :public Sql_alloc
     DBUG_VOID_RETURN;
   }
   int ha_end_bulk_insert();
+  /*
+    Let the engine know how many rows the optimizer expects to be read by
+    one scan of the table or one index lookup in the current statement.
+    The engine may use it to size its read-ahead buffers.
+  */
+  virtual void set_estimation_rows_to_read(ha_rows rows)
+  {
+    estimation_rows_to_read= rows;
+  }
   int ha_bulk_update_row(const uchar *old_data, const uchar *new_data,
                          ha_rows *dup_key_found);
   int ha_delete_all_rows();
@@ -3525,7 +3539,7 @@ class handler :public Sql_alloc
 
   virtual double key_scan_time(uint index)
   {
-    return keyread_time(index, 1, records());
+    return keyread_time(index, 1, stats.records);
   }
 
   virtual double avg_io_cost()
@@ -3627,6 +3641,10 @@ class handler :public Sql_alloc
   /**
     Number of rows in table. It will only be called if
     (table_flags() & (HA_HAS_RECORDS | HA_STATS_RECORDS_IS_EXACT)) != 0
+
+    This may scan the table, so use stats.records where an estimate
+    is sufficient. HA_POS_ERROR means that the rows could not be
+    counted and must be read by the caller.
   */
   virtual int pre_records() { return 0; }
   virtual ha_rows records() { return stats.records; }
@@ -111,6 +111,7 @@ struct KEY_FIELD;
 struct SARGABLE_PARAM;
 class RANGE_OPT_PARAM;
 class SEL_TREE;
+class Batch_filter;
 class With_sum_func_cache;
 
 enum precedence {
@@ -1777,6 +1778,15 @@ class Item: public Value_source,
                           with one of the partN evaluating to SEL_TREE::ALWAYS.
    */
    virtual SEL_TREE *get_mm_tree(RANGE_OPT_PARAM *param, Item **cond_ptr);
+  /*
+    Compile the condition or some of its conjuncts into kernels of
+    a batch filter (see batch_filter.h).
+    Return true if at least one kernel has been added to the filter.
+  */
+  virtual bool add_to_batch_filter(THD *thd, Batch_filter *filter)
+  {
+    return false;
+  }
   /*
     Checks whether the item is:
     - a simple equality (field=field_item or field=constant_item), or
@@ -558,6 +558,7 @@ class Item_bool_rowready_func2 :public Item_bool_func2_with_rev
     return add_key_fields_optimize_op(join, key_fields, and_level,
                                       usable_tables, sargables, false);
   }
+  bool add_to_batch_filter(THD *thd, Batch_filter *filter);
   Item *build_clone(THD *thd)
   {
     Item_bool_rowready_func2 *clone=
@@ -940,6 +941,7 @@ class Item_func_between :public Item_func_opt_neg
                       uint *and_level, table_map usable_tables,
                       SARGABLE_PARAM **sargables);
   SEL_TREE *get_mm_tree(RANGE_OPT_PARAM *param, Item **cond_ptr);
+  bool add_to_batch_filter(THD *thd, Batch_filter *filter);
   Item* propagate_equal_fields(THD *thd, const Context &ctx, COND_EQUAL *cond)
   {
     Item_args::propagate_equal_fields(thd,
@@ -3368,6 +3370,7 @@ class Item_cond_and final :public Item_cond
   void add_key_fields(JOIN *join, KEY_FIELD **key_fields, uint *and_level,
                       table_map usable_tables, SARGABLE_PARAM **sargables);
   SEL_TREE *get_mm_tree(RANGE_OPT_PARAM *param, Item **cond_ptr);
+  bool add_to_batch_filter(THD *thd, Batch_filter *filter);
   Item *get_copy(THD *thd)
   { return get_item_copy<Item_cond_and>(thd, this); }
 };
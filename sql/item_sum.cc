@@ -803,11 +803,11 @@ bool Aggregator_distinct::setup(THD *thd)
     table->file->extra(HA_EXTRA_NO_ROWS);		// Don't update rows
     table->no_rows=1;
 
-    if (table->s->db_type() == heap_hton)
+    if (table->s->db_type() == heap_hton && !table->s->blob_fields)
     {
       /*
-        No blobs, otherwise it would have been MyISAM: set up a compare
-        function and its arguments to use with Unique.
+        No blobs: set up a compare function and its arguments to use with
+        Unique.
       */
       qsort_cmp2 compare_key;
       void* cmp_arg;
@@ -863,7 +863,7 @@ bool Aggregator_distinct::setup(THD *thd)
       }
       DBUG_ASSERT(tree == 0);
       tree= new Unique(compare_key, cmp_arg, tree_key_length,
-                       item_sum->ram_limitation(thd));
+                       item_sum->ram_limitation(thd), 0, all_binary);
       /*
         The only time tree_key_length could be 0 is if someone does
         count(distinct) on a char(0) field - stupid thing to do,
@@ -872,6 +872,8 @@ bool Aggregator_distinct::setup(THD *thd)
       */
       if (! tree)
         return TRUE;
+      /* Counting doesn't depend on the order of the keys */
+      tree->allow_unordered_walk();
     }
     return FALSE;
   }
@@ -920,9 +922,14 @@ bool Aggregator_distinct::setup(THD *thd)
       are converted to binary representation as well.
     */
     tree= new Unique(simple_raw_key_cmp, &tree_key_length, tree_key_length,
-                     item_sum->ram_limitation(thd));
+                     item_sum->ram_limitation(thd), 0, true);
+    if (!tree)
+      DBUG_RETURN(TRUE);
+    /* Exact sums don't depend on the order of the keys, but doubles do */
+    if (arg->result_type() != REAL_RESULT)
+      tree->allow_unordered_walk();
 
-    DBUG_RETURN(tree == 0);
+    DBUG_RETURN(FALSE);
   }
 }
 
@@ -1002,7 +1009,11 @@ bool Aggregator_distinct::add()
       return tree->unique_add(table->record[0] + table->s->null_bytes);
     }
     if (unlikely((error= table->file->ha_write_tmp_row(table->record[0]))) &&
-        table->file->is_fatal_error(error, HA_CHECK_DUP))
+        table->file->is_fatal_error(error, HA_CHECK_DUP) &&
+        create_internal_tmp_table_from_heap(table->in_use, table,
+                                            tmp_table_param->start_recinfo,
+                                            &tmp_table_param->recinfo,
+                                            error, 1, NULL))
       return TRUE;
     return FALSE;
   }
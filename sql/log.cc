@@ -263,6 +263,12 @@ void make_default_log_name(char **out, const char* log_ext, bool once)
 }
 
 
+static int cmp_writeset_hash(const uint32 *a, const uint32 *b)
+{
+  return *a < *b ? -1 : *a > *b;
+}
+
+
 /*
   Helper classes to store non-transactional and transactional data
   before copying it to the binary log.
@@ -270,7 +276,8 @@ void make_default_log_name(char **out, const char* log_ext, bool once)
 class binlog_cache_data
 {
 public:
-  binlog_cache_data(): m_pending(0), status(0),
+  binlog_cache_data(): writeset(PSI_INSTRUMENT_MEM, 0, 64),
+  writeset_invalid(FALSE), m_pending(0), status(0),
   before_stmt_pos(MY_OFF_T_UNDEF),
   incident(FALSE), changes_to_non_trans_temp_table_flag(FALSE),
   saved_max_binlog_cache_size(0), ptr_binlog_cache_use(0),
@@ -346,6 +353,8 @@ class binlog_cache_data
     status= 0;
     incident= FALSE;
     before_stmt_pos= MY_OFF_T_UNDEF;
+    writeset.clear();
+    writeset_invalid= FALSE;
     DBUG_ASSERT(empty());
   }
 
@@ -411,11 +420,43 @@ class binlog_cache_data
     status|= status_arg;
   }
 
+  bool has_critical_events() const
+  {
+    return status & LOGGED_CRITICAL;
+  }
+
+  /*
+    Sort the writeset and remove duplicates. If it still has more than
+    binlog_writeset_max_keys hashes, it is discarded.
+  */
+  void compact_writeset()
+  {
+    size_t n= 0;
+    writeset.sort(cmp_writeset_hash);
+    for (size_t i= 0; i < writeset.elements(); i++)
+      if (!n || writeset.at(i) != writeset.at(n - 1))
+        writeset.at(n++)= writeset.at(i);
+    writeset.elements(n);
+    if (n > opt_binlog_writeset_max_keys)
+    {
+      writeset.clear();
+      writeset_invalid= TRUE;
+    }
+  }
+
   /*
     Cache to store data before copying it to the binary log.
   */
   IO_CACHE cache_log;
 
+  /*
+    Hashes of the primary and unique keys of the rows that the row events in
+    the cache modify, see THD::binlog_update_writeset(). writeset_invalid is
+    set when some change in the cache is not described by the hashes.
+  */
+  Dynamic_array<uint32> writeset;
+  bool writeset_invalid;
+
 private:
   /*
     Pending binrows event. This event is the event where the rows are currently
@@ -3380,6 +3421,7 @@ MYSQL_BIN_LOG::MYSQL_BIN_LOG(uint *sync_period)
    group_commit_trigger_lock_wait(0),
    sync_period_ptr(sync_period), sync_counter(0),
    state_file_deleted(false), binlog_state_recover_done(false),
+   gtid_index_file(-1), gtid_index_last_pos(0),
    is_relay_log(0), relay_signal_cnt(0),
    checksum_alg_reset(BINLOG_CHECKSUM_ALG_UNDEF),
    relay_log_checksum_alg(BINLOG_CHECKSUM_ALG_UNDEF),
@@ -3450,6 +3492,7 @@ void MYSQL_BIN_LOG::cleanup()
     mysql_mutex_destroy(&LOCK_xid_list);
     mysql_mutex_destroy(&LOCK_binlog_background_thread);
     mysql_mutex_destroy(&LOCK_binlog_end_pos);
+    dump_cache.cleanup();
     mysql_cond_destroy(&COND_relay_log_updated);
     mysql_cond_destroy(&COND_bin_log_updated);
     mysql_cond_destroy(&COND_queue_busy);
@@ -3500,6 +3543,7 @@ void MYSQL_BIN_LOG::init_pthread_objects()
 
   mysql_mutex_init(m_key_LOCK_binlog_end_pos, &LOCK_binlog_end_pos,
                    MY_MUTEX_INIT_SLOW);
+  dump_cache.init_pthread_objects();
 }
 
 
@@ -3694,6 +3738,11 @@ bool MYSQL_BIN_LOG::open(const char *log_name,
       write_file_name_to_index_file= 1;
     }
 
+#ifdef HAVE_REPLICATION
+    if (!is_relay_log && !dump_cache.alloc(opt_binlog_dump_cache_size))
+      dump_cache.reset(log_file_name, my_b_tell(&log_file));
+#endif
+
     {
       /*
         In 4.x we put Start event only in the first binlog. But from 5.0 we
@@ -3873,7 +3922,7 @@ bool MYSQL_BIN_LOG::open(const char *log_name,
         goto err;
       bytes_written+= description_event_for_queue->data_written;
     }
-    if (flush_io_cache(&log_file) ||
+    if (flush_log_file() ||
         mysql_file_sync(log_file.file, MYF(MY_WME|MY_SYNC_FILESIZE)))
       goto err;
 
@@ -4371,6 +4420,12 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
 
   for (;;)
   {
+    if (!is_relay_log)
+    {
+      char gtid_index_name[FN_REFLEN];
+      binlog_gtid_index_name(gtid_index_name, linfo.log_file_name);
+      my_delete(gtid_index_name, MYF(0));
+    }
     if (unlikely((error= my_delete(linfo.log_file_name, MYF(0)))))
     {
       if (my_errno == ENOENT) 
@@ -4986,6 +5041,12 @@ int MYSQL_BIN_LOG::purge_index_entry(THD *thd, ulonglong *reclaimed_space,
         error= 0;
 
         DBUG_PRINT("info",("purging %s",log_info.log_file_name));
+        if (!is_relay_log)
+        {
+          char gtid_index_name[FN_REFLEN];
+          binlog_gtid_index_name(gtid_index_name, log_info.log_file_name);
+          my_delete(gtid_index_name, MYF(0));
+        }
         if (!my_delete(log_info.log_file_name, MYF(0)))
         {
           if (reclaimed_space)
@@ -5338,7 +5399,7 @@ int MYSQL_BIN_LOG::new_file_impl()
     log rotation should give the waiting thread a signal to
     discover EOF and move on to the next log.
   */
-  if (unlikely((error= flush_io_cache(&log_file))))
+  if (unlikely((error= flush_log_file())))
   {
     close_on_error= TRUE;
     goto end;
@@ -5547,13 +5608,26 @@ bool MYSQL_BIN_LOG::write_event_buffer(uchar* buf, uint len)
   DBUG_RETURN(error);
 }
 
+/*
+  Flush the binlog file, after copying what is written to dump_cache.
+  Bytes that my_b_write() already wrote to the file when the buffer of
+  log_file was full are not copied; the cache then restarts at the
+  next flush.
+*/
+int MYSQL_BIN_LOG::flush_log_file()
+{
+  dump_cache.append(log_file.pos_in_file, log_file.write_buffer,
+                    (size_t) (log_file.write_pos - log_file.write_buffer));
+  return flush_io_cache(&log_file);
+}
+
 bool MYSQL_BIN_LOG::flush_and_sync(bool *synced)
 {
   int err=0, fd=log_file.file;
   if (synced)
     *synced= 0;
   mysql_mutex_assert_owner(&LOCK_log);
-  if (flush_io_cache(&log_file))
+  if (flush_log_file())
     return 1;
   uint sync_period= get_sync_period();
   if (sync_period && ++sync_counter >= sync_period)
@@ -6065,6 +6139,156 @@ bool THD::binlog_write_table_map(TABLE *table, bool with_annotate)
 }
 
 
+/**
+  Compute the hash of a primary or unique key of a row for the writeset.
+
+  @param table    table of the row
+  @param key      key of the table
+  @param record   row, in the format of table->record[0]
+  @param hash     the hash of the table name and of the key value
+
+  @retval false   ok
+  @retval true    a key part is NULL, so the key cannot conflict
+*/
+
+static bool writeset_key_hash(TABLE *table, const KEY *key,
+                              const uchar *record, uint32 *hash)
+{
+  ulong nr1= 1, nr2= 4;
+  uchar keynr= (uchar) (key - table->key_info);
+  my_ptrdiff_t diff= record - table->record[0];
+
+  my_charset_bin.hash_sort((const uchar*) table->s->table_cache_key.str,
+                           table->s->table_cache_key.length, &nr1, &nr2);
+  my_charset_bin.hash_sort(&keynr, 1, &nr1, &nr2);
+  for (uint i= 0; i < key->user_defined_key_parts; i++)
+  {
+    Field *field= key->key_part[i].field;
+    if (field->is_real_null(diff))
+      return true;
+    field->move_field_offset(diff);
+    field->hash(&nr1, &nr2);
+    field->move_field_offset(-diff);
+  }
+  *hash= (uint32) nr1;
+  return false;
+}
+
+
+/**
+  Add the primary and unique keys of a row that is logged in row format to
+  the writeset of the transaction. The writeset is logged in the GTID event
+  of the transaction, see Gtid_log_event::FL_EXTRA_WRITESET.
+
+  The row images only have the values of the columns in read_set (and
+  write_set for the after image). If the value of a unique key is not known
+  for an update or a delete, the writeset is invalidated: a later
+  transaction that reuses the value that the row had would otherwise look
+  independent of this one.
+
+  This is called for every row, also when binlog_writeset_max_keys is 0,
+  see handler::binlog_log_row().
+
+  @param table          table of the row
+  @param is_transactional  whether the table is transactional
+  @param before_record  row before the change, or NULL for an insert
+  @param after_record   row after the change, or NULL for a delete
+*/
+
+void THD::binlog_update_writeset(TABLE *table, bool is_transactional,
+                                 const uchar *before_record,
+                                 const uchar *after_record)
+{
+  DBUG_ENTER("THD::binlog_update_writeset");
+  binlog_cache_mngr *const cache_mngr=
+    (binlog_cache_mngr*) thd_get_ha_data(this, binlog_hton);
+
+  if (!cache_mngr)
+    DBUG_VOID_RETURN;
+
+  /* Changes that go to the statement cache are logged in their own GTID. */
+  if (!(variables.option_bits & OPTION_GTID_BEGIN) &&
+      !use_trans_cache(this, is_transactional))
+    DBUG_VOID_RETURN;
+
+  binlog_cache_data *cache_data= &cache_mngr->trx_cache;
+  if (cache_data->writeset_invalid)
+    DBUG_VOID_RETURN;
+
+  /*
+    binlog_writeset_max_keys may be changed while the transaction runs. A
+    row that is logged while it is 0 is not in the writeset, so a writeset
+    collected after it is set again would not describe all the changes.
+  */
+  if (!opt_binlog_writeset_max_keys)
+    goto invalid;
+
+  /*
+    Non-transactional changes cannot be rolled back and retried by a
+    parallel slave, and foreign keys make rows of other tables depend on
+    the row.
+  */
+  if (!is_transactional || table->s->primary_key == MAX_KEY ||
+      table->file->referenced_by_foreign_key())
+    goto invalid;
+  if (!table->writeset_fk_known)
+  {
+    table->writeset_fk= !table->file->can_switch_engines();
+    table->writeset_fk_known= true;
+  }
+  if (table->writeset_fk)
+    goto invalid;
+
+  for (uint keynr= 0; keynr < table->s->keys; keynr++)
+  {
+    const KEY *key= table->key_info + keynr;
+    bool all_read= true, any_written= false;
+    uint32 hash;
+
+    if (!(key->flags & HA_NOSAME))
+      continue;
+    if (key->algorithm == HA_KEY_ALG_LONG_HASH)
+      goto invalid;
+    for (uint i= 0; i < key->user_defined_key_parts; i++)
+    {
+      const KEY_PART_INFO *key_part= key->key_part + i;
+      if (key_part->key_part_flag & HA_PART_KEY_SEG)
+        goto invalid;
+      all_read&= bitmap_is_set(table->read_set, key_part->fieldnr - 1);
+      any_written|= bitmap_is_set(table->write_set, key_part->fieldnr - 1);
+    }
+
+    if (!before_record)
+    {
+      /* An insert has the values of all columns. */
+      if (!writeset_key_hash(table, key, after_record, &hash) &&
+          cache_data->writeset.append(hash))
+        goto invalid;
+      continue;
+    }
+
+    if (!all_read)
+      goto invalid;
+    if (!writeset_key_hash(table, key, before_record, &hash) &&
+        cache_data->writeset.append(hash))
+      goto invalid;
+    if (after_record && any_written &&
+        !writeset_key_hash(table, key, after_record, &hash) &&
+        cache_data->writeset.append(hash))
+      goto invalid;
+  }
+
+  if (cache_data->writeset.elements() > 2 * opt_binlog_writeset_max_keys)
+    cache_data->compact_writeset();
+  DBUG_VOID_RETURN;
+
+invalid:
+  cache_data->writeset.clear();
+  cache_data->writeset_invalid= TRUE;
+  DBUG_VOID_RETURN;
+}
+
+
 /**
   This function retrieves a pending row event from a cache which is
   specified through the parameter @c is_transactional. Respectively, when it
@@ -6217,7 +6441,8 @@ MYSQL_BIN_LOG::flush_and_set_pending_rows_event(THD *thd,
 
 bool
 MYSQL_BIN_LOG::write_gtid_event(THD *thd, bool standalone,
-                                bool is_transactional, uint64 commit_id)
+                                bool is_transactional, uint64 commit_id,
+                                const Dynamic_array<uint32> *writeset)
 {
   rpl_gtid gtid;
   uint32 domain_id;
@@ -6272,6 +6497,20 @@ MYSQL_BIN_LOG::write_gtid_event(THD *thd, bool standalone,
                             LOG_EVENT_SUPPRESS_USE_F, is_transactional,
                             commit_id);
 
+  /*
+    The writeset lets a slave run the event group in parallel with others,
+    so it is only logged for event groups that can be rolled back and
+    retried.
+  */
+  if (writeset &&
+      (gtid_event.flags2 &
+       (Gtid_log_event::FL_TRANSACTIONAL | Gtid_log_event::FL_DDL |
+        Gtid_log_event::FL_PREPARED_XA | Gtid_log_event::FL_COMPLETED_XA)) ==
+      Gtid_log_event::FL_TRANSACTIONAL &&
+      gtid_event.set_writeset(writeset->front(),
+                              (uint32) writeset->elements()))
+    DBUG_RETURN(true);
+
   /* Write the event to the binary log. */
   DBUG_ASSERT(this == &mysql_bin_log);
 
@@ -6336,6 +6575,210 @@ MYSQL_BIN_LOG::write_state_to_file()
 }
 
 
+void binlog_gtid_index_name(char *buf, const char *log_name)
+{
+  strxnmov(buf, FN_REFLEN - 1, log_name, BINLOG_GTID_INDEX_EXT, NullS);
+}
+
+
+void Binlog_dump_cache::init_pthread_objects()
+{
+  mysql_rwlock_init(key_rwlock_BINLOG_dump_cache, &lock);
+}
+
+
+void Binlog_dump_cache::cleanup()
+{
+  mysql_rwlock_destroy(&lock);
+  my_free(buf);
+  buf= 0;
+  size= 0;
+}
+
+
+/*
+  Allocate the buffer of the cache, unless it is already allocated.
+
+  @return true if the cache cannot be used
+*/
+bool Binlog_dump_cache::alloc(size_t size_arg)
+{
+  if (buf)
+    return false;
+  if (!size_arg ||
+      !(buf= (uchar*) my_malloc(PSI_INSTRUMENT_ME, size_arg, MYF(MY_WME))))
+    return true;
+  size= size_arg;
+  return false;
+}
+
+
+/*
+  Start caching a binlog file at the given offset.
+  Called under LOCK_log when a new binlog file is opened.
+*/
+void Binlog_dump_cache::reset(const char *log_name, my_off_t pos)
+{
+  if (!enabled())
+    return;
+  mysql_rwlock_wrlock(&lock);
+  strmake_buf(file_name, log_name);
+  start= end= pos;
+  mysql_rwlock_unlock(&lock);
+}
+
+
+/*
+  Copy bytes that were written to the active binlog file at offset pos.
+  Called under LOCK_log.
+*/
+void Binlog_dump_cache::append(my_off_t pos, const uchar *data, size_t len)
+{
+  if (!enabled() || !len)
+    return;
+  mysql_rwlock_wrlock(&lock);
+  if (pos != end)
+    start= pos;
+  end= pos + len;
+  if (len > size)
+  {
+    data+= len - size;
+    len= size;
+  }
+  size_t offs= (size_t) ((end - len) % size);
+  size_t part= MY_MIN(len, size - offs);
+  memcpy(buf + offs, data, part);
+  memcpy(buf, data + part, len - part);
+  if (end - start > size)
+    start= end - size;
+  mysql_rwlock_unlock(&lock);
+}
+
+
+/*
+  Copy len bytes at offset pos of the binlog file log_name.
+
+  @return false if the whole range was copied,
+          true if it is not in the cache
+*/
+bool Binlog_dump_cache::read(const char *log_name, my_off_t pos, uchar *to,
+                             size_t len)
+{
+  bool res= true;
+  if (!enabled())
+    return res;
+  mysql_rwlock_rdlock(&lock);
+  if (pos >= start && pos + len <= end && !strcmp(log_name, file_name))
+  {
+    size_t offs= (size_t) (pos % size);
+    size_t part= MY_MIN(len, size - offs);
+    memcpy(to, buf + offs, part);
+    memcpy(to + part, buf, len - part);
+    res= false;
+  }
+  mysql_rwlock_unlock(&lock);
+  return res;
+}
+
+
+/*
+  Add an entry with the current binlog state to the GTID index of the
+  binlog file, if at least binlog_gtid_index_span bytes were written since
+  the previous entry.
+
+  Called with LOCK_log held when the binlog has been flushed up to pos,
+  which is the end of an event group, so rpl_global_gtid_binlog_state
+  contains exactly the GTIDs logged before pos.
+
+  The index is only an optimisation, so errors are just logged, and the
+  index of the current binlog file is not written any more after an error.
+*/
+void
+MYSQL_BIN_LOG::write_gtid_index_entry(my_off_t pos)
+{
+  uchar *buf;
+  rpl_gtid *list;
+  uint32 count, i;
+  size_t length;
+  DBUG_ENTER("MYSQL_BIN_LOG::write_gtid_index_entry");
+  mysql_mutex_assert_owner(&LOCK_log);
+
+  if (is_relay_log || !opt_binlog_gtid_index_span ||
+      pos < gtid_index_last_pos + opt_binlog_gtid_index_span)
+    DBUG_VOID_RETURN;
+  gtid_index_last_pos= pos;
+
+  if (gtid_index_file < 0)
+  {
+    char name[FN_REFLEN];
+    if (gtid_index_file == -2)
+      DBUG_VOID_RETURN;                         // Failed earlier
+    binlog_gtid_index_name(name, log_file_name);
+    if ((gtid_index_file= mysql_file_open(key_file_binlog_state, name,
+                                          O_WRONLY|O_CREAT|O_TRUNC|O_BINARY,
+                                          MYF(MY_WME))) < 0 ||
+        mysql_file_write(gtid_index_file,
+                         (const uchar*) BINLOG_GTID_INDEX_MAGIC,
+                         BINLOG_GTID_INDEX_MAGIC_LEN, MYF(MY_WME|MY_NABP)))
+      goto err;
+  }
+
+  count= rpl_global_gtid_binlog_state.count();
+  length= BINLOG_GTID_INDEX_HEADER_LEN + count * BINLOG_GTID_INDEX_GTID_LEN +
+          BINLOG_GTID_INDEX_CHECKSUM_LEN;
+  if (!(buf= (uchar*) my_malloc(PSI_INSTRUMENT_ME, length +
+                                count * sizeof(rpl_gtid), MYF(MY_WME))))
+    goto err;
+  list= (rpl_gtid*) (buf + length);
+  if (rpl_global_gtid_binlog_state.get_gtid_list(list, count))
+  {
+    /* The state changed meanwhile; try again at the next flush. */
+    my_free(buf);
+    gtid_index_last_pos= 0;
+    DBUG_VOID_RETURN;
+  }
+
+  int4store(buf, (uint32) length);
+  int8store(buf + 4, (ulonglong) pos);
+  int4store(buf + 12, count);
+  for (i= 0; i < count; ++i)
+  {
+    uchar *p= buf + BINLOG_GTID_INDEX_HEADER_LEN + i * BINLOG_GTID_INDEX_GTID_LEN;
+    int4store(p, list[i].domain_id);
+    int4store(p + 4, list[i].server_id);
+    int8store(p + 8, list[i].seq_no);
+  }
+  int4store(buf + length - BINLOG_GTID_INDEX_CHECKSUM_LEN,
+            my_checksum(0, buf, length - BINLOG_GTID_INDEX_CHECKSUM_LEN));
+  if (mysql_file_write(gtid_index_file, buf, length, MYF(MY_WME|MY_NABP)))
+  {
+    my_free(buf);
+    goto err;
+  }
+  my_free(buf);
+  DBUG_VOID_RETURN;
+
+err:
+  sql_print_warning("Failed to write GTID index of binlog file '%s'; "
+                    "slaves connecting with GTID will read it from the "
+                    "start", log_file_name);
+  if (gtid_index_file >= 0)
+    mysql_file_close(gtid_index_file, MYF(0));
+  gtid_index_file= -2;
+  DBUG_VOID_RETURN;
+}
+
+
+void
+MYSQL_BIN_LOG::close_gtid_index()
+{
+  if (gtid_index_file >= 0)
+    mysql_file_close(gtid_index_file, MYF(0));
+  gtid_index_file= -1;
+  gtid_index_last_pos= 0;
+}
+
+
 /*
   Initialize the binlog state from the master-bin.state file, at server startup.
 
@@ -8404,6 +8847,28 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
 }
 
 
+/*
+  Get the writeset to log in the GTID event of a transaction that is
+  written from the transactional cache, or NULL if the transaction has
+  changes that the writeset does not describe.
+*/
+
+static const Dynamic_array<uint32> *
+binlog_get_writeset(binlog_cache_mngr *mngr, bool using_stmt_cache)
+{
+  binlog_cache_data *cache_data= &mngr->trx_cache;
+
+  if (!opt_binlog_writeset_max_keys || cache_data->writeset_invalid ||
+      (using_stmt_cache && !mngr->stmt_cache.empty()) ||
+      cache_data->has_critical_events())
+    return NULL;
+  cache_data->compact_writeset();
+  if (!cache_data->writeset.elements())
+    return NULL;
+  return &cache_data->writeset;
+}
+
+
 int
 MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
                                          uint64 commit_id)
@@ -8412,7 +8877,10 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
   DBUG_ENTER("MYSQL_BIN_LOG::write_transaction_or_stmt");
 
   if (write_gtid_event(entry->thd, is_prepared_xa(entry->thd),
-                       entry->using_trx_cache, commit_id))
+                       entry->using_trx_cache, commit_id,
+                       entry->using_trx_cache && !entry->incident_event ?
+                       binlog_get_writeset(mngr, entry->using_stmt_cache) :
+                       NULL))
     DBUG_RETURN(ER_ERROR_ON_WRITE);
 
   if (entry->using_stmt_cache && !mngr->stmt_cache.empty() &&
@@ -8710,7 +9178,7 @@ void MYSQL_BIN_LOG::close(uint exiting)
                   relay_log_checksum_alg != BINLOG_CHECKSUM_ALG_UNDEF);
       write_event(&s);
       bytes_written+= s.data_written;
-      flush_io_cache(&log_file);
+      flush_log_file();
       update_binlog_end_pos();
 
       /*
@@ -8753,6 +9221,7 @@ void MYSQL_BIN_LOG::close(uint exiting)
 
     /* this will cleanup IO_CACHE, sync and close the file */
     MYSQL_LOG::close(exiting);
+    close_gtid_index();
   }
 
   /*
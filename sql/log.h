@@ -300,6 +300,64 @@ enum enum_log_state { LOG_OPENED, LOG_CLOSED, LOG_TO_BE_OPENED };
 */
 #define LOG_BIN_IO_SIZE MY_ALIGN_DOWN(65536-1, IO_SIZE)
 
+/*
+  Sparse GTID index of a binlog file, written alongside it with the name
+  of the binlog file and BINLOG_GTID_INDEX_EXT appended.
+
+  The file starts with BINLOG_GTID_INDEX_MAGIC, followed by entries that
+  record the binlog GTID state at event group boundaries of the binlog file:
+
+    4 bytes  Length of the entry, including this field and the checksum
+    8 bytes  Offset in the binlog file
+    4 bytes  Number N of GTIDs in the binlog state
+    N * 16   domain_id (4 bytes), server_id (4 bytes) and seq_no (8 bytes)
+             of each GTID, in the order of Gtid_list_log_event
+    4 bytes  CRC32 of the preceding bytes of the entry
+
+  A dump thread of a slave connecting with GTID uses the index to start
+  reading the binlog file at the last entry that the slave already has.
+*/
+#define BINLOG_GTID_INDEX_EXT ".gtidx"
+#define BINLOG_GTID_INDEX_MAGIC "\xfeGIX"
+#define BINLOG_GTID_INDEX_MAGIC_LEN 4
+#define BINLOG_GTID_INDEX_HEADER_LEN 16
+#define BINLOG_GTID_INDEX_GTID_LEN 16
+#define BINLOG_GTID_INDEX_CHECKSUM_LEN 4
+
+void binlog_gtid_index_name(char *buf, const char *log_name);
+
+/*
+  In-memory copy of the last bytes written to the active binlog file,
+  shared by the binlog dump threads.
+
+  The writer appends every byte that goes to the binlog file under LOCK_log,
+  so the cache always holds a contiguous range [start, end) of the file;
+  a write that does not continue at the end, or a new binlog file, restarts
+  the range. Dump threads that are caught up with the end of the binlog copy
+  the events from here instead of reading the file each on its own, and
+  read the file when what they need is no longer (or not yet) in the cache.
+*/
+class Binlog_dump_cache
+{
+public:
+  Binlog_dump_cache() : buf(0), size(0), start(0), end(0) { file_name[0]= 0; }
+  void init_pthread_objects();
+  void cleanup();
+  bool alloc(size_t size_arg);
+  bool enabled() const { return size != 0; }
+  void reset(const char *log_name, my_off_t pos);
+  void append(my_off_t pos, const uchar *data, size_t len);
+  bool read(const char *log_name, my_off_t pos, uchar *to, size_t len);
+
+private:
+  mysql_rwlock_t lock;
+  uchar *buf;
+  size_t size;
+  /* Range of the binlog file that is in buf, at buf[offset % size] */
+  my_off_t start, end;
+  char file_name[FN_REFLEN];
+};
+
 /*
   TODO use mmap instead of IO_CACHE for binlog
   (mmap+fsync is two times faster than write+fsync)
@@ -553,6 +611,10 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   uint sync_counter;
   bool state_file_deleted;
   bool binlog_state_recover_done;
+  /* GTID index of the current binlog file, or -1 if not created yet */
+  File gtid_index_file;
+  /* Binlog offset of the last entry written to the GTID index */
+  my_off_t gtid_index_last_pos;
 
   inline uint get_sync_period()
   {
@@ -674,6 +736,8 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   char last_commit_pos_file[FN_REFLEN];
   my_off_t last_commit_pos_offset;
   ulong current_binlog_id;
+  /* Tail of the active binlog file, for the binlog dump threads */
+  Binlog_dump_cache dump_cache;
 
   MYSQL_BIN_LOG(uint *sync_period);
   /*
@@ -786,6 +850,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
     binlog_end_pos= pos;
     signal_bin_log_update();
     unlock_binlog_end_pos();
+    write_gtid_index_entry(pos);
   }
 
   void wait_for_sufficient_commits();
@@ -853,6 +918,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
      @retval other Failure
   */
   bool flush_and_sync(bool *synced);
+  int flush_log_file();
   int purge_logs(const char *to_log, bool included,
                  bool need_mutex, bool need_update_threads,
                  ulonglong *decrease_log_space);
@@ -896,9 +962,12 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   void set_status_variables(THD *thd);
   bool is_xidlist_idle();
   bool write_gtid_event(THD *thd, bool standalone, bool is_transactional,
-                        uint64 commit_id);
+                        uint64 commit_id,
+                        const Dynamic_array<uint32> *writeset= NULL);
   int read_state_from_file();
   int write_state_to_file();
+  void write_gtid_index_entry(my_off_t pos);
+  void close_gtid_index();
   int get_most_recent_gtid_list(rpl_gtid **list, uint32 *size);
   bool append_state_pos(String *str);
   bool append_state(String *str);
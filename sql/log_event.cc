@@ -2567,8 +2567,10 @@ Binlog_checkpoint_log_event::Binlog_checkpoint_log_event(
 
 Gtid_log_event::Gtid_log_event(const char *buf, uint event_len,
                const Format_description_log_event *description_event)
-  : Log_event(buf, description_event), seq_no(0), commit_id(0)
+  : Log_event(buf, description_event), seq_no(0), commit_id(0),
+    flags_extra(0), writeset(0), writeset_count(0)
 {
+  const char *buf_0= buf;
   uint8 header_size= description_event->common_header_len;
   uint8 post_header_len= description_event->post_header_len[GTID_EVENT-1];
   if (event_len < (uint) header_size + (uint) post_header_len ||
@@ -2604,6 +2606,42 @@ Gtid_log_event::Gtid_log_event(const char *buf, uint event_len,
     memcpy(xid.data, buf, data_length);
     buf+= data_length;
   }
+
+  /*
+    The optional fields that follow were not written by older masters,
+    which pad the event with zeros instead.
+  */
+  if (static_cast<uint>(buf - buf_0) < event_len)
+  {
+    flags_extra= *(buf++);
+    /*
+      The layout of the fields that other flags_extra bits announce is not
+      known here, so the writeset is not read if any of them is set.
+    */
+    if (flags_extra == FL_EXTRA_WRITESET)
+    {
+      uint32 count;
+      if (static_cast<uint>(buf - buf_0) + 2 > event_len ||
+          static_cast<uint>(buf - buf_0) + 2 +
+          (count= uint2korr(buf)) * 4 > event_len)
+      {
+        seq_no= 0;                              // So is_valid() returns false
+        return;
+      }
+      buf+= 2;
+      if (count &&
+          !(writeset= (uint32 *) my_malloc(PSI_INSTRUMENT_ME,
+                                           count * sizeof(*writeset),
+                                           MYF(MY_WME))))
+      {
+        seq_no= 0;
+        return;
+      }
+      for (uint32 i= 0; i < count; i++, buf+= 4)
+        writeset[i]= uint4korr(buf);
+      writeset_count= count;
+    }
+  }
 }
 
 
@@ -3568,10 +3568,33 @@ class Binlog_checkpoint_log_event: public Log_event
         group commit). OR commit id, same for all GTIDs in the same group
         commit (see flags bit 1).</td>
   </tr>
+
+  <tr>
+    <td>XID (optional, see flags bits 6 and 7)</td>
+    <td>6 bytes + length of the XID data</td>
+    <td>Format id, gtrid length, bqual length and the data of the XID of
+        an XA transaction.</td>
+  </tr>
+
+  <tr>
+    <td>flags_extra (optional)</td>
+    <td>1 byte bitfield</td>
+    <td>Bit 7 set indicates that a writeset follows. The other bits are
+        reserved for the optional fields of later versions.</td>
+  </tr>
+
+  <tr>
+    <td>writeset (optional, see flags_extra bit 7)</td>
+    <td>2 byte unsigned integer + 4 bytes per hash</td>
+    <td>Number of hashes, followed by the sorted hashes of the primary and
+        unique keys of the rows modified by the event group.</td>
+  </tr>
   </table>
 
-  The Body of Gtid_log_event is empty. The total event size is 19 bytes +
-  the normal 19 bytes common-header.
+  The Body of Gtid_log_event is empty. Without the optional fields, the
+  total event size is 19 bytes + the normal 19 bytes common-header. Readers
+  that do not know of an optional field ignore it, as they stop reading
+  before the end of the event.
 */
 
 class Gtid_log_event: public Log_event
@@ -3586,6 +3609,13 @@ class Gtid_log_event: public Log_event
   event_mysql_xid_t xid;
 #endif
   uchar flags2;
+  uchar flags_extra;
+  /*
+    Hashes of the primary and unique keys of the rows modified by the event
+    group, sorted and without duplicates, see FL_EXTRA_WRITESET.
+  */
+  uint32 *writeset;
+  uint32 writeset_count;
   /* Flags2. */
 
   /* FL_STANDALONE is set when there is no terminating COMMIT event. */
@@ -3617,9 +3647,26 @@ class Gtid_log_event: public Log_event
   /* FL_"COMMITTED or ROLLED-BACK"_XA is set for XA transaction. */
   static const uchar FL_COMPLETED_XA= 128;
 
+  /* Flags_extra. */
+
+  /*
+    FL_EXTRA_WRITESET is set when the event has the writeset of a row-based
+    transaction. A slave in conservative parallel mode can run event groups
+    with disjoint writesets in parallel, even if they did not group commit
+    together on the master.
+
+    The low bits of flags_extra are used by later versions for optional
+    fields of their own, which they read in the order of the bits. The
+    writeset uses the highest bit, which those versions ignore, and it is
+    only read when no other bit is set, so that the fields of another
+    version are never taken for a writeset.
+  */
+  static const uchar FL_EXTRA_WRITESET= 128;
+
 #ifdef MYSQL_SERVER
   Gtid_log_event(THD *thd_arg, uint64 seq_no, uint32 domain_id, bool standalone,
                  uint16 flags, bool is_transactional, uint64 commit_id);
+  bool set_writeset(const uint32 *hashes, uint32 count);
 #ifdef HAVE_REPLICATION
   void pack_info(Protocol *protocol);
   virtual int do_apply_event(rpl_group_info *rgi);
@@ -3631,7 +3678,7 @@ class Gtid_log_event: public Log_event
 #endif
   Gtid_log_event(const char *buf, uint event_len,
                  const Format_description_log_event *description_event);
-  ~Gtid_log_event() { }
+  ~Gtid_log_event() { my_free(writeset); }
   Log_event_type get_type_code() { return GTID_EVENT; }
   enum_logged_status logged_status() { return LOGGED_NO_DATA; }
   int get_data_size()
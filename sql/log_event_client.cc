@@ -3838,6 +3838,9 @@ Gtid_log_event::print(FILE *file, PRINT_EVENT_INFO *print_event_info)
     if (flags2 & FL_WAITED)
       if (my_b_write_string(&cache, " waited"))
         goto err;
+    if (writeset_count)
+      if (my_b_printf(&cache, " ws=%u", writeset_count))
+        goto err;
     if (my_b_printf(&cache, "\n"))
       goto err;
 
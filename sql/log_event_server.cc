@@ -3253,7 +3253,8 @@ Gtid_log_event::Gtid_log_event(THD *thd_arg, uint64 seq_no_arg,
                                uint64 commit_id_arg)
   : Log_event(thd_arg, flags_arg, is_transactional),
     seq_no(seq_no_arg), commit_id(commit_id_arg), domain_id(domain_id_arg),
-    flags2((standalone ? FL_STANDALONE : 0) | (commit_id_arg ? FL_GROUP_COMMIT_ID : 0))
+    flags2((standalone ? FL_STANDALONE : 0) | (commit_id_arg ? FL_GROUP_COMMIT_ID : 0)),
+    flags_extra(0), writeset(0), writeset_count(0)
 {
   cache_type= Log_event::EVENT_NO_CACHE;
   bool is_tmp_table= thd_arg->lex->stmt_accessed_temp_table();
@@ -3287,6 +3288,32 @@ Gtid_log_event::Gtid_log_event(THD *thd_arg, uint64 seq_no_arg,
 }
 
 
+/**
+  Attach the writeset of the event group to the event.
+
+  @param hashes  hashes of the modified keys, sorted and without duplicates
+  @param count   number of hashes, at most UINT_MAX16
+
+  @retval false  ok
+  @retval true   out of memory
+*/
+
+bool
+Gtid_log_event::set_writeset(const uint32 *hashes, uint32 count)
+{
+  DBUG_ASSERT(count && count <= UINT_MAX16);
+  DBUG_ASSERT(!writeset);
+  if (!(writeset= (uint32 *) my_malloc(PSI_INSTRUMENT_ME,
+                                       count * sizeof(*writeset),
+                                       MYF(MY_WME))))
+    return true;
+  memcpy(writeset, hashes, count * sizeof(*writeset));
+  writeset_count= count;
+  flags_extra|= FL_EXTRA_WRITESET;
+  return false;
+}
+
+
 /*
   Used to record GTID while sending binlog to slave, without having to
   fully contruct every Gtid_log_event() needlessly.
@@ -3326,7 +3353,7 @@ Gtid_log_event::peek(const char *event_start, size_t event_len,
 bool
 Gtid_log_event::write()
 {
-  uchar buf[GTID_HEADER_LEN+2+sizeof(XID)];
+  uchar buf[GTID_HEADER_LEN+2+sizeof(XID)+1+2];
   size_t write_len;
 
   int8store(buf, seq_no);
@@ -3351,14 +3378,37 @@ Gtid_log_event::write()
     write_len+= data_length;
   }
 
-  if (write_len < GTID_HEADER_LEN)
+  if (flags_extra)
+  {
+    buf[write_len++]= flags_extra;
+    if (flags_extra & FL_EXTRA_WRITESET)
+    {
+      int2store(buf + write_len, writeset_count);
+      write_len+= 2;
+    }
+  }
+
+  size_t writeset_len= writeset_count * 4;
+  /* A writeset makes the event long enough without any padding. */
+  DBUG_ASSERT(!writeset_len || write_len + writeset_len >= GTID_HEADER_LEN);
+  if (write_len + writeset_len < GTID_HEADER_LEN)
   {
     bzero(buf+write_len, GTID_HEADER_LEN-write_len);
     write_len= GTID_HEADER_LEN;
   }
-  return write_header(write_len) ||
-         write_data(buf, write_len) ||
-         write_footer();
+  if (write_header(write_len + writeset_len) ||
+      write_data(buf, write_len))
+    return true;
+  for (uint32 i= 0; i < writeset_count; )
+  {
+    uchar hashes[4 * 64];
+    size_t len= 0;
+    for (; i < writeset_count && len < sizeof(hashes); i++, len+= 4)
+      int4store(hashes + len, writeset[i]);
+    if (write_data(hashes, len))
+      return true;
+  }
+  return write_footer();
 }
 
 
@@ -3396,7 +3446,7 @@ Gtid_log_event::make_compatible_event(String *packet, bool *need_dummy_event,
 void
 Gtid_log_event::pack_info(Protocol *protocol)
 {
-  char buf[6+5+10+1+10+1+20+1+4+20+1+ ser_buf_size+5 /* sprintf */];
+  char buf[6+5+10+1+10+1+20+1+4+20+1+4+10+ ser_buf_size+5 /* sprintf */];
   char *p;
   p = strmov(buf, (flags2 & FL_STANDALONE  ? "GTID " :
                    flags2 & FL_PREPARED_XA ? "XA START " : "BEGIN GTID "));
@@ -3414,6 +3464,11 @@ Gtid_log_event::pack_info(Protocol *protocol)
     p= strmov(p, " cid=");
     p= longlong10_to_str(commit_id, p, 10);
   }
+  if (writeset_count)
+  {
+    p= strmov(p, " ws=");
+    p= longlong10_to_str(writeset_count, p, 10);
+  }
 
   protocol->store(buf, p-buf, &my_charset_bin);
 }
@@ -104,6 +104,7 @@
 #include "semisync_slave.h"
 
 #include "transaction.h"
+#include "filesort_utils.h"                     // filesort_threads_init
 
 #ifdef HAVE_SYS_PRCTL_H
 #include <sys/prctl.h>
@@ -434,6 +435,8 @@ my_bool sp_automatic_privileges= 1;
 ulong opt_binlog_rows_event_max_size;
 ulong binlog_row_metadata;
 my_bool opt_master_verify_checksum= 0;
+my_bool opt_binlog_dump_zero_copy= 1;
+ulong opt_binlog_dump_cache_size;
 my_bool opt_slave_sql_verify_checksum= 1;
 const char *binlog_format_names[]= {"MIXED", "STATEMENT", "ROW", NullS};
 volatile sig_atomic_t calling_initgroups= 0; /**< Used in SIGSEGV handler. */
@@ -482,6 +485,7 @@ ulong max_connections, max_connect_errors;
 uint max_password_errors;
 ulong extra_max_connections;
 uint max_digest_length= 0;
+uint filesort_threads= 0;
 ulong slave_retried_transactions;
 ulong transactions_multi_engine;
 ulong rpl_transactions_multi_engine;
@@ -528,6 +532,8 @@ ulong opt_slave_domain_parallel_threads= 0;
 ulong opt_slave_parallel_mode;
 ulong opt_binlog_commit_wait_count= 0;
 ulong opt_binlog_commit_wait_usec= 0;
+ulong opt_binlog_gtid_index_span= 0;
+ulong opt_binlog_writeset_max_keys= 0;
 ulong opt_slave_parallel_max_queued= 131072;
 my_bool opt_gtid_ignore_duplicates= FALSE;
 uint opt_gtid_cleanup_batch_size= 64;
@@ -1000,7 +1006,8 @@ PSI_rwlock_key key_rwlock_LOCK_grant, key_rwlock_LOCK_logger,
   key_rwlock_LOCK_vers_stats, key_rwlock_LOCK_stat_serial,
   key_rwlock_LOCK_ssl_refresh,
   key_rwlock_THD_list,
-  key_rwlock_LOCK_all_status_vars;
+  key_rwlock_LOCK_all_status_vars,
+  key_rwlock_BINLOG_dump_cache;
 
 static PSI_rwlock_info all_server_rwlocks[]=
 {
@@ -1018,7 +1025,8 @@ static PSI_rwlock_info all_server_rwlocks[]=
   { &key_rwlock_LOCK_stat_serial, "TABLE_SHARE::LOCK_stat_serial", 0},
   { &key_rwlock_LOCK_ssl_refresh, "LOCK_ssl_refresh", PSI_FLAG_GLOBAL },
   { &key_rwlock_THD_list, "THD_list::lock", PSI_FLAG_GLOBAL },
-  { &key_rwlock_LOCK_all_status_vars, "LOCK_all_status_vars", PSI_FLAG_GLOBAL }
+  { &key_rwlock_LOCK_all_status_vars, "LOCK_all_status_vars", PSI_FLAG_GLOBAL },
+  { &key_rwlock_BINLOG_dump_cache, "MYSQL_BIN_LOG::dump_cache", 0 }
 };
 
 #ifdef HAVE_MMAP
@@ -1989,6 +1997,7 @@ static void clean_up(bool print_message)
   xid_cache_free();
   tdc_deinit();
   mdl_destroy();
+  filesort_threads_end();
   dflt_key_cache= 0;
   key_caches.delete_elements(free_key_cache);
   wt_end();
@@ -4642,6 +4651,8 @@ static int init_server_components()
   mdl_init();
   if (tdc_init() || hostname_cache_init())
     unireg_abort(1);
+  if (filesort_threads_init())
+    unireg_abort(1);
 
   query_cache_set_min_res_unit(query_cache_min_res_unit);
   query_cache_result_size_limit(query_cache_limit);
@@ -7221,6 +7232,7 @@ SHOW_VAR status_vars[]= {
 #ifdef HAVE_REPLICATION
   {"Rpl_status",               (char*) &show_rpl_status,          SHOW_SIMPLE_FUNC},
 #endif
+  {"Select_batch_filter",      (char*) offsetof(STATUS_VAR, select_batch_filter_count), SHOW_LONG_STATUS},
   {"Select_full_join",         (char*) offsetof(STATUS_VAR, select_full_join_count_), SHOW_LONG_STATUS},
   {"Select_full_range_join",   (char*) offsetof(STATUS_VAR, select_full_range_join_count_), SHOW_LONG_STATUS},
   {"Select_range",             (char*) offsetof(STATUS_VAR, select_range_count_), SHOW_LONG_STATUS},
@@ -9039,6 +9051,7 @@ PSI_memory_key key_memory_THD_db;
 PSI_memory_key key_memory_THD_handler_tables_hash;
 PSI_memory_key key_memory_THD_variables;
 PSI_memory_key key_memory_Table_trigger_dispatcher;
+PSI_memory_key key_memory_Unique_hash_set;
 PSI_memory_key key_memory_Unique_merge_buffer;
 PSI_memory_key key_memory_Unique_sort_buffer;
 PSI_memory_key key_memory_User_level_lock;
@@ -9337,6 +9350,7 @@ static PSI_memory_info all_server_memory[]=
 //  { &key_memory_frm, "frm", 0},
   { &key_memory_Unique_sort_buffer, "Unique::sort_buffer", 0},
   { &key_memory_Unique_merge_buffer, "Unique::merge_buffer", 0},
+  { &key_memory_Unique_hash_set, "Unique::hash_set", 0},
   { &key_memory_TABLE, "TABLE", PSI_FLAG_GLOBAL}, /* Table cache */
 //  { &key_memory_frm_extra_segment_buff, "frm::extra_segment_buff", 0},
 //  { &key_memory_frm_form_pos, "frm::form_pos", 0},
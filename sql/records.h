@@ -27,6 +27,7 @@ class THD;
 class SQL_SELECT;
 class Copy_field;
 class SORT_INFO;
+class Batch_filter;
 
 struct READ_RECORD;
 
@@ -76,6 +77,8 @@ struct READ_RECORD
   */
   SORT_INFO *sort_info;
   struct st_io_cache *io_cache;
+  /* The filter reading the records by batches (see batch_filter.h) */
+  Batch_filter *batch_filter;
   bool print_error;
 
   int read_record() { return read_record_func(this); }
@@ -2227,6 +2227,105 @@ rpl_parallel_entry::choose_thread(rpl_group_info *rgi, bool *did_enter_cond,
   return thr;
 }
 
+/*
+  Upper bound on the number of hashes in the writeset of a gco, beyond which
+  a new gco is started.
+*/
+static const uint32 max_gco_writeset= 65536;
+
+/*
+  Whether the writeset of an event group describes all its changes, and
+  the event group may run in parallel with other event groups.
+*/
+static bool
+gtid_ev_has_writeset(const Gtid_log_event *gtid_ev)
+{
+  return gtid_ev->writeset_count &&
+    (gtid_ev->flags2 & (Gtid_log_event::FL_TRANSACTIONAL |
+                        Gtid_log_event::FL_ALLOW_PARALLEL |
+                        Gtid_log_event::FL_DDL)) ==
+    (Gtid_log_event::FL_TRANSACTIONAL | Gtid_log_event::FL_ALLOW_PARALLEL);
+}
+
+
+/*
+  Check if an event group can run in parallel with the event groups of
+  current_gco, because it modifies none of the keys that they modify.
+  If so, its writeset is added to that of current_gco.
+*/
+bool
+rpl_parallel_entry::writeset_join(const Gtid_log_event *gtid_ev)
+{
+  const uint32 *a= writeset, *a_end= writeset + writeset_count;
+  const uint32 *b= gtid_ev->writeset, *b_end= b + gtid_ev->writeset_count;
+
+  if (!writeset_valid || !gtid_ev_has_writeset(gtid_ev) ||
+      writeset_count + gtid_ev->writeset_count > max_gco_writeset)
+    return false;
+  while (a < a_end && b < b_end)
+  {
+    if (*a < *b)
+      a++;
+    else if (*b < *a)
+      b++;
+    else
+      return false;
+  }
+  writeset_add(gtid_ev);
+  return writeset_valid;
+}
+
+
+/*
+  Add the writeset of an event group that is queued in current_gco to the
+  writeset of current_gco, or invalidate the writeset of current_gco if the
+  event group has no writeset.
+*/
+void
+rpl_parallel_entry::writeset_add(const Gtid_log_event *gtid_ev)
+{
+  uint32 n= gtid_ev->writeset_count;
+  uint32 i, j, k;
+
+  if (!writeset_valid)
+    return;
+  if (!gtid_ev_has_writeset(gtid_ev) ||
+      writeset_count + n > max_gco_writeset)
+  {
+    writeset_valid= false;
+    return;
+  }
+  if (writeset_count + n > writeset_alloced)
+  {
+    uint32 alloc= MY_MIN(MY_MAX(writeset_count + n, 2 * writeset_alloced),
+                         max_gco_writeset);
+    uint32 *p= (uint32 *)my_realloc(PSI_INSTRUMENT_ME, writeset,
+                                    alloc * sizeof(*writeset),
+                                    MYF(MY_ALLOW_ZERO_PTR));
+    if (!p)
+    {
+      writeset_valid= false;
+      return;
+    }
+    writeset= p;
+    writeset_alloced= alloc;
+  }
+
+  /* Merge the sorted hashes, starting from the largest ones. */
+  i= writeset_count;
+  j= n;
+  k= writeset_count + n;
+  while (j)
+  {
+    if (i && writeset[i - 1] > gtid_ev->writeset[j - 1])
+      writeset[--k]= writeset[--i];
+    else
+      writeset[--k]= gtid_ev->writeset[--j];
+  }
+  writeset_count+= n;
+}
+
+
 static void
 free_rpl_parallel_entry(void *element)
 {
@@ -2237,6 +2336,7 @@ free_rpl_parallel_entry(void *element)
     dealloc_gco(e->current_gco);
     e->current_gco= prev_gco;
   }
+  my_free(e->writeset);
   mysql_cond_destroy(&e->COND_parallel_entry);
   mysql_mutex_destroy(&e->LOCK_parallel_entry);
   my_free(e);
@@ -2821,10 +2921,26 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
     {
       uint8 flags= gco->flags;
 
-      if (mode <= SLAVE_PARALLEL_MINIMAL ||
-          !(gtid_flags & Gtid_log_event::FL_GROUP_COMMIT_ID) ||
-          e->last_commit_id != gtid_ev->commit_id)
+      if (mode <= SLAVE_PARALLEL_MINIMAL)
         flags|= group_commit_orderer::MULTI_BATCH;
+      else if ((gtid_flags & Gtid_log_event::FL_GROUP_COMMIT_ID) &&
+               e->last_commit_id == gtid_ev->commit_id &&
+               !e->writeset_joined)
+        e->writeset_add(gtid_ev);
+      else if (mode != SLAVE_PARALLEL_CONSERVATIVE ||
+               !e->writeset_join(gtid_ev))
+      {
+        /*
+          Unless the writesets show that the event group modifies other keys
+          than the event groups of the current batch, it has to wait for
+          them to start committing. Once an event group of another group
+          commit has joined the batch, this also applies to the remaining
+          members of the group commit, as they may conflict with it.
+        */
+        flags|= group_commit_orderer::MULTI_BATCH;
+      }
+      else
+        e->writeset_joined= true;
       /* Make sure we do not attempt to run DDL in parallel speculatively. */
       if (gtid_flags & Gtid_log_event::FL_DDL)
         flags|= (force_switch_flag= group_commit_orderer::FORCE_SWITCH);
@@ -2910,6 +3026,10 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
       }
       gco->flags|= force_switch_flag;
       e->current_gco= gco;
+      e->writeset_count= 0;
+      e->writeset_valid= mode == SLAVE_PARALLEL_CONSERVATIVE;
+      e->writeset_joined= false;
+      e->writeset_add(gtid_ev);
     }
     rgi->gco= gco;
 
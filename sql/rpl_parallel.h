@@ -345,7 +345,25 @@ struct rpl_parallel_entry {
   uint64 count_committing_event_groups;
   /* The group_commit_orderer object for the events currently being queued. */
   group_commit_orderer *current_gco;
+  /*
+    Sorted hashes of the keys modified by the event groups of current_gco,
+    valid if writeset_valid is set. In conservative mode, an event group
+    with a writeset that does not intersect it is added to current_gco,
+    see Gtid_log_event::FL_EXTRA_WRITESET.
+  */
+  uint32 *writeset;
+  uint32 writeset_count;
+  uint32 writeset_alloced;
+  bool writeset_valid;
+  /*
+    Set when an event group of another group commit than the first one
+    joined current_gco through writeset_join(). From then on, every event
+    group must be checked against the writeset before it joins current_gco.
+  */
+  bool writeset_joined;
 
+  bool writeset_join(const Gtid_log_event *gtid_ev);
+  void writeset_add(const Gtid_log_event *gtid_ev);
   rpl_parallel_thread * choose_thread(rpl_group_info *rgi, bool *did_enter_cond,
                                       PSI_stage_info *old_stage,
                                       Gtid_log_event *gtid_ev);
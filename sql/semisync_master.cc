@@ -138,6 +138,30 @@ int Active_tranx::compare(const char *log_file_name1, my_off_t log_file_pos1,
   return 0;
 }
 
+ulonglong Active_tranx::encode_pos(const char *log_file_name,
+                                   my_off_t log_file_pos)
+{
+  const char *ext= strrchr(log_file_name, '.');
+  ulonglong file_no= 0;
+
+  DBUG_EXECUTE_IF("semisync_unencoded_pos", return 0;);
+
+  /* The file number takes 20 bits, and the position in the file the
+   * remaining 44 bits. Longer extensions would not compare as numbers.
+   */
+  if (!ext || strlen(ext + 1) != 6 || log_file_pos >> 44)
+    return 0;
+
+  for (const char *c= ext + 1; *c; c++)
+  {
+    if (*c < '0' || *c > '9')
+      return 0;
+    file_no= file_no * 10 + (*c - '0');
+  }
+
+  return file_no << 44 | log_file_pos;
+}
+
 int Active_tranx::insert_tranx_node(const char *log_file_name,
                                     my_off_t log_file_pos)
 {
@@ -228,6 +252,21 @@ bool Active_tranx::is_tranx_end_pos(const char *log_file_name,
   DBUG_RETURN(entry != NULL);
 }
 
+const Tranx_node *Active_tranx::find_acked_tranx_node(ulonglong ack_pos)
+{
+  const Tranx_node *acked= NULL;
+
+  for (const Tranx_node *node= m_trx_front; node; node= node->next)
+  {
+    ulonglong pos= encode_pos(node->log_name, node->log_pos);
+    if (!pos || pos > ack_pos)
+      break;
+    acked= node;
+  }
+
+  return acked;
+}
+
 void Active_tranx::clear_active_tranx_nodes(const char *log_file_name,
                                            my_off_t log_file_pos)
 {
@@ -339,6 +378,8 @@ Repl_semi_sync_master::Repl_semi_sync_master()
     m_init_done(false),
     m_reply_file_name_inited(false),
     m_reply_file_pos(0L),
+    m_ack_pos(0),
+    m_wait_pos(0),
     m_wait_file_name_inited(false),
     m_wait_file_pos(0),
     m_master_enabled(false),
@@ -406,6 +447,8 @@ int Repl_semi_sync_master::enable_master()
       m_commit_file_name_inited = false;
       m_reply_file_name_inited  = false;
       m_wait_file_name_inited   = false;
+      m_ack_pos= 0;
+      m_wait_pos= 0;
 
       set_master_enabled(true);
       m_state = true;
@@ -442,6 +485,8 @@ void Repl_semi_sync_master::disable_master()
     m_reply_file_name_inited = false;
     m_wait_file_name_inited  = false;
     m_commit_file_name_inited = false;
+    m_ack_pos= 0;
+    m_wait_pos= 0;
 
     set_master_enabled(false);
     sql_print_information("Semi-sync replication disabled on the master.");
@@ -490,6 +535,42 @@ int Repl_semi_sync_master::cond_timewait(struct timespec *wait_time)
   DBUG_RETURN(wait_res);
 }
 
+void Repl_semi_sync_master::advance_ack_pos(ulonglong ack_pos)
+{
+  ulonglong pos= m_ack_pos.load(std::memory_order_relaxed);
+
+  while (pos < ack_pos && !m_ack_pos.compare_exchange_weak(pos, ack_pos))
+    ;
+}
+
+void Repl_semi_sync_master::sync_reply_pos()
+{
+  mysql_mutex_assert_owner(&LOCK_binlog);
+
+  const ulonglong ack_pos= m_ack_pos.load(std::memory_order_acquire);
+  if (!ack_pos || !m_active_tranxs)
+    return;
+
+  /* The transactions that end at or before ack_pos have been acknowledged;
+   * the last of them is a reply position that we can record.
+   */
+  const Tranx_node *node= m_active_tranxs->find_acked_tranx_node(ack_pos);
+  if (node == NULL)
+    return;
+
+  if (!m_reply_file_name_inited ||
+      Active_tranx::compare(node->log_name, node->log_pos,
+                            m_reply_file_name, m_reply_file_pos) > 0)
+  {
+    strmake_buf(m_reply_file_name, node->log_name);
+    m_reply_file_pos = node->log_pos;
+    m_reply_file_name_inited = true;
+  }
+
+  m_active_tranxs->clear_active_tranx_nodes(m_reply_file_name,
+                                            m_reply_file_pos);
+}
+
 void Repl_semi_sync_master::add_slave()
 {
   lock();
@@ -571,12 +652,26 @@ int Repl_semi_sync_master::report_reply_binlog(uint32 server_id,
   int   cmp;
   bool  can_release_threads = false;
   bool  need_copy_send_pos = true;
+  const ulonglong ack_pos= Active_tranx::encode_pos(log_file_name,
+                                                    log_file_pos);
 
   DBUG_ENTER("Repl_semi_sync_master::report_reply_binlog");
 
   if (!(get_master_enabled()))
     DBUG_RETURN(0);
 
+  if (ack_pos && is_on())
+  {
+    /* Committing sessions see the acknowledgment in m_ack_pos. The mutex
+     * is only needed to wake up the sessions that wait for it. This
+     * pairs with the store of m_wait_pos in commit_trx().
+     */
+    advance_ack_pos(ack_pos);
+    const ulonglong wait_pos= m_wait_pos.load();
+    if (!wait_pos || ack_pos < wait_pos)
+      DBUG_RETURN(0);
+  }
+
   lock();
 
   /* This is the real check inside the mutex. */
@@ -584,8 +679,14 @@ int Repl_semi_sync_master::report_reply_binlog(uint32 server_id,
     goto l_end;
 
   if (!is_on())
+  {
     /* We check to see whether we can switch semi-sync ON. */
     try_switch_on(server_id, log_file_name, log_file_pos);
+    if (ack_pos && is_on())
+      advance_ack_pos(ack_pos);
+  }
+
+  sync_reply_pos();
 
   /* The position should increase monotonically, if there is only one
    * thread sending the binlog to the slave.
@@ -642,8 +743,11 @@ int Repl_semi_sync_master::report_reply_binlog(uint32 server_id,
        */
       can_release_threads = true;
       m_wait_file_name_inited = false;
+      m_wait_pos= 0;
     }
   }
+  else
+    m_wait_pos= 0;
 
  l_end:
   unlock();
@@ -790,6 +894,18 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
     int wait_result;
     PSI_stage_info old_stage;
     THD *thd= current_thd;
+    const ulonglong wait_pos= Active_tranx::encode_pos(trx_wait_binlog_name,
+                                                       trx_wait_binlog_pos);
+
+    /* If a slave has already acknowledged the transaction, there is no
+     * need to acquire the mutex.
+     */
+    if (wait_pos && is_on() &&
+        wait_pos <= m_ack_pos.load(std::memory_order_acquire))
+    {
+      my_atomic_addlong(&rpl_semi_sync_master_yes_transactions, 1);
+      DBUG_RETURN(0);
+    }
 
     set_timespec(start_ts, 0);
 
@@ -813,6 +929,14 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
 
     while (is_on() && !thd_killed(thd))
     {
+      /* Check m_ack_pos before sync_reply_pos() removes our position from
+       * the active transaction list.
+       */
+      const bool acked= wait_pos && wait_pos <= m_ack_pos.load();
+      sync_reply_pos();
+      if (acked)
+        break;
+
       if (m_reply_file_name_inited)
       {
         int cmp = Active_tranx::compare(m_reply_file_name, m_reply_file_pos,
@@ -862,6 +986,16 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
                                 m_wait_file_name, (ulong)m_wait_file_pos));
       }
 
+      /* Let report_reply_binlog() know that it has to wake us up, and check
+       * whether an acknowledgment arrived before it could see that.
+       */
+      const ulonglong min_wait_pos= wait_pos ? wait_pos : 1;
+      const ulonglong cur_wait_pos= m_wait_pos.load(std::memory_order_relaxed);
+      if (!cur_wait_pos || min_wait_pos < cur_wait_pos)
+        m_wait_pos.store(min_wait_pos);
+      if (wait_pos && wait_pos <= m_ack_pos.load())
+        continue;
+
       /* Calcuate the waiting period. */
       long diff_secs = (long) (m_wait_timeout / TIME_THOUSAND);
       long diff_nsecs = (long) ((m_wait_timeout % TIME_THOUSAND) * TIME_MILLION);
@@ -933,7 +1067,7 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
   l_end:
     /* Update the status counter. */
     if (is_on())
-      rpl_semi_sync_master_yes_transactions++;
+      my_atomic_addlong(&rpl_semi_sync_master_yes_transactions, 1);
     else
       rpl_semi_sync_master_no_transactions++;
 
@@ -976,6 +1110,8 @@ void Repl_semi_sync_master::switch_off()
   rpl_semi_sync_master_off_times++;
   m_wait_file_name_inited   = false;
   m_reply_file_name_inited  = false;
+  m_ack_pos= 0;
+  m_wait_pos= 0;
   sql_print_information("Semi-sync replication switched OFF.");
   cond_broadcast();                            /* wake up all waiting threads */
 
@@ -1052,6 +1188,18 @@ int Repl_semi_sync_master::update_sync_header(THD* thd, unsigned char *packet,
     DBUG_RETURN(0);
   }
 
+  /* No reply is needed for an event that a slave has already acknowledged.
+   */
+  if (is_on())
+  {
+    const ulonglong pos= Active_tranx::encode_pos(log_file_name, log_file_pos);
+    if (pos && pos <= m_ack_pos.load(std::memory_order_acquire))
+    {
+      *need_sync = false;
+      DBUG_RETURN(0);
+    }
+  }
+
   lock();
 
   /* This is the real check inside the mutex. */
@@ -1066,6 +1214,8 @@ int Repl_semi_sync_master::update_sync_header(THD* thd, unsigned char *packet,
     /* semi-sync is ON */
     sync = false;     /* No sync unless a transaction is involved. */
 
+    sync_reply_pos();
+
     if (m_reply_file_name_inited)
     {
       cmp = Active_tranx::compare(log_file_name, log_file_pos,
@@ -1179,6 +1329,8 @@ int Repl_semi_sync_master::write_tranx_in_binlog(const char* log_file_name,
   if (is_on())
   {
     assert(m_active_tranxs != NULL);
+    /* Do not let acknowledged transactions pile up in the list. */
+    sync_reply_pos();
     if(m_active_tranxs->insert_tranx_node(log_file_name, log_file_pos))
     {
       /*
@@ -1261,6 +1413,8 @@ int Repl_semi_sync_master::after_reset_master()
   m_wait_file_name_inited   = false;
   m_reply_file_name_inited  = false;
   m_commit_file_name_inited = false;
+  m_ack_pos= 0;
+  m_wait_pos= 0;
 
   rpl_semi_sync_master_yes_transactions = 0;
   rpl_semi_sync_master_no_transactions = 0;
@@ -21,6 +21,7 @@
 
 #include "semisync.h"
 #include "semisync_master_ack_receiver.h"
+#include <atomic>
 
 #ifdef HAVE_PSI_INTERFACE
 extern PSI_mutex_key key_LOCK_rpl_semi_sync_master_enabled;
@@ -353,12 +354,30 @@ class Active_tranx
    */
   bool is_tranx_end_pos(const char *log_file_name, my_off_t log_file_pos);
 
+  /* Find the last active transaction node whose ending position is not
+   * after an acknowledged position that was encoded by encode_pos().
+   *
+   * Return:
+   *  the node, or NULL if there is none
+   */
+  const Tranx_node *find_acked_tranx_node(ulonglong ack_pos);
+
   /* Given two binlog positions, compare which one is bigger based on
    * (file_name, file_position).
    */
   static int compare(const char *log_file_name1, my_off_t log_file_pos1,
                      const char *log_file_name2, my_off_t log_file_pos2);
 
+  /* Encode a binlog position as a number that grows with the position in
+   * the order of compare(), so that it can be compared and updated
+   * atomically. The file name must have the usual 6-digit extension.
+   *
+   * Return:
+   *  the encoded position, or 0 if the position cannot be encoded
+   */
+  static ulonglong encode_pos(const char *log_file_name,
+                              my_off_t log_file_pos);
+
 };
 
 /**
@@ -393,6 +412,21 @@ class Repl_semi_sync_master
   /* The position in that file up to which we have the reply from any slaves. */
   my_off_t        m_reply_file_pos;
 
+  /* The largest position that any slave has acknowledged, encoded by
+   * Active_tranx::encode_pos(), or 0. It is advanced without LOCK_binlog
+   * by report_reply_binlog(), and committing sessions check it without
+   * LOCK_binlog. m_reply_file_name, m_reply_file_pos and the active
+   * transaction list catch up with it in sync_reply_pos().
+   */
+  std::atomic<ulonglong> m_ack_pos;
+
+  /* The smallest encoded position that a session is waiting for, 1 if
+   * that position cannot be encoded, or 0 if no session is waiting.
+   * report_reply_binlog() only acquires LOCK_binlog to wake up the
+   * waiting sessions when m_ack_pos has reached it.
+   */
+  std::atomic<ulonglong> m_wait_pos;
+
   /* This is set to true when we know the 'smallest' wait position. */
   bool            m_wait_file_name_inited;
 
@@ -426,7 +460,7 @@ class Repl_semi_sync_master
   volatile bool            m_master_enabled;      /* semi-sync is enabled on the master */
   unsigned long           m_wait_timeout;      /* timeout period(ms) during tranx wait */
 
-  bool            m_state;                    /* whether semi-sync is switched */
+  std::atomic<bool> m_state;                  /* whether semi-sync is switched */
 
   /*Waiting for ACK before/after innodb commit*/
   ulong m_wait_point;
@@ -448,6 +482,14 @@ class Repl_semi_sync_master
   /* Switch semi-sync off because of timeout in transaction waiting. */
   void switch_off();
 
+  /* Advance m_ack_pos to an acknowledged position, unless it is ahead. */
+  void advance_ack_pos(ulonglong ack_pos);
+
+  /* Let m_reply_file_name, m_reply_file_pos and the active transaction
+   * list catch up with m_ack_pos. LOCK_binlog must be held.
+   */
+  void sync_reply_pos();
+
   /* Switch semi-sync on when slaves catch up. */
   int try_switch_on(int server_id,
                     const char *log_file_name, my_off_t log_file_pos);
@@ -290,7 +290,9 @@ The query cache interfaces with the rest of the server code through 7
     Query_cache::invalidate_locked_for_write
        - Called from various places to invalidate query cache based on data-
          base, table and myisam file name. During an on going invalidation
-         the query cache is temporarily disabled.
+         the query cache is temporarily disabled. The invalidation of a
+         table that is not used by any cached query does not lock the
+         cache (see Query_cache::table_slots).
  5. Query_cache::flush
        - Used when a RESET QUERY CACHE is issued. This clears the entire
          cache block by block.
@@ -306,6 +308,12 @@ The query cache interfaces with the rest of the server code through 7
 TODO list:
 
   - Delayed till after-parsing qache answer (for column rights processing)
+  - All lookups, stores and invalidations of cached queries are still
+    serialized on cache_lock; only the invalidation of tables without
+    cached queries avoids it (see Query_cache::table_slots). Partitioning
+    the lock by the hash of the table would need the memory arena, the
+    free block bins, the query LRU list and pack_cache() to be split
+    per partition.
   - Optimize cache resizing
       - if new_size < old_size then pack & shrink
       - if new_size > old_size copy cached query to new cache
@@ -1288,6 +1296,8 @@ Query_cache::Query_cache(size_t query_cache_limit_arg,
   set_if_bigger(min_allocation_unit,min_needed);
   this->min_allocation_unit= ALIGN_SIZE(min_allocation_unit);
   set_if_bigger(this->min_result_data_size,min_allocation_unit);
+  for (uint i= 0; i < QUERY_CACHE_TABLE_SLOTS; i++)
+    table_slots[i]= 0;
 }
 
 
@@ -2586,6 +2596,36 @@ void Query_cache::init()
 }
 
 
+/**
+  The collation used to compare the keys of the tables in the cache
+*/
+
+static CHARSET_INFO *query_cache_table_key_charset()
+{
+#ifndef FN_NO_CASE_SENSE
+  /*
+    If lower_case_table_names!=0 then db and table names are already 
+    converted to lower case and we can use binary collation for their 
+    comparison (no matter if file system case sensitive or not).
+    If we have case-sensitive file system (like on most Unixes) and
+    lower_case_table_names == 0 then we should distinguish my_table
+    and MY_TABLE cases and so again can use binary collation.
+  */
+  return &my_charset_bin;
+#else
+  /*
+    On windows, OS/2, MacOS X with HFS+ or any other case insensitive
+    file system if lower_case_table_names!=0 we have same situation as
+    in previous case, but if lower_case_table_names==0 then we should
+    not distinguish cases (to be compatible in behavior with underlying
+    file system) and so should use case insensitive collation for
+    comparison.
+  */
+  return lower_case_table_names ? &my_charset_bin : files_charset_info;
+#endif
+}
+
+
 size_t Query_cache::init_cache()
 {
   size_t mem_bin_count, num, step;
@@ -2729,30 +2769,9 @@ size_t Query_cache::init_cache()
 
   (void) my_hash_init(key_memory_Query_cache, &queries, &my_charset_bin,
                       def_query_hash_size, 0,0, query_cache_query_get_key,0,0);
-#ifndef FN_NO_CASE_SENSE
-  /*
-    If lower_case_table_names!=0 then db and table names are already 
-    converted to lower case and we can use binary collation for their 
-    comparison (no matter if file system case sensitive or not).
-    If we have case-sensitive file system (like on most Unixes) and
-    lower_case_table_names == 0 then we should distinguish my_table
-    and MY_TABLE cases and so again can use binary collation.
-  */
-  (void) my_hash_init(key_memory_Query_cache, &tables, &my_charset_bin,
-                      def_table_hash_size, 0,0, query_cache_table_get_key, 0,0);
-#else
-  /*
-    On windows, OS/2, MacOS X with HFS+ or any other case insensitive
-    file system if lower_case_table_names!=0 we have same situation as
-    in previous case, but if lower_case_table_names==0 then we should
-    not distinguish cases (to be compatible in behavior with underlying
-    file system) and so should use case insensitive collation for
-    comparison.
-  */
-  (void) my_hash_init(PSI_INSTRUMENT_ME, &tables, lower_case_table_names ?
-                      &my_charset_bin : files_charset_info,
+  (void) my_hash_init(key_memory_Query_cache, &tables,
+                      query_cache_table_key_charset(),
                       def_table_hash_size, 0,0, query_cache_table_get_key, 0,0);
-#endif
 
   queries_in_cache = 0;
   queries_blocks = 0;
@@ -2833,6 +2852,9 @@ void Query_cache::free_cache()
   make_disabled();
   my_hash_free(&queries);
   my_hash_free(&tables);
+  /* No table is in the cache any more */
+  for (uint i= 0; i < QUERY_CACHE_TABLE_SLOTS; i++)
+    table_slots[i]= 0;
   DBUG_VOID_RETURN;
 }
 
@@ -3302,6 +3324,21 @@ void Query_cache::invalidate_table(THD *thd, uchar * key, size_t key_length)
 {
   DEBUG_SYNC(thd, "wait_in_query_cache_invalidate1");
 
+  /*
+    If no table of the slot of this table is in the cache, there are no
+    queries to invalidate and the cache need not be locked. This saves the
+    cache lock for the writes to the tables that are not used by cached
+    queries. The fence orders the preceding modification of the table
+    before the check; insert_table() registers the table by a
+    read-modify-write of the slot before the query reads the table, so
+    if we do not see the table registered, the query will not read stale
+    data.
+  */
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!table_slots[table_slot(key, key_length)].
+        load(std::memory_order_relaxed))
+    return;
+
   /*
     Lock the query cache and queue all invalidation attempts to avoid
     the risk of a race between invalidation, cache inserts and flushes.
@@ -3317,6 +3354,17 @@ void Query_cache::invalidate_table(THD *thd, uchar * key, size_t key_length)
 }
 
 
+/**
+  Get the slot of the array table_slots for the table with the given key
+*/
+
+uint Query_cache::table_slot(const uchar *key, size_t key_length)
+{
+  return (uint) (my_hash_sort(query_cache_table_key_charset(), key,
+                              key_length) % QUERY_CACHE_TABLE_SLOTS);
+}
+
+
 /**
   Try to locate and invalidate a table by name.
   The caller must ensure that no other thread is trying to work with
@@ -3567,13 +3615,16 @@ Query_cache::insert_table(THD *thd, size_t key_len, const char *key,
     */
     list_root->next= list_root->prev= list_root;
 
-    if (hash &&
-        my_hash_insert(&tables, (const uchar *) table_block))
+    if (hash)
     {
-      DBUG_PRINT("qcache", ("Can't insert table to hash"));
-      // write_block_data return locked block
-      free_memory_block(table_block);
-      DBUG_RETURN(0);
+      if (my_hash_insert(&tables, (const uchar *) table_block))
+      {
+        DBUG_PRINT("qcache", ("Can't insert table to hash"));
+        // write_block_data return locked block
+        free_memory_block(table_block);
+        DBUG_RETURN(0);
+      }
+      table_slots[table_slot((const uchar *) key, key_len)]++;
     }
     char *db= header->db();
     header->table(db + db_length + 1);
@@ -3638,7 +3689,11 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
                                &tables_blocks);
     Query_cache_table *header= table_block->table();
     if (header->is_hashed())
+    {
+      table_slots[table_slot((const uchar *) header->db(),
+                             header->key_length())]--;
       my_hash_delete(&tables,(uchar *) table_block);
+    }
     free_memory_block(table_block);
   }
   DBUG_VOID_RETURN;
@@ -18,6 +18,7 @@
 
 #include "hash.h"
 #include "my_base.h"                            /* ha_rows */
+#include <atomic>
 
 class MY_LOCALE;
 struct TABLE_LIST;
@@ -40,6 +41,9 @@ typedef struct st_changed_table_list CHANGED_TABLE_LIST;
 #define QUERY_CACHE_DEF_QUERY_HASH_SIZE		1024
 #define QUERY_CACHE_DEF_TABLE_HASH_SIZE		1024
 
+/* number of slots the tables are mapped to by Query_cache::table_slot() */
+#define QUERY_CACHE_TABLE_SLOTS			1024
+
 /* minimal result data size when data allocated */
 #define QUERY_CACHE_MIN_RESULT_DATA_SIZE	(1024*4)
 
@@ -342,6 +346,13 @@ class Query_cache
   Query_cache_block *first_block;		// physical location block list
   Query_cache_block *queries_blocks;		// query list (LIFO)
   Query_cache_block *tables_blocks;
+  /*
+    The tables are mapped to the slots of this array by the hash of their
+    keys (see table_slot()). A slot holds the number of tables of the slot
+    present in the hash 'tables'. It is changed under the cache lock, and
+    read without it by invalidate_table().
+  */
+  std::atomic<uint32> table_slots[QUERY_CACHE_TABLE_SLOTS];
 
   Query_cache_memory_bin *bins;			// free block lists
   Query_cache_memory_bin_step *steps;		// bins spacing info
@@ -377,6 +388,7 @@ class Query_cache
   void invalidate_table(THD *thd, Query_cache_block *table_block);
   void invalidate_query_block_list(THD *thd, 
                                    Query_cache_block_table *list_root);
+  static uint table_slot(const uchar *key, size_t key_length);
 
   TABLE_COUNTER_TYPE
     register_tables_from_list(THD *thd, TABLE_LIST *tables_used,
@@ -890,6 +890,7 @@ typedef struct system_status_var
   ulong select_range_count_;
   ulong select_range_check_count_;
   ulong select_scan_count_;
+  ulong select_batch_filter_count;
   ulong update_scan_count;
   ulong delete_scan_count;
   ulong executed_triggers;
@@ -2608,6 +2609,9 @@ class THD: public THD_count, /* this must be first */
   bool binlog_write_table_maps();
   bool binlog_write_table_map(TABLE *table, bool with_annotate);
   static void binlog_prepare_row_images(TABLE* table);
+  void binlog_update_writeset(TABLE *table, bool is_transactional,
+                              const uchar *before_record,
+                              const uchar *after_record);
 
   void set_server_id(uint32 sid) { variables.server_id = sid; }
 
@@ -132,9 +132,9 @@ void Expression_cache_tmptable::init()
     DBUG_VOID_RETURN;
   }
 
-  if (cache_table->s->db_type() != heap_hton)
+  if (cache_table->s->db_type() != heap_hton || cache_table->s->blob_fields)
   {
-    DBUG_PRINT("error", ("we need only heap table"));
+    DBUG_PRINT("error", ("we need only heap table without blobs"));
     goto error;
   }
 
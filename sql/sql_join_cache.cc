@@ -3812,12 +3812,621 @@ void JOIN_CACHE_BNLH::read_next_candidate_for_match(uchar *rec_ptr)
 
 int JOIN_CACHE_BNLH::init(bool for_explain)
 {
+  int rc;
   DBUG_ENTER("JOIN_CACHE_BNLH::init");
 
   if (!(join_tab_scan= new JOIN_TAB_SCAN(join, join_tab)))
     DBUG_RETURN(1);
 
-  DBUG_RETURN(JOIN_CACHE_HASHED::init(for_explain));
+  if ((rc= JOIN_CACHE_HASHED::init(for_explain)) || for_explain)
+    DBUG_RETURN(rc);
+
+  spill_allowed= check_spill_allowed();
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Get the maximal length of the record of a table packed into a partition
+
+  SYNOPSIS
+    get_spill_record_length()
+      table       the table whose record is to be packed
+
+  DESCRIPTION
+    The function calculates the maximal length of the record of 'table'
+    packed by the method JOIN_CACHE_BNLH::pack_spill_record. Only the
+    fields from the read set of the table are taken into account.
+
+  RETURN VALUE
+    the maximal length of the packed record,
+    0 if the record contains blobs and cannot be packed
+*/
+
+static size_t get_spill_record_length(TABLE *table)
+{
+  size_t length= 1 + table->s->null_bytes;
+  for (Field **fld_ptr= table->field; *fld_ptr; fld_ptr++)
+  {
+    Field *field= *fld_ptr;
+    if (!bitmap_is_set(table->read_set, field->field_index))
+      continue;
+    if (field->flags & BLOB_FLAG)
+      return 0;
+    /* Field::pack may prepend the value with up to 2 bytes of its length */
+    length+= field->pack_length() + 2;
+  }
+  return length;
+}
+
+
+/*
+  Check whether the BNLH join can be performed by partitions on disk
+
+  SYNOPSIS
+    check_spill_allowed()
+
+  DESCRIPTION
+    When the join buffer of a BNLH join overflows the join is performed
+    in the same way as a grace hash join: the records from the join buffer
+    and then all records of join_tab are distributed by the hash value of
+    their join keys over JOIN_CACHE_SPILL_PARTITIONS partitions saved in
+    temporary files. After this the records of each partition of join_tab
+    are matched only against the records of the same partition of the
+    join buffer. Thus join_tab is scanned only once, however big the
+    number of partial join records is.
+    The function checks whether this is enabled by the optimizer switch
+    'join_cache_hashed_spill' and whether it can be done for the join
+    operation. The records of the join buffer must not be referenced by
+    other join caches, and no match flags must be needed for them (the
+    join is neither an outer join nor a semi-join). The records of all
+    joined tables must be fully restorable from the values of their fields,
+    i.e. neither blobs nor rowids must be used.
+
+  RETURN VALUE
+    TRUE    the join can be performed by partitions on disk
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::check_spill_allowed()
+{
+  if (!optimizer_flag(join->thd, OPTIMIZER_SWITCH_JOIN_CACHE_HASHED_SPILL) ||
+      prev_cache || with_match_flag || join_tab->first_inner ||
+      join_tab->is_last_inner_table() || join_tab->check_only_first_match() ||
+      join_tab->use_quick == 2 || join_tab->keep_current_rowid ||
+      !get_spill_record_length(join_tab->table))
+    return FALSE;
+
+  for (JOIN_TAB *tab= start_tab; tab != join_tab;
+       tab= next_linear_tab(join, tab, WITHOUT_BUSH_ROOTS))
+  {
+    if (tab->keep_current_rowid || !get_spill_record_length(tab->table))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+
+/*
+  Open the temporary files for the partitions of a BNLH join
+
+  SYNOPSIS
+    open_spill_files()
+
+  DESCRIPTION
+    The function opens the temporary files for the partitions of the records
+    from the join buffer and for the partitions of the records of join_tab,
+    and allocates the buffer to pack the records into.
+
+  RETURN VALUE
+    FALSE   the files have been successfully opened
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_BNLH::open_spill_files()
+{
+  THD *thd= join->thd;
+  size_t length= get_spill_record_length(join_tab->table);
+  size_t outer_length= 0;
+  uint i;
+
+  for (JOIN_TAB *tab= start_tab; tab != join_tab;
+       tab= next_linear_tab(join, tab, WITHOUT_BUSH_ROOTS))
+  {
+    size_t tab_length= get_spill_record_length(tab->table);
+    if (!tab_length)
+      return TRUE;
+    outer_length+= tab_length;
+  }
+  if (!length)
+    return TRUE;
+  /* A packed record is prepended by its length */
+  length= MY_MAX(length, outer_length) + 4;
+
+  if (!spill_files &&
+      (!(spill_files= (IO_CACHE *)
+         thd->calloc(sizeof(IO_CACHE) * 2 * JOIN_CACHE_SPILL_PARTITIONS)) ||
+       !(spill_records= (ha_rows *)
+         thd->alloc(sizeof(ha_rows) * 2 * JOIN_CACHE_SPILL_PARTITIONS))))
+    return TRUE;
+
+  if (length > spill_buff_size)
+  {
+    if (!(spill_buff= (uchar *) thd->alloc(length)))
+      return TRUE;
+    spill_buff_size= length;
+  }
+
+  for (i= 0; i < 2 * JOIN_CACHE_SPILL_PARTITIONS; i++)
+  {
+    spill_records[i]= 0;
+    if (open_cached_file(&spill_files[i], mysql_tmpdir, TEMP_PREFIX,
+                         IO_SIZE * 4, MYF(MY_WME)))
+    {
+      while (i)
+        close_cached_file(&spill_files[--i]);
+      return TRUE;
+    }
+  }
+  spill_active= TRUE;
+  spill_failed= FALSE;
+  return FALSE;
+}
+
+
+/* Close the temporary files for the partitions of a BNLH join */
+
+void JOIN_CACHE_BNLH::close_spill_files()
+{
+  if (!spill_active)
+    return;
+  for (uint i= 0; i < 2 * JOIN_CACHE_SPILL_PARTITIONS; i++)
+    close_cached_file(&spill_files[i]);
+  spill_active= FALSE;
+}
+
+
+/*
+  Get the number of the partition for a join key
+
+  SYNOPSIS
+    get_spill_partition()
+      key         pointer to the key value
+
+  DESCRIPTION
+    The function calculates the number of the partition the record with
+    the given join key is to be written to. As the key values are compared
+    with the collations of the key components taken into account the hash
+    value is calculated by the function key_hashnr. The hash value is
+    scrambled to make the partition number independent of the index of
+    the hash entry for the key in the hash table of the join buffer.
+
+  RETURN VALUE
+    the number of the partition for the key
+*/
+
+uint JOIN_CACHE_BNLH::get_spill_partition(uchar *key)
+{
+  uint32 nr= (uint32) key_hashnr(ref_key_info, ref_used_key_parts, key);
+  return (uint) ((nr * 2654435761U) >> 16) % JOIN_CACHE_SPILL_PARTITIONS;
+}
+
+
+/*
+  Pack the current record of a joined table for writing it into a partition
+
+  SYNOPSIS
+    pack_spill_record()
+      tab         the join table whose current record is to be packed
+      to          the position in spill_buff to put the packed record to
+
+  DESCRIPTION
+    The function packs the null_row flag, the null bitmap and the values
+    of the not null fields from the read set of the table of 'tab'.
+
+  RETURN VALUE
+    the position in spill_buff right after the packed record
+*/
+
+uchar *JOIN_CACHE_BNLH::pack_spill_record(JOIN_TAB *tab, uchar *to)
+{
+  TABLE *table= tab->table;
+  *to++= (uchar) table->null_row;
+  memcpy(to, table->null_flags, table->s->null_bytes);
+  to+= table->s->null_bytes;
+  for (Field **fld_ptr= table->field; *fld_ptr; fld_ptr++)
+  {
+    Field *field= *fld_ptr;
+    if (bitmap_is_set(table->read_set, field->field_index) &&
+        !field->is_null())
+      to= field->pack(to, field->ptr);
+  }
+  return to;
+}
+
+
+/*
+  Unpack a record read from a partition into the record buffer of a table
+
+  SYNOPSIS
+    unpack_spill_record()
+      tab         the join table to unpack the record for
+      from        the position of the packed record in spill_buff
+
+  DESCRIPTION
+    The function performs the reverse action to pack_spill_record.
+
+  RETURN VALUE
+    the position in spill_buff right after the unpacked record
+*/
+
+const uchar *JOIN_CACHE_BNLH::unpack_spill_record(JOIN_TAB *tab,
+                                                  const uchar *from)
+{
+  TABLE *table= tab->table;
+  const uchar *end= spill_buff + spill_buff_size;
+  table->null_row= *from++;
+  memcpy(table->null_flags, from, table->s->null_bytes);
+  from+= table->s->null_bytes;
+  for (Field **fld_ptr= table->field; *fld_ptr; fld_ptr++)
+  {
+    Field *field= *fld_ptr;
+    if (bitmap_is_set(table->read_set, field->field_index) &&
+        !field->is_null())
+      from= field->unpack(field->ptr, from, end, 0);
+  }
+  return from;
+}
+
+
+/*
+  Write the record packed in spill_buff into the file of a partition
+
+  SYNOPSIS
+    write_spill_record()
+      file_no     the number of the file in spill_files
+      end         the position in spill_buff right after the packed record
+
+  RETURN VALUE
+    FALSE   the record has been successfully written
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_BNLH::write_spill_record(uint file_no, uchar *end)
+{
+  size_t length= (size_t) (end - spill_buff);
+  int4store(spill_buff, (uint32) (length - 4));
+  if (my_b_write(&spill_files[file_no], spill_buff, length))
+    return TRUE;
+  spill_records[file_no]++;
+  return FALSE;
+}
+
+
+/*
+  Prepare the file of a partition for reading from its beginning
+
+  SYNOPSIS
+    rewind_spill_file()
+      file_no     the number of the file in spill_files
+
+  RETURN VALUE
+    FALSE   the file has been successfully rewound
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_BNLH::rewind_spill_file(uint file_no)
+{
+  IO_CACHE *file= &spill_files[file_no];
+  return flush_io_cache(file) || reinit_io_cache(file, READ_CACHE, 0L, 0, 0);
+}
+
+
+/*
+  Read the next record from the file of a partition into spill_buff
+
+  SYNOPSIS
+    read_spill_record()
+      file_no     the number of the file in spill_files
+
+  RETURN VALUE
+    FALSE   the record has been successfully read
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_BNLH::read_spill_record(uint file_no)
+{
+  IO_CACHE *file= &spill_files[file_no];
+  if (!my_b_read(file, spill_buff, 4) &&
+      !my_b_read(file, spill_buff + 4, uint4korr(spill_buff)))
+    return FALSE;
+  if (!join->thd->is_error())
+    my_error(ER_ERROR_ON_READ, MYF(0), my_filename(file->file), my_errno);
+  return TRUE;
+}
+
+
+/*
+  Add a record into the join buffer of a BNLH join
+
+  SYNOPSIS
+    put_record()
+
+  DESCRIPTION
+    This implementation of the virtual method put_record calls the method
+    of the parent class to add the record into the join buffer. If the join
+    buffer is full after this and the join can be performed by partitions
+    on disk (see check_spill_allowed) then all records from the buffer are
+    written into the partitions, the buffer is emptied and the function
+    reports that more records can be added to the buffer. The matching
+    records of join_tab are looked for only when all partial join records
+    have been written (see join_matching_records).
+    If the temporary files for the partitions cannot be opened the join
+    falls back to re-reading join_tab each time the buffer is full.
+
+  RETURN VALUE
+    TRUE    the matching records are to be looked for now
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::put_record()
+{
+  if (!JOIN_CACHE_HASHED::put_record())
+    return FALSE;
+  if (!spill_allowed || next_cache ||
+      (!spill_active && open_spill_files()))
+    return TRUE;
+  if (spill_buffered_records())
+  {
+    spill_failed= TRUE;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+/*
+  Write all records from the join buffer into the partitions
+
+  SYNOPSIS
+    spill_buffered_records()
+
+  DESCRIPTION
+    The function reads the records from the join buffer one by one into
+    the record buffers of the joined tables, builds the join key for each
+    of them and writes the record into the partition for this key.
+    The records whose keys contain nulls are skipped as they cannot have
+    matches. After this the join buffer is emptied. As the last record
+    read from the buffer is the record that has been added to it last,
+    the record buffers of the tables are not changed by the function.
+
+  RETURN VALUE
+    FALSE   all records have been successfully written
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_BNLH::spill_buffered_records()
+{
+  TABLE_REF *ref= &join_tab->ref;
+  DBUG_ENTER("JOIN_CACHE_BNLH::spill_buffered_records");
+
+  reset(FALSE);
+  for (size_t cnt= records; cnt; cnt--)
+  {
+    get_record();
+    if (cp_buffer_from_ref(join->thd, join_tab->table, ref))
+      continue;
+    uchar *end= spill_buff + 4;
+    for (JOIN_TAB *tab= start_tab; tab != join_tab;
+         tab= next_linear_tab(join, tab, WITHOUT_BUSH_ROOTS))
+      end= pack_spill_record(tab, end);
+    if (write_spill_record(get_spill_partition(ref->key_buff), end))
+      DBUG_RETURN(TRUE);
+  }
+  reset(TRUE);
+  DBUG_RETURN(FALSE);
+}
+
+
+/*
+  Find matches from the next table for records from the join buffer
+
+  SYNOPSIS
+    join_matching_records()
+      skip_last    do not look for matches for the last partial join record
+
+  DESCRIPTION
+    If no records have been written into the partitions on disk this
+    implementation of the virtual method join_matching_records just calls
+    the method of the base class. Otherwise it performs the join
+    by partitions (see join_spilled_records) and closes the files of
+    the partitions.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_matching_records(bool skip_last)
+{
+  enum_nested_loop_state rc;
+  if (!spill_active)
+    return JOIN_CACHE_HASHED::join_matching_records(skip_last);
+  DBUG_ASSERT(!skip_last);
+  rc= join_spilled_records();
+  close_spill_files();
+  return rc;
+}
+
+
+/*
+  Join the records written into the partitions with the records of join_tab
+
+  SYNOPSIS
+    join_spilled_records()
+
+  DESCRIPTION
+    The function writes the records remaining in the join buffer into the
+    partitions, then scans join_tab once distributing its records that
+    meet the condition pushed to join_tab over the partitions for these
+    records. After this the partial join records of each partition are
+    joined with the records of join_tab from the same partition.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_spilled_records()
+{
+  int error;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  TABLE *table= join_tab->table;
+  KEY *keyinfo= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
+  DBUG_ENTER("JOIN_CACHE_BNLH::join_spilled_records");
+
+  if (spill_failed || (records && spill_buffered_records()))
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+
+  table->null_row= 0;
+
+  if ((rc= join_tab_execution_startup(join_tab)) < 0)
+    DBUG_RETURN(rc);
+
+  join_tab->build_range_rowid_filter_if_needed();
+
+  if (likely(!(error= join_tab_scan->open())))
+  {
+    while (!(error= join_tab_scan->next()))
+    {
+      if (unlikely(join->thd->check_killed()))
+      {
+        /* The user has aborted the execution of the query */
+        rc= NESTED_LOOP_KILLED;
+        break;
+      }
+      key_copy(key_buff, table->record[0], keyinfo, key_length, TRUE);
+      if (write_spill_record(get_spill_partition(key_buff),
+                             pack_spill_record(join_tab, spill_buff + 4)))
+      {
+        rc= NESTED_LOOP_ERROR;
+        break;
+      }
+    }
+  }
+  join_tab_scan->close();
+  if (rc != NESTED_LOOP_OK)
+    DBUG_RETURN(rc);
+  if (error > 0)
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+
+  save_or_restore_used_tabs(join_tab, FALSE);
+  for (uint part= 0; part < JOIN_CACHE_SPILL_PARTITIONS; part++)
+  {
+    rc= join_spilled_partition(part);
+    if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+      break;
+  }
+  save_or_restore_used_tabs(join_tab, TRUE);
+  DBUG_RETURN(rc);
+}
+
+
+/*
+  Join the records of the partitions with the same number
+
+  SYNOPSIS
+    join_spilled_partition()
+      part        the number of the partitions
+
+  DESCRIPTION
+    The function reads the partial join records of the partition 'part'
+    into the join buffer. Each time the buffer is full, and after the last
+    record of the partition, the records of join_tab from the partition
+    with the same number are joined with the records from the buffer.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_spilled_partition(uint part)
+{
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  uint inner_file_no= JOIN_CACHE_SPILL_PARTITIONS + part;
+  ha_rows cnt= spill_records[part];
+
+  if (!cnt || !spill_records[inner_file_no])
+    return NESTED_LOOP_OK;
+  if (rewind_spill_file(part))
+    return NESTED_LOOP_ERROR;
+
+  reset(TRUE);
+  for ( ; cnt; cnt--)
+  {
+    if (read_spill_record(part))
+      return NESTED_LOOP_ERROR;
+    const uchar *pos= spill_buff + 4;
+    for (JOIN_TAB *tab= start_tab; tab != join_tab;
+         tab= next_linear_tab(join, tab, WITHOUT_BUSH_ROOTS))
+      pos= unpack_spill_record(tab, pos);
+    if (JOIN_CACHE_HASHED::put_record() || cnt == 1)
+    {
+      rc= probe_spilled_partition(inner_file_no);
+      if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+        return rc;
+      reset(TRUE);
+    }
+  }
+  return rc;
+}
+
+
+/*
+  Look for matches for the records from the join buffer in a partition
+
+  SYNOPSIS
+    probe_spilled_partition()
+      file_no     the number of the file of the partition of join_tab
+
+  DESCRIPTION
+    The function reads the records of join_tab from the partition one by one
+    into the record buffer of join_tab and generates all full extensions
+    of the matching partial join records from the join buffer.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::probe_spilled_partition(uint file_no)
+{
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  TABLE *table= join_tab->table;
+
+  if (rewind_spill_file(file_no))
+    return NESTED_LOOP_ERROR;
+
+  for (ha_rows cnt= spill_records[file_no]; cnt; cnt--)
+  {
+    if (unlikely(join->thd->check_killed()))
+      return NESTED_LOOP_KILLED;
+    if (read_spill_record(file_no))
+      return NESTED_LOOP_ERROR;
+    unpack_spill_record(join_tab, spill_buff + 4);
+    table->status= 0;
+
+    if (prepare_look_for_matches(FALSE))
+      continue;
+    join_tab->jbuf_tracker->r_scans++;
+
+    uchar *rec_ptr;
+    while ((rec_ptr= get_next_candidate_for_match()))
+    {
+      join_tab->jbuf_tracker->r_rows++;
+      read_next_candidate_for_match(rec_ptr);
+      rc= generate_full_extensions(rec_ptr);
+      if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+        return rc;
+    }
+  }
+  return rc;
 }
 
 
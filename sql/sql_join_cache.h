@@ -34,6 +34,13 @@
 #define CACHE_VARSTR2   4        /* long string value (length takes 2 bytes) */
 #define CACHE_ROWID     5        /* ROWID field */
 
+/*
+  Number of partitions the records of both operands of a BNLH join are
+  distributed over when the join buffer overflows and the join is performed
+  by partitions saved in temporary files (see JOIN_CACHE_BNLH::put_record)
+*/
+#define JOIN_CACHE_SPILL_PARTITIONS  16
+
 /*
   The CACHE_FIELD structure used to describe fields of records that
   are written into a join cache buffer from record buffers and backward.
@@ -668,7 +675,7 @@ class JOIN_CACHE :public Sql_alloc
 
   virtual ~JOIN_CACHE() {}
   void reset_join(JOIN *j) { join= j; }
-  void free()
+  virtual void free()
   { 
     my_free(buff);
     buff= 0;
@@ -1178,6 +1185,43 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
 
   void read_next_candidate_for_match(uchar *rec_ptr);
 
+  /* 
+    TRUE if the records of the join operands can be distributed over
+    partitions in temporary files when the join buffer overflows
+  */
+  bool spill_allowed;
+  /* TRUE if the records are currently being written into the partitions */
+  bool spill_active;
+  /* TRUE if writing a record into a partition has failed */
+  bool spill_failed;
+  /* 
+    Temporary files with the partitions: first go the files for the records
+    from the join buffer, then the files for the records of join_tab
+  */
+  IO_CACHE *spill_files;
+  /* Number of records written into each of the files from spill_files */
+  ha_rows *spill_records;
+  /* Buffer to pack/unpack a record written into/read from a partition */
+  uchar *spill_buff;
+  /* Size of the buffer spill_buff */
+  size_t spill_buff_size;
+
+  bool check_spill_allowed();
+  bool open_spill_files();
+  void close_spill_files();
+  uint get_spill_partition(uchar *key);
+  uchar *pack_spill_record(JOIN_TAB *tab, uchar *to);
+  const uchar *unpack_spill_record(JOIN_TAB *tab, const uchar *from);
+  bool write_spill_record(uint file_no, uchar *end);
+  bool rewind_spill_file(uint file_no);
+  bool read_spill_record(uint file_no);
+  bool spill_buffered_records();
+  enum_nested_loop_state join_spilled_records();
+  enum_nested_loop_state join_spilled_partition(uint part);
+  enum_nested_loop_state probe_spilled_partition(uint file_no);
+
+  enum_nested_loop_state join_matching_records(bool skip_last);
+
 public:
 
   /* 
@@ -1185,7 +1229,9 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     used to join table 'tab' to the result of joining the previous tables 
     specified by the 'j' parameter.
   */   
-  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab) : JOIN_CACHE_HASHED(j, tab) {}
+  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab)
+    : JOIN_CACHE_HASHED(j, tab), spill_allowed(FALSE), spill_active(FALSE),
+      spill_failed(FALSE), spill_files(0), spill_buff_size(0) {}
 
   /* 
     This constructor creates a linked BNLH join cache. The cache is to be 
@@ -1194,11 +1240,22 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     cache object to which this cache is linked.
   */   
   JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab, JOIN_CACHE *prev) 
-    : JOIN_CACHE_HASHED(j, tab, prev) {}
+    : JOIN_CACHE_HASHED(j, tab, prev), spill_allowed(FALSE),
+      spill_active(FALSE), spill_failed(FALSE), spill_files(0),
+      spill_buff_size(0) {}
 
   /* Initialize the BNLH cache */       
   int init(bool for_explain);
 
+  /* Add a record into the join buffer, spill the buffer if it's full */
+  bool put_record();
+
+  void free()
+  {
+    close_spill_files();
+    JOIN_CACHE_HASHED::free();
+  }
+
   enum Join_algorithm get_join_alg() { return BNLH_JOIN_ALG; }
 
   bool is_key_access() { return TRUE; }
@@ -234,6 +234,8 @@
 #define OPTIMIZER_SWITCH_USE_ROWID_FILTER          (1ULL << 33)
 #define OPTIMIZER_SWITCH_COND_PUSHDOWN_FROM_HAVING (1ULL << 34)
 #define OPTIMIZER_SWITCH_NOT_NULL_RANGE_SCAN       (1ULL << 35)
+#define OPTIMIZER_SWITCH_JOIN_CACHE_HASHED_SPILL   (1ULL << 36)
+#define OPTIMIZER_SWITCH_BATCH_FILTER              (1ULL << 37)
 
 #define OPTIMIZER_SWITCH_DEFAULT   (OPTIMIZER_SWITCH_INDEX_MERGE | \
                                     OPTIMIZER_SWITCH_INDEX_MERGE_UNION | \
@@ -264,7 +266,8 @@
                                     OPTIMIZER_SWITCH_COND_PUSHDOWN_FOR_SUBQUERY | \
                                     OPTIMIZER_SWITCH_USE_ROWID_FILTER | \
                                     OPTIMIZER_SWITCH_COND_PUSHDOWN_FROM_HAVING | \
-                                    OPTIMIZER_SWITCH_OPTIMIZE_JOIN_BUFFER_SIZE)
+                                    OPTIMIZER_SWITCH_OPTIMIZE_JOIN_BUFFER_SIZE | \
+                                    OPTIMIZER_SWITCH_BATCH_FILTER)
 
 /*
   Replication uses 8 bytes to store SQL_MODE in the binary log. The day you
@@ -31,6 +31,10 @@
 #include "semisync_master.h"
 #include "semisync_slave.h"
 #include "mysys_err.h"
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#include <sys/uio.h>
+#endif
 
 enum enum_gtid_until_state {
   GTID_UNTIL_NOT_DONE,
@@ -162,6 +166,13 @@ struct binlog_send_info {
   bool should_stop;
   size_t dirlen;
 
+  /** buffer for send_events_zero_copy(), allocated on first use */
+  uchar *zero_copy_buf;
+  /** offset of zero_copy_buf in the binlog file */
+  my_off_t zero_copy_pos;
+  /** number of bytes of the binlog file in zero_copy_buf */
+  size_t zero_copy_len;
+
   binlog_send_info(THD *thd_arg, String *packet_arg, ushort flags_arg,
                    char *lfn)
     : thd(thd_arg), net(&thd_arg->net), packet(packet_arg),
@@ -179,7 +190,10 @@ struct binlog_send_info {
       hb_info_counter(0),
 #endif
       clear_initial_log_pos(false),
-      should_stop(false)
+      should_stop(false),
+      zero_copy_buf(NULL),
+      zero_copy_pos(0),
+      zero_copy_len(0)
   {
     error_text[0] = 0;
     bzero(&error_gtid, sizeof(error_gtid));
@@ -985,15 +999,19 @@ get_binlog_list(MEM_ROOT *memroot, bool reverse= true,
   Gtid_list_log_event where D is not present in the requested slave state at
   all. Since if D is not in requested slave state, it means that slave needs
   to start at the very first GTID in domain D.
+
+  The list is the one of the Gtid_list_log_event at the start of the file,
+  or the binlog state of an entry of the GTID index of the file.
 */
 static bool
-contains_all_slave_gtid(slave_connection_state *st, Gtid_list_log_event *glev)
+contains_all_slave_gtid(slave_connection_state *st, const rpl_gtid *list,
+                        uint32 count)
 {
   uint32 i;
 
-  for (i= 0; i < glev->count; ++i)
+  for (i= 0; i < count; ++i)
   {
-    uint32 gl_domain_id= glev->list[i].domain_id;
+    uint32 gl_domain_id= list[i].domain_id;
     const rpl_gtid *gtid= st->find(gl_domain_id);
     if (!gtid)
     {
@@ -1003,15 +1021,15 @@ contains_all_slave_gtid(slave_connection_state *st, Gtid_list_log_event *glev)
       */
       return false;
     }
-    if (gtid->server_id == glev->list[i].server_id &&
-        gtid->seq_no <= glev->list[i].seq_no)
+    if (gtid->server_id == list[i].server_id &&
+        gtid->seq_no <= list[i].seq_no)
     {
       /*
         The slave needs to start after gtid, but it is contained in an earlier
         binlog file. So we need to search back further, unless it was the very
         last gtid logged for the domain in earlier binlog files.
       */
-      if (gtid->seq_no < glev->list[i].seq_no)
+      if (gtid->seq_no < list[i].seq_no)
         return false;
 
       /*
@@ -1024,7 +1042,7 @@ contains_all_slave_gtid(slave_connection_state *st, Gtid_list_log_event *glev)
         beginning of this group, per the special case explained in comment at
         the start of this function. If not, then we need to search back further.
       */
-      if (i+1 < glev->count && gl_domain_id == glev->list[i+1].domain_id)
+      if (i+1 < count && gl_domain_id == list[i+1].domain_id)
         return false;
     }
   }
@@ -1033,6 +1051,136 @@ contains_all_slave_gtid(slave_connection_state *st, Gtid_list_log_event *glev)
 }
 
 
+/*
+  Find the start position for a slave in the GTID index of a binlog file.
+
+  Looks for the last entry of the index whose binlog state passes
+  contains_all_slave_gtid() for the slave state, that is, the slave already
+  has all event groups logged before the offset of the entry.
+
+  Entries that are incomplete, fail the checksum or point beyond the end of
+  the binlog file end the scan; the index is only an optimisation.
+
+  Returns true if an entry was found. Then *out_list (to be freed with
+  my_free()) and *out_count are the binlog state of the entry, and *out_pos
+  is its offset.
+*/
+static bool
+gtid_index_find_pos(slave_connection_state *state, const char *log_name,
+                    rpl_gtid **out_list, uint32 *out_count, my_off_t *out_pos)
+{
+  char name[FN_REFLEN];
+  uchar magic[BINLOG_GTID_INDEX_MAGIC_LEN];
+  uchar *buf= NULL;
+  size_t buf_size= 0;
+  rpl_gtid *list= NULL, *best_list= NULL;
+  uint32 list_size= 0, best_size= 0, best_count= 0;
+  my_off_t best_pos= 0, log_length;
+  MY_STAT stat;
+  File file;
+  IO_CACHE cache;
+  DBUG_ENTER("gtid_index_find_pos");
+
+  if (!opt_binlog_gtid_index_span || !my_stat(log_name, &stat, MYF(0)))
+    DBUG_RETURN(false);
+  log_length= (my_off_t) stat.st_size;
+  binlog_gtid_index_name(name, log_name);
+  if ((file= mysql_file_open(key_file_binlog_state, name, O_RDONLY|O_BINARY,
+                             MYF(0))) < 0)
+    DBUG_RETURN(false);
+  if (init_io_cache(&cache, file, IO_SIZE*2, READ_CACHE, 0, 0, MYF(MY_WME)))
+  {
+    mysql_file_close(file, MYF(0));
+    DBUG_RETURN(false);
+  }
+
+  if (my_b_read(&cache, magic, sizeof(magic)) ||
+      memcmp(magic, BINLOG_GTID_INDEX_MAGIC, sizeof(magic)))
+    goto end;
+
+  for (;;)
+  {
+    uchar header[BINLOG_GTID_INDEX_HEADER_LEN];
+    size_t length;
+    my_off_t pos;
+    uint32 count, i;
+
+    if (my_b_read(&cache, header, sizeof(header)))
+      break;
+    length= uint4korr(header);
+    pos= uint8korr(header + 4);
+    count= uint4korr(header + 12);
+    if (count >= (1U << 28) ||
+        length != BINLOG_GTID_INDEX_HEADER_LEN +
+                  (size_t) count * BINLOG_GTID_INDEX_GTID_LEN +
+                  BINLOG_GTID_INDEX_CHECKSUM_LEN ||
+        pos > log_length)
+      break;
+
+    if (length > buf_size)
+    {
+      uchar *new_buf;
+      if (!(new_buf= (uchar*) my_realloc(PSI_INSTRUMENT_ME, buf, length,
+                                         MYF(MY_WME|MY_ALLOW_ZERO_PTR))))
+        break;
+      buf= new_buf;
+      buf_size= length;
+    }
+    if (count > list_size)
+    {
+      rpl_gtid *new_list;
+      if (!(new_list= (rpl_gtid*) my_realloc(PSI_INSTRUMENT_ME, list,
+                                             count * sizeof(*list),
+                                             MYF(MY_WME|MY_ALLOW_ZERO_PTR))))
+        break;
+      list= new_list;
+      list_size= count;
+    }
+
+    memcpy(buf, header, sizeof(header));
+    if (my_b_read(&cache, buf + sizeof(header), length - sizeof(header)) ||
+        uint4korr(buf + length - BINLOG_GTID_INDEX_CHECKSUM_LEN) !=
+        my_checksum(0, buf, length - BINLOG_GTID_INDEX_CHECKSUM_LEN))
+      break;
+
+    for (i= 0; i < count; ++i)
+    {
+      const uchar *p= buf + BINLOG_GTID_INDEX_HEADER_LEN +
+                      i * BINLOG_GTID_INDEX_GTID_LEN;
+      list[i].domain_id= uint4korr(p);
+      list[i].server_id= uint4korr(p + 4);
+      list[i].seq_no= uint8korr(p + 8);
+    }
+
+    if (contains_all_slave_gtid(state, list, count))
+    {
+      std::swap(list, best_list);
+      std::swap(list_size, best_size);
+      best_count= count;
+      best_pos= pos;
+    }
+  }
+
+end:
+  end_io_cache(&cache);
+  mysql_file_close(file, MYF(0));
+  my_free(buf);
+  my_free(list);
+
+  if (!best_pos)
+  {
+    my_free(best_list);
+    DBUG_RETURN(false);
+  }
+  DBUG_PRINT("info", ("GTID index of %s gives start position %llu",
+                      log_name, (ulonglong) best_pos));
+  *out_list= best_list;
+  *out_count= best_count;
+  *out_pos= best_pos;
+  DBUG_RETURN(true);
+}
+
+
 static void
 give_error_start_pos_missing_in_binlog(int *err, const char **errormsg,
                                        rpl_gtid *error_gtid)
@@ -1276,14 +1424,20 @@ check_slave_start_position(binlog_send_info *info, const char **errormsg,
   corresponding entry in the slave state so we do not wrongly skip any events
   that might turn up if that domain becomes active again, vainly looking for
   the requested GTID that was already purged.
+
+  The start position in the file is returned in *out_pos. It is after the
+  start of the file if the GTID index of the file shows that the slave
+  already has the event groups before it.
 */
 static const char *
 gtid_find_binlog_file(slave_connection_state *state, char *out_name,
+                      my_off_t *out_pos,
                       slave_connection_state *until_gtid_state)
 {
   MEM_ROOT memroot;
   binlog_file_entry *list;
   Gtid_list_log_event *glev= NULL;
+  rpl_gtid *index_list= NULL;
   const char *errormsg= NULL;
   char buf[FN_REFLEN];
 
@@ -1330,14 +1484,26 @@ gtid_find_binlog_file(slave_connection_state *state, char *out_name,
     if (unlikely(errormsg))
       goto end;
 
-    if (!glev || contains_all_slave_gtid(state, glev))
+    if (!glev || contains_all_slave_gtid(state, glev->list, glev->count))
     {
       strmake(out_name, buf, FN_REFLEN);
 
       if (glev)
       {
+        const rpl_gtid *list= glev->list;
+        uint32 count= glev->count;
         uint32 i;
 
+        /*
+          The GTID index of the file may allow to skip the part of it that
+          the slave already has. Then the binlog state at that position takes
+          the place of the Gtid_list_log_event below. With UNTIL, the slave
+          needs the Gtid_list_log_event at the start of the file.
+        */
+        if (!until_gtid_state &&
+            gtid_index_find_pos(state, buf, &index_list, &count, out_pos))
+          list= index_list;
+
         /*
           As a special case, we allow to start from binlog file N if the
           requested GTID is the last event (in the corresponding domain) in
@@ -1349,9 +1515,9 @@ gtid_find_binlog_file(slave_connection_state *state, char *out_name,
           from the UNTIL hash, to mark that such domains have already reached
           their UNTIL condition.
         */
-        for (i= 0; i < glev->count; ++i)
+        for (i= 0; i < count; ++i)
         {
-          const rpl_gtid *gtid= state->find(glev->list[i].domain_id);
+          const rpl_gtid *gtid= state->find(list[i].domain_id);
           if (!gtid)
           {
             /*
@@ -1364,8 +1530,8 @@ gtid_find_binlog_file(slave_connection_state *state, char *out_name,
               further GTIDs in the Gtid_list.
             */
             DBUG_ASSERT(0);
-          } else if (gtid->server_id == glev->list[i].server_id &&
-                     gtid->seq_no == glev->list[i].seq_no)
+          } else if (gtid->server_id == list[i].server_id &&
+                     gtid->seq_no == list[i].seq_no)
           {
             /*
               The slave requested to start from the very beginning of this
@@ -1376,9 +1542,9 @@ gtid_find_binlog_file(slave_connection_state *state, char *out_name,
           }
 
           if (until_gtid_state &&
-              (gtid= until_gtid_state->find(glev->list[i].domain_id)) &&
-              gtid->server_id == glev->list[i].server_id &&
-              gtid->seq_no <= glev->list[i].seq_no)
+              (gtid= until_gtid_state->find(list[i].domain_id)) &&
+              gtid->server_id == list[i].server_id &&
+              gtid->seq_no <= list[i].seq_no)
           {
             /*
               We've already reached the stop position in UNTIL for this domain,
@@ -1404,6 +1570,7 @@ gtid_find_binlog_file(slave_connection_state *state, char *out_name,
 end:
   if (glev)
     delete glev;
+  my_free(index_list);
 
   free_root(&memroot, MYF(0));
   return errormsg;
@@ -2176,16 +2343,15 @@ static int init_binlog_sender(binlog_send_info *info,
       info->error= error;
       return 1;
     }
+    /* start from beginning of binlog file, unless the GTID index helps */
+    *pos= BIN_LOG_HEADER_SIZE;
     if ((info->errmsg= gtid_find_binlog_file(&info->gtid_state,
-                                             search_file_name,
+                                             search_file_name, pos,
                                              info->until_gtid_state)))
     {
       info->error= ER_MASTER_FATAL_ERROR_READING_BINLOG;
       return 1;
     }
-
-    /* start from beginning of binlog file */
-    *pos = 4;
   }
   else
   {
@@ -2637,6 +2803,291 @@ static my_off_t get_binlog_end_pos(binlog_send_info *info,
   return 0;
 }
 
+#ifdef HAVE_SYS_SENDFILE_H
+/** Maximum number of events that are sent by one writev() */
+static const uint ZERO_COPY_MAX_EVENTS= 64;
+/** Size of the buffer that the events sent by writev() are read into */
+static const size_t ZERO_COPY_BUF_SIZE= 128 * 1024;
+/** Events of this size or larger are sent by sendfile() */
+static const size_t ZERO_COPY_SENDFILE_MIN= 16 * 1024;
+/** Length of the network packet header and the OK byte before an event */
+static const size_t ZERO_COPY_HEADER_LEN= NET_HEADER_SIZE + 1;
+
+/**
+  Check if events can be sent to the slave as they are in the binlog file,
+  without reading them into the transmit packet.
+
+  This is not the case when the events are verified or decrypted, when the
+  connection is compressed or encrypted, when the slave uses semi-sync
+  (the events are preceded by the semi-sync header), or when events are
+  skipped until the GTID position of the slave or after the GTID of
+  START SLAVE UNTIL. Slaves that do not understand GTID get some events
+  rewritten.
+*/
+static bool can_send_zero_copy(binlog_send_info *info, IO_CACHE *log)
+{
+  const Vio *vio= info->net->vio;
+
+#ifndef DBUG_OFF
+  if (info->dbug_reconnect_counter ||
+      DBUG_EVALUATE_IF("dump_thread_wait_before_send_xid", true, false) ||
+      DBUG_EVALUATE_IF("crash_before_send_xid", true, false) ||
+      DBUG_EVALUATE_IF("corrupt_read_log_event2", true, false))
+    return false;
+#endif
+
+  return opt_binlog_dump_zero_copy &&
+    !opt_master_verify_checksum &&
+    !info->net->compress &&
+    (vio->type == VIO_TYPE_TCPIP || vio->type == VIO_TYPE_SOCKET) &&
+    !info->thd->semi_sync_slave &&
+    !info->fdev->crypto_data.scheme &&
+    info->mariadb_slave_capability >= MARIA_SLAVE_CAPABILITY_GTID &&
+    !(info->using_gtid_state && info->gtid_state.count()) &&
+    !info->until_gtid_state &&
+    info->gtid_skip_group == GTID_SKIP_NOT &&
+    !info->send_fake_gtid_list &&
+    log->file >= 0;
+}
+
+/**
+  Check if send_event_to_slave() would send an event unchanged, given that
+  can_send_zero_copy() holds.
+
+  @param header  header of the event in the binlog file
+*/
+static bool can_send_event_zero_copy(binlog_send_info *info,
+                                     const uchar *header)
+{
+  switch (header[EVENT_TYPE_OFFSET]) {
+  case START_ENCRYPTION_EVENT:
+  case LOAD_EVENT:
+    return false;
+  case ANNOTATE_ROWS_EVENT:
+    if (!(info->flags & BINLOG_SEND_ANNOTATE_ROWS_EVENT))
+      return false;
+    break;
+  }
+
+  return !(info->thd->variables.option_bits & OPTION_SKIP_REPLICATION) ||
+    !(uint2korr(header + FLAGS_OFFSET) & LOG_EVENT_SKIP_REPLICATION_F);
+}
+
+/**
+  Wait until the slave connection can be written to.
+
+  @return whether the connection failed or the write timeout expired
+*/
+static bool zero_copy_wait(binlog_send_info *info)
+{
+  return vio_io_wait(info->net->vio, VIO_IO_EVENT_WRITE,
+                     info->net->vio->write_timeout) <= 0;
+}
+
+/**
+  Write buffers to the slave connection, which must be non-blocking.
+
+  @return whether the write failed
+*/
+static bool zero_copy_writev(binlog_send_info *info, struct iovec *iov,
+                             int iovcnt)
+{
+  const my_socket fd= vio_fd(info->net->vio);
+
+  while (iovcnt)
+  {
+    ssize_t n= writev(fd, iov, iovcnt);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      if ((errno != EAGAIN && errno != EWOULDBLOCK) || zero_copy_wait(info))
+        return true;
+      continue;
+    }
+    thd_increment_bytes_sent(info->thd, n);
+    for (; iovcnt && (size_t) n >= iov->iov_len; iov++, iovcnt--)
+      n-= iov->iov_len;
+    if (iovcnt)
+    {
+      iov->iov_base= (char*) iov->iov_base + n;
+      iov->iov_len-= n;
+    }
+  }
+
+  return false;
+}
+
+/**
+  Send a part of the binlog file to the slave connection, which must be
+  non-blocking, without copying it to user space.
+
+  @return whether the write failed
+*/
+static bool zero_copy_sendfile(binlog_send_info *info, File file,
+                               my_off_t pos, size_t len)
+{
+  const my_socket fd= vio_fd(info->net->vio);
+  off_t offset= (off_t) pos;
+
+  while (len)
+  {
+    ssize_t n= sendfile(fd, file, &offset, len);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      if ((errno != EAGAIN && errno != EWOULDBLOCK) || zero_copy_wait(info))
+        return true;
+      continue;
+    }
+    if (!n)
+      return true;                              // the file was truncated
+    thd_increment_bytes_sent(info->thd, n);
+    len-= n;
+  }
+
+  return false;
+}
+
+/**
+  Send events from the current position of the binlog file as they are
+  in the file, each one in a network packet of its own.
+
+  Events are read into zero_copy_buf, from mysql_bin_log.dump_cache if
+  they are still there, and sent with their packet headers
+  by one writev(). An event of ZERO_COPY_SENDFILE_MIN bytes or more is
+  sent by sendfile() directly from the binlog file. The events are sent
+  up to the first one that send_event_to_slave() would skip or rewrite;
+  the caller sends that one.
+
+  @return number of events that were sent
+  @retval -1 on error
+*/
+static int send_events_zero_copy(binlog_send_info *info, IO_CACHE *log,
+                                 LOG_INFO *linfo, my_off_t end_pos)
+{
+  NET *net= info->net;
+  const my_off_t pos= linfo->pos;
+  uchar header[ZERO_COPY_MAX_EVENTS][ZERO_COPY_HEADER_LEN];
+  struct iovec iov[2 * ZERO_COPY_MAX_EVENTS];
+
+  if (!info->zero_copy_buf &&
+      !(info->zero_copy_buf= (uchar*) my_malloc(PSI_INSTRUMENT_ME,
+                                                ZERO_COPY_BUF_SIZE, MYF(0))))
+    return 0;
+
+  /* Reuse what was read before if the first event is in the buffer. */
+  my_off_t buf_end= info->zero_copy_pos + info->zero_copy_len;
+  bool in_buf= pos >= info->zero_copy_pos &&
+    pos + LOG_EVENT_MINIMAL_HEADER_LEN <= buf_end;
+  if (in_buf)
+  {
+    size_t ev_len= uint4korr(info->zero_copy_buf + (pos - info->zero_copy_pos)
+                             + EVENT_LEN_OFFSET);
+    in_buf= ev_len >= ZERO_COPY_SENDFILE_MIN || pos + ev_len <= buf_end;
+  }
+  if (!in_buf)
+  {
+    size_t len= (size_t) MY_MIN(end_pos - pos, ZERO_COPY_BUF_SIZE);
+    info->zero_copy_len= 0;
+    /*
+      A slave that is caught up gets the events from the copy that the
+      binlog writer keeps in memory. On a read error, let read_log_event()
+      report it.
+    */
+    if (mysql_bin_log.dump_cache.read(linfo->log_file_name, pos,
+                                      info->zero_copy_buf, len) &&
+        my_pread(log->file, info->zero_copy_buf, len, pos, MYF(0)) != len)
+      return 0;
+    info->zero_copy_pos= pos;
+    info->zero_copy_len= len;
+    buf_end= pos + len;
+  }
+
+  const uchar *buf= info->zero_copy_buf + (pos - info->zero_copy_pos);
+  const size_t len= (size_t) (buf_end - pos);
+  size_t batch_len= 0, sendfile_len= 0, last_len= 0;
+  uint n;
+
+  for (n= 0; n < ZERO_COPY_MAX_EVENTS; n++)
+  {
+    if (batch_len + LOG_EVENT_MINIMAL_HEADER_LEN > len)
+      break;
+    const uchar *ev= buf + batch_len;
+    const size_t ev_len= uint4korr(ev + EVENT_LEN_OFFSET);
+    /* Leave corrupted events and events of several packets to the caller. */
+    if (ev_len < LOG_EVENT_MINIMAL_HEADER_LEN ||
+        ev_len + 1 >= MAX_PACKET_LENGTH ||
+        pos + batch_len + ev_len > end_pos ||
+        !can_send_event_zero_copy(info, ev))
+      break;
+    if (ev_len >= ZERO_COPY_SENDFILE_MIN || batch_len + ev_len > len)
+    {
+      /* A large event is sent on its own, by sendfile(). */
+      if (!n && ev_len >= ZERO_COPY_SENDFILE_MIN)
+        sendfile_len= ev_len;
+      break;
+    }
+    int3store(header[n], ev_len + 1);
+    header[n][3]= (uchar) net->pkt_nr++;
+    header[n][4]= 0;
+    iov[2 * n].iov_base= header[n];
+    iov[2 * n].iov_len= ZERO_COPY_HEADER_LEN;
+    iov[2 * n + 1].iov_base= (void*) ev;
+    iov[2 * n + 1].iov_len= ev_len;
+    last_len= ev_len;
+    batch_len+= ev_len;
+  }
+
+  if (sendfile_len)
+  {
+    int3store(header[0], sendfile_len + 1);
+    header[0][3]= (uchar) net->pkt_nr++;
+    header[0][4]= 0;
+    iov[0].iov_base= header[0];
+    iov[0].iov_len= ZERO_COPY_HEADER_LEN;
+    last_len= batch_len= sendfile_len;
+    n= 1;
+  }
+  else if (!n)
+    return 0;
+
+  THD_STAGE_INFO(info->thd, stage_sending_binlog_event_to_slave);
+
+  /* The packets that were written before must go first. */
+  bool failed= net_flush(net);
+  if (!failed)
+  {
+    my_bool old_mode, not_used;
+    if (vio_blocking(net->vio, FALSE, &old_mode))
+      failed= true;
+    else
+    {
+      failed= sendfile_len
+        ? (zero_copy_writev(info, iov, 1) ||
+           zero_copy_sendfile(info, log->file, pos, sendfile_len))
+        : zero_copy_writev(info, iov, 2 * n);
+      vio_blocking(net->vio, old_mode, &not_used);
+    }
+  }
+
+  if (failed)
+  {
+    net->error= 2;
+    net->last_errno= ER_NET_ERROR_ON_WRITE;
+    info->error= ER_UNKNOWN_ERROR;
+    info->errmsg= "Failed on writing events to the slave connection";
+    return -1;
+  }
+
+  info->last_pos= pos + batch_len - last_len;
+  linfo->pos= pos + batch_len;
+  my_b_seek(log, linfo->pos);
+  return (int) n;
+}
+#endif /* HAVE_SYS_SENDFILE_H */
+
 /**
  * This function sends events from one binlog file
  * but only up until end_pos
@@ -2660,6 +3111,17 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
     if (should_stop(info))
       return 0;
 
+#ifdef HAVE_SYS_SENDFILE_H
+    if (can_send_zero_copy(info, log))
+    {
+      int n= send_events_zero_copy(info, log, linfo, end_pos);
+      if (n < 0)
+        return 1;
+      if (n)
+        continue;
+    }
+#endif
+
     /* reset the transmit packet for the event read from binary log
        file */
     if (reset_transmit_packet(info, info->flags, &ev_offset, &info->errmsg))
@@ -2776,6 +3238,8 @@ static int send_one_binlog_file(binlog_send_info *info,
 {
   mysql_mutex_assert_not_owner(mysql_bin_log.get_log_lock());
 
+  info->zero_copy_len= 0;
+
   /* seek to the requested position, to start the requested dump */
   if (start_pos != BIN_LOG_HEADER_SIZE)
   {
@@ -2989,6 +3453,7 @@ void mysql_binlog_send(THD* thd, char* log_ident, my_off_t pos,
   thd->reset_current_linfo();
   thd->variables.max_allowed_packet= old_max_allowed_packet;
   delete info->fdev;
+  my_free(info->zero_copy_buf);
 
   if (likely(info->error == 0))
   {
@@ -64,6 +64,7 @@
 #include "sp_head.h"
 #include "sp_rcontext.h"
 #include "rowid_filter.h"
+#include "batch_filter.h"
 #include "select_handler.h"
 #include "my_json_writer.h"
 #include "opt_trace.h"
@@ -1766,6 +1767,95 @@ JOIN::init_range_rowid_filters()
 }
 
 
+/**
+  @brief
+    Create the batch filter for the scan of the first table of the plan
+
+  @details
+    If the first non-constant table of the chosen execution plan is scanned
+    and the condition pushed to the table contains conjuncts that can be
+    checked by a batch filter (see batch_filter.h) the function creates such
+    a filter for the table.
+    As the records of the table are read ahead by batches the filter is not
+    used when the scan can be stopped before all records have been read,
+    when the scan locks the records or when the position of the current
+    record in the table is used.
+
+  @retval false  always
+*/
+
+bool
+JOIN::make_batch_filters()
+{
+  DBUG_ENTER("make_batch_filters");
+
+  if (top_join_tab_count == const_tables ||
+      !optimizer_flag(thd, OPTIMIZER_SWITCH_BATCH_FILTER))
+    DBUG_RETURN(0);
+
+  JOIN_TAB *tab= join_tab + const_tables;
+  TABLE *table= tab->table;
+  thr_lock_type lock_type= table->reginfo.lock_type;
+
+  if (tab->type != JT_ALL || tab->use_quick == 2 ||
+      (tab->select && tab->select->quick) || tab->bush_children ||
+      tab->filesort || tab->keep_current_rowid ||
+      tab->loosescan_match_tab || tab->do_firstmatch ||
+      tab->shortcut_for_distinct || tab->first_inner || tab->last_inner ||
+      unit->lim.get_select_limit() != HA_POS_ERROR ||
+      (lock_type != TL_READ && lock_type != TL_READ_HIGH_PRIORITY &&
+       lock_type != TL_READ_NO_INSERT))
+    DBUG_RETURN(0);
+
+  if (tab->tab_list &&
+      (tab->tab_list->is_sjm_scan_table() ||
+       tab->tab_list->is_with_table_recursive_reference()))
+    DBUG_RETURN(0);
+
+  /* The values of BLOBs are not stored in the record buffer */
+  for (uint i= 0; i < table->s->blob_fields; i++)
+  {
+    if (bitmap_is_set(table->read_set, table->s->blob_field[i]))
+      DBUG_RETURN(0);
+  }
+
+  tab->batch_filter= Batch_filter::create(thd, tab);
+  DBUG_RETURN(0);
+}
+
+/**
+  @brief
+    Pass the expected numbers of rows read by table accesses to the engines
+
+  @details
+    For each table of the chosen execution plan the function informs the
+    handler of the table how many rows the optimizer expects one scan of
+    the table to read, so that the engine could choose the size of its
+    read-ahead buffers accordingly. When the execution of the query can be
+    stopped by LIMIT the estimate is not reliable and 0 ('unknown') is
+    passed instead.
+*/
+
+void
+JOIN::set_estimation_rows_to_read()
+{
+  bool has_limit= unit->lim.get_select_limit() != HA_POS_ERROR;
+  DBUG_ENTER("set_estimation_rows_to_read");
+
+  for (JOIN_TAB *tab= first_linear_tab(this, WITH_BUSH_ROOTS,
+                                       WITHOUT_CONST_TABLES);
+       tab;
+       tab= next_linear_tab(this, tab, WITH_BUSH_ROOTS))
+  {
+    if (tab->bush_children || !tab->table)
+      continue;
+    tab->table->file->set_estimation_rows_to_read(has_limit ? 0 :
+                                                  tab->get_examined_rows());
+  }
+  DBUG_VOID_RETURN;
+}
+
+
 /**
   global select optimisation.
 
@@ -2993,6 +3083,12 @@ int JOIN::optimize_stage2()
   if (init_range_rowid_filters())
     DBUG_RETURN(1);
 
+  if (!(select_options & SELECT_DESCRIBE) && make_batch_filters())
+    DBUG_RETURN(1);
+
+  if (!(select_options & SELECT_DESCRIBE))
+    set_estimation_rows_to_read();
+
   error= 0;
 
   if (select_options & SELECT_DESCRIBE)
@@ -7894,7 +7990,34 @@ best_access_path(JOIN      *join,
     double refills= (1.0 + floor((double) cache_record_length(join,idx) *
                            record_count /
 			   (double) thd->variables.join_buff_size));
+    double scan_time= tmp;
     tmp= COST_MULT(tmp, refills);
+    /*
+      If the join buffer becomes full more than once, the records of
+      both join operands can be distributed over partitions on disk
+      instead, and the table is read only once then (see
+      JOIN_CACHE_BNLH::put_record). Each partition is written once and
+      read back, and a partition that does not fit into the join buffer
+      makes the matching partition of the table be read more than once.
+    */
+    if (refills > 1.0 &&
+        optimizer_flag(thd, OPTIMIZER_SWITCH_JOIN_CACHE_HASHED_SPILL) &&
+        !s->emb_sj_nest && !(s->table->map & join->outer_join) &&
+        !s->table->s->blob_fields)
+    {
+      double spill_blocks= ((double) cache_record_length(join,idx) *
+                            record_count +
+                            (double) s->table->s->reclength * rnd_records) /
+                           IO_SIZE;
+      double passes= ceil(refills / JOIN_CACHE_SPILL_PARTITIONS);
+      double spill_time= COST_ADD(scan_time,
+                                  COST_MULT(spill_blocks, 1.0 + passes));
+      if (spill_time < tmp)
+      {
+        tmp= spill_time;
+        trace_access_hash.add("spill", true);
+      }
+    }
     best_time= COST_ADD(tmp,
                         COST_MULT((record_count*join_sel) / TIME_FOR_COMPARE,
                                   rnd_records));
@@ -13431,6 +13554,7 @@ void JOIN_TAB::cleanup()
     delete rowid_filter;
     rowid_filter= 0;
   }
+  batch_filter= 0;
   if (cache)
   {
     cache->free();
@@ -18635,10 +18759,13 @@ bool Create_tmp_table::finalize(THD *thd,
   DBUG_ASSERT(m_alloced_field_count >= share->fields);
   DBUG_ASSERT(m_alloced_field_count >= share->blob_fields);
 
-  /* If result table is small; use a heap */
+  /*
+    If result table is small; use a heap. MEMORY tables store blobs and
+    implement the unique constraint with a hash key over the whole data
+    of the blobs.
+  */
   /* future: storage engine selection can be made dynamic? */
-  if (share->blob_fields || m_using_unique_constraint
-      || (thd->variables.big_tables && !(m_select_options & SELECT_SMALL_RESULT))
+  if ((thd->variables.big_tables && !(m_select_options & SELECT_SMALL_RESULT))
       || (m_select_options & TMP_TABLE_FORCE_MYISAM)
       || thd->variables.tmp_memory_table_size == 0)
   {
@@ -18850,6 +18977,8 @@ bool Create_tmp_table::finalize(THD *thd,
     share->keys_in_use.set_bit(0);
     keyinfo->key_part= m_key_part_info;
     keyinfo->flags=HA_NOSAME | HA_BINARY_PACK_KEY | HA_PACK_KEY;
+    if (m_using_unique_constraint)
+      keyinfo->flags|= HA_NULL_ARE_EQUAL;       // One group for NULL
     keyinfo->ext_key_flags= keyinfo->flags;
     keyinfo->usable_key_parts=keyinfo->user_defined_key_parts= param->group_parts;
     keyinfo->ext_key_parts= keyinfo->user_defined_key_parts;
@@ -21576,6 +21705,11 @@ int join_init_read_record(JOIN_TAB *tab)
                                              tab->read_record.read_record_func;
     tab->read_record.read_record_func = read_record_func_for_rr_and_unpack;
   }
+  else if (tab->batch_filter && !tab->filesort)
+  {
+    tab->batch_filter->init_read(&tab->read_record);
+    status_var_increment(tab->join->thd->status_var.select_batch_filter_count);
+  }
 
   return tab->read_record.read_record();
 }
@@ -22188,6 +22322,21 @@ end_unique_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 
   if (likely(!(error= table->file->ha_write_tmp_row(table->record[0]))))
     join_tab->send_records++;			// New group
+  else if (table->file->is_fatal_error(error, HA_CHECK_DUP))
+  {
+    /* A MEMORY table with a unique constraint became full */
+    if (create_internal_tmp_table_from_heap(join->thd, table,
+                                       join_tab->tmp_table_param->start_recinfo,
+                                            &join_tab->tmp_table_param->recinfo,
+                                            error, 0, NULL))
+      DBUG_RETURN(NESTED_LOOP_ERROR);            // Not a table_is_full error
+    if (unlikely((error= table->file->ha_rnd_init(0))))
+    {
+      table->file->print_error(error, MYF(0));
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    }
+    join_tab->send_records++;
+  }
   else
   {
     if (unlikely((int) table->file->get_dup_key(error) < 0))
@@ -22963,7 +23112,8 @@ uint find_shortest_key(TABLE *table, const key_map *usable_keys)
     {
       if (usable_keys->is_set(nr))
       {
-        double cost= table->file->keyread_time(nr, 1, table->file->records());
+        double cost= table->file->keyread_time(nr, 1,
+                                                 table->file->stats.records);
         if (cost < min_cost)
         {
           min_cost= cost;
@@ -23986,8 +24136,8 @@ JOIN_TAB::remove_duplicates()
     thd->reset_killed();
 
   table->file->info(HA_STATUS_VARIABLE);
-  if (table->s->db_type() == heap_hton ||
-      (!table->s->blob_fields &&
+  if (!table->s->blob_fields &&
+      (table->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(keylength) + HASH_OVERHEAD) * table->file->stats.records <
 	thd->variables.sortbuff_size)))
     error=remove_dup_with_hash_index(join->thd, table, field_count, first_field,
@@ -523,6 +523,8 @@ typedef struct st_join_table {
   Rowid_filter *rowid_filter;
   /* Becomes true just after the used range filter has been built / filled */
   bool is_rowid_filter_built;
+  /* Filter applied to batches of records when scanning this table */
+  Batch_filter *batch_filter;
 
   void build_range_rowid_filter_if_needed();
 
@@ -1646,6 +1648,8 @@ class JOIN :public Sql_alloc
   bool optimize_constant_subqueries();
   bool make_range_rowid_filters();
   bool init_range_rowid_filters();
+  bool make_batch_filters();
+  void set_estimation_rows_to_read();
   bool make_sum_func_list(List<Item> &all_fields, List<Item> &send_fields,
 			  bool before_group_by, bool recompute= FALSE);
 
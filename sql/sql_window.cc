@@ -1091,6 +1091,23 @@ class Frame_cursor : public Sql_alloc
   /* Retrieves the row number that this cursor currently points at. */
   virtual ha_rows get_curr_rownum() const= 0;
 
+  /*
+    Whether the cursor can do its job looking only at the current row of the
+    table, plus whatever rows it keeps in memory itself. Such a cursor never
+    repositions the table, so the window function can be computed in one
+    pass over the sorted rows.
+  */
+  virtual bool supports_streaming(TABLE *table) const { return false; }
+
+  /*
+    Switch the cursor to streaming mode. Called before init(), and only if
+    supports_streaming() is true for every cursor of the window functions
+    being computed.
+
+    @return true on out-of-memory error
+  */
+  virtual bool start_streaming(TABLE *table) { return false; }
+
 protected:
   inline void add_value_to_items()
   {
@@ -1155,6 +1172,30 @@ class Cursor_manager
       fc->init(info);
   }
 
+  bool supports_streaming(TABLE *table)
+  {
+    List_iterator_fast<Frame_cursor> iter(cursors);
+    Frame_cursor *fc;
+    while ((fc= iter++))
+    {
+      if (!fc->supports_streaming(table))
+        return false;
+    }
+    return true;
+  }
+
+  bool start_streaming(TABLE *table)
+  {
+    List_iterator_fast<Frame_cursor> iter(cursors);
+    Frame_cursor *fc;
+    while ((fc= iter++))
+    {
+      if (fc->start_streaming(table))
+        return true;
+    }
+    return false;
+  }
+
   void notify_cursors_partition_changed(ha_rows rownum)
   {
     List_iterator_fast<Frame_cursor> iter(cursors);
@@ -1692,6 +1733,8 @@ class Frame_unbounded_preceding : public Frame_cursor
     return curr_rownum;
   }
 
+  bool supports_streaming(TABLE *table) const { return true; }
+
 private:
   ha_rows curr_rownum;
 };
@@ -1837,14 +1880,52 @@ class Frame_n_rows_preceding : public Frame_cursor
   ha_rows n_rows_behind;
 
   Table_read_cursor cursor;
+
+  /*
+    In streaming mode the bound doesn't use the cursor. Instead, the last
+    n_rows + 2 rows are kept in a ring buffer: that covers the current row
+    and the row that enters (bottom bound) or leaves (top bound) the frame.
+  */
+  TABLE *table;
+  uchar *row_buffer;
+  ha_rows row_buffer_rows;
+  ha_rows curr_rownum;
+  ha_rows bound_rownum;
 public:
   Frame_n_rows_preceding(bool is_top_bound_arg, ha_rows n_rows_arg) :
-    is_top_bound(is_top_bound_arg), n_rows(n_rows_arg), n_rows_behind(0)
+    is_top_bound(is_top_bound_arg), n_rows(n_rows_arg), n_rows_behind(0),
+    table(NULL), row_buffer(NULL)
   {}
 
+  ~Frame_n_rows_preceding()
+  {
+    my_free(row_buffer);
+  }
+
+  bool supports_streaming(TABLE *table_arg) const
+  {
+    /* Blob values of a buffered row do not survive reading other rows. */
+    if (table_arg->s->blob_fields)
+      return false;
+    return n_rows + 2 <= table_arg->in_use->variables.sortbuff_size /
+                         table_arg->s->reclength;
+  }
+
+  bool start_streaming(TABLE *table_arg)
+  {
+    table= table_arg;
+    row_buffer_rows= n_rows + 2;
+    row_buffer= (uchar*) my_malloc(PSI_INSTRUMENT_ME,
+                                   (size_t) row_buffer_rows *
+                                   table->s->reclength,
+                                   MYF(MY_WME | MY_THREAD_SPECIFIC));
+    return row_buffer == NULL;
+  }
+
   void init(READ_RECORD *info)
   {
-    cursor.init(info);
+    if (!row_buffer)
+      cursor.init(info);
   }
 
   void next_partition(ha_rows rownum)
@@ -1853,7 +1934,13 @@ class Frame_n_rows_preceding : public Frame_cursor
       Position our cursor to point at the first row in the new partition
       (for rownum=0, it is already there, otherwise, it lags behind)
     */
-    cursor.move_to(rownum);
+    if (row_buffer)
+    {
+      curr_rownum= bound_rownum= rownum;
+      save_current_row();
+    }
+    else
+      cursor.move_to(rownum);
     /* Cursor is in the same spot as current row. */
     n_rows_behind= 0;
 
@@ -1875,6 +1962,11 @@ class Frame_n_rows_preceding : public Frame_cursor
 
   void next_row()
   {
+    if (row_buffer)
+    {
+      curr_rownum++;
+      save_current_row();
+    }
     n_rows_behind++;
     move_cursor_if_possible();
   }
@@ -1889,7 +1981,7 @@ class Frame_n_rows_preceding : public Frame_cursor
 
   ha_rows get_curr_rownum() const
   {
-    return cursor.get_rownum();
+    return row_buffer ? bound_rownum : cursor.get_rownum();
   }
 
 private:
@@ -1904,8 +1996,9 @@ class Frame_n_rows_preceding : public Frame_cursor
     {
       if (!is_top_bound)
       {
-        cursor.fetch();
+        fetch_bound_row();
         add_value_to_items();
+        restore_current_row();
       }
       /* For top bound we don't have to remove anything as nothing was added. */
       return;
@@ -1916,19 +2009,60 @@ class Frame_n_rows_preceding : public Frame_cursor
 
     if (is_top_bound)
     {
-      cursor.fetch();
+      fetch_bound_row();
       remove_value_from_items();
-      cursor.next();
+      restore_current_row();
+      next_bound_row();
     }
     else
     {
-      cursor.next();
-      cursor.fetch();
+      next_bound_row();
+      fetch_bound_row();
       add_value_to_items();
+      restore_current_row();
     }
     /* We've advanced one row. We are no longer behind. */
     n_rows_behind--;
   }
+
+  uchar *buffered_row(ha_rows rownum)
+  {
+    return row_buffer + (size_t) (rownum % row_buffer_rows) *
+                        table->s->reclength;
+  }
+
+  void save_current_row()
+  {
+    memcpy(buffered_row(curr_rownum), table->record[0], table->s->reclength);
+  }
+
+  void fetch_bound_row()
+  {
+    if (row_buffer)
+      memcpy(table->record[0], buffered_row(bound_rownum),
+             table->s->reclength);
+    else
+      cursor.fetch();
+  }
+
+  void next_bound_row()
+  {
+    if (row_buffer)
+      bound_rownum++;
+    else
+      cursor.next();
+  }
+
+  /*
+    In streaming mode the other cursors expect to find the current row in
+    the record buffer. Otherwise, compute_window_func() re-reads it.
+  */
+  void restore_current_row()
+  {
+    if (row_buffer)
+      memcpy(table->record[0], buffered_row(curr_rownum),
+             table->s->reclength);
+  }
 };
 
 
@@ -1969,6 +2103,8 @@ class Frame_rows_current_row_bottom : public Frame_cursor
     return curr_rownum;
   }
 
+  bool supports_streaming(TABLE *table) const { return true; }
+
 private:
   ha_rows curr_rownum;
 };
@@ -2604,6 +2740,20 @@ static bool is_computed_with_remove(Item_sum::Sumfunctype sum_func)
       return true;
   }
 }
+/*
+  Check if the window frame of the spec starts at the first row of the
+  partition. Without a frame clause, the frame is either the whole partition
+  or RANGE BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW.
+*/
+static bool is_frame_start_unbounded(Window_spec *spec)
+{
+  Window_frame *frame= spec->window_frame;
+  if (!frame)
+    return true;
+  return frame->top_bound->precedence_type == Window_frame_bound::PRECEDING &&
+         frame->top_bound->is_unbounded();
+}
+
 /*
    Create required frame cursors for the list of window functions.
    Register all functions to their appropriate cursors.
@@ -2682,8 +2832,13 @@ void get_window_functions_required_cursors(
     */
     cursor_manager->add_cursor(frame_bottom);
     cursor_manager->add_cursor(frame_top);
+    /*
+       A frame that starts at the partition start only grows, so its sum
+       function never has values removed and needs no rescanning.
+    */
     if (is_computed_with_remove(sum_func->sum_func()) &&
-        !sum_func->supports_removal())
+        !sum_func->supports_removal() &&
+        !is_frame_start_unbounded(item_win_func->window_spec))
     {
       frame_bottom->set_no_action();
       frame_top->set_no_action();
@@ -2700,6 +2855,9 @@ void get_window_functions_required_cursors(
 /**
   Helper function that takes a list of window functions and writes
   their values in the current table record.
+
+  @param rowid_buf  rowid of the current row, or NULL if the table is still
+                    positioned at it
 */
 static
 bool save_window_function_values(List<Item_window_func>& window_functions,
@@ -2707,7 +2865,8 @@ bool save_window_function_values(List<Item_window_func>& window_functions,
 {
   List_iterator_fast<Item_window_func> iter(window_functions);
   JOIN_TAB *join_tab= tbl->reginfo.join_tab;
-  tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
+  if (rowid_buf)
+    tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
   store_record(tbl, record[1]);
   while (Item_window_func *item_win= iter++)
     item_win->save_in_field(item_win->result_field, true);
@@ -2793,12 +2952,37 @@ bool compute_window_func(THD *thd,
   uint err;
 
   READ_RECORD info;
+  Cursor_manager *cursor_manager;
+
+  /*
+    If all cursors can work off the current row, the table is only read
+    sequentially: there is no need to re-read the current row after the
+    cursors have been notified, or before the values are saved into it.
+  */
+  bool streaming= true;
+  while ((cursor_manager= iter_cursor_managers++))
+  {
+    if (!cursor_manager->supports_streaming(tbl))
+    {
+      streaming= false;
+      break;
+    }
+  }
+  iter_cursor_managers.rewind();
+  if (streaming)
+  {
+    while ((cursor_manager= iter_cursor_managers++))
+    {
+      if (cursor_manager->start_streaming(tbl))
+        return true;
+    }
+    iter_cursor_managers.rewind();
+  }
 
   if (init_read_record(&info, current_thd, tbl, NULL/*select*/, filesort_result,
                        0, 1, FALSE))
     return true;
 
-  Cursor_manager *cursor_manager;
   while ((cursor_manager= iter_cursor_managers++))
     cursor_manager->initialize_cursors(&info);
 
@@ -2816,7 +3000,8 @@ bool compute_window_func(THD *thd,
 
   List_iterator_fast<Group_bound_tracker> iter_part_trackers(partition_trackers);
   ha_rows rownum= 0;
-  uchar *rowid_buf= (uchar*) my_malloc(PSI_INSTRUMENT_ME, tbl->file->ref_length, MYF(0));
+  uchar *rowid_buf= streaming ? NULL :
+    (uchar*) my_malloc(PSI_INSTRUMENT_ME, tbl->file->ref_length, MYF(0));
 
   while (true)
   {
@@ -2825,8 +3010,11 @@ bool compute_window_func(THD *thd,
 
     /* Remember current row so that we can restore it before computing
        each window function. */
-    tbl->file->position(tbl->record[0]);
-    memcpy(rowid_buf, tbl->file->ref, tbl->file->ref_length);
+    if (!streaming)
+    {
+      tbl->file->position(tbl->record[0]);
+      memcpy(rowid_buf, tbl->file->ref, tbl->file->ref_length);
+    }
 
     iter_win_funcs.rewind();
     iter_part_trackers.rewind();
@@ -2857,7 +3045,8 @@ bool compute_window_func(THD *thd,
 
       /* Return to current row after notifying cursors for each window
          function. */
-      tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
+      if (!streaming)
+        tbl->file->ha_rnd_pos(tbl->record[0], rowid_buf);
     }
 
     /* We now have computed values for each window function. They can now
@@ -2414,6 +2414,27 @@ Sys_binlog_commit_wait_usec(
        GLOBAL_VAR(opt_binlog_commit_wait_usec), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, ULONG_MAX), DEFAULT(100000), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_binlog_gtid_index_span(
+       "binlog_gtid_index_span",
+       "Minimum number of bytes written to the binary log between two "
+       "entries of the GTID index that is kept alongside each binlog file. "
+       "The index lets a slave connecting with GTID start reading close to "
+       "its position instead of at the start of the binlog file. "
+       "0 disables the index.",
+       GLOBAL_VAR(opt_binlog_gtid_index_span), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024L*1024L), DEFAULT(65536), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_binlog_writeset_max_keys(
+       "binlog_writeset_max_keys",
+       "Maximum number of primary and unique key hashes that are logged "
+       "in the GTID event of a transaction that is logged in row format. "
+       "A slave in conservative parallel mode runs transactions that modify "
+       "different keys in parallel, even if they did not group commit "
+       "together. Transactions that modify more keys are logged without "
+       "hashes. 0 disables the logging of key hashes.",
+       GLOBAL_VAR(opt_binlog_writeset_max_keys), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, UINT_MAX16), DEFAULT(0), BLOCK_SIZE(1));
+
 
 static bool fix_max_join_size(sys_var *self, THD *thd, enum_var_type type)
 {
@@ -2714,6 +2735,8 @@ export const char *optimizer_switch_names[]=
   "rowid_filter",
   "condition_pushdown_from_having",
   "not_null_range_scan",
+  "join_cache_hashed_spill",
+  "batch_filter",
   "default", 
   NullS
 };
@@ -3329,6 +3352,26 @@ Sys_master_verify_checksum(
        GLOBAL_VAR(opt_master_verify_checksum), CMD_LINE(OPT_ARG),
        DEFAULT(FALSE));
 
+static Sys_var_mybool Sys_binlog_dump_zero_copy(
+       "binlog_dump_zero_copy",
+       "Send binlog events that need no changes to slaves straight from the "
+       "binlog file, many events per system call, instead of copying each "
+       "event into a network packet. Not used for compressed or SSL "
+       "connections, semi-synchronous slaves, encrypted binlogs, with "
+       "master_verify_checksum, or while events are skipped up to the GTID "
+       "position of the slave. Only supported on Linux",
+       GLOBAL_VAR(opt_binlog_dump_zero_copy), CMD_LINE(OPT_ARG),
+       DEFAULT(TRUE));
+
+static Sys_var_ulong Sys_binlog_dump_cache_size(
+       "binlog_dump_cache_size",
+       "Size of the in-memory copy of the last bytes written to the binary "
+       "log. Slaves that are caught up with the master get the events from "
+       "it instead of each binlog dump thread reading the binlog file. "
+       "Only used together with binlog_dump_zero_copy. 0 disables the copy",
+       READ_ONLY GLOBAL_VAR(opt_binlog_dump_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, UINT_MAX32), DEFAULT(0), BLOCK_SIZE(IO_SIZE));
+
 /* These names must match RPL_SKIP_XXX #defines in slave.h. */
 static const char *replicate_events_marked_for_skip_names[]= {
   "REPLICATE", "FILTER_ON_SLAVE", "FILTER_ON_MASTER", 0
@@ -3564,6 +3607,14 @@ static Sys_var_ulonglong Sys_sort_buffer(
        VALID_RANGE(MIN_SORT_MEMORY, SIZE_T_MAX), DEFAULT(MAX_SORT_MEMORY),
        BLOCK_SIZE(1));
 
+static Sys_var_uint Sys_filesort_threads(
+       "filesort_threads",
+       "Number of helper threads that sort the sort buffer and merge the "
+       "sorted runs of filesort in parallel, shared by all connections. "
+       "0 or 1 sorts in the connection thread only",
+       READ_ONLY GLOBAL_VAR(filesort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 256), DEFAULT(0), BLOCK_SIZE(1));
+
 export sql_mode_t expand_sql_mode(sql_mode_t sql_mode)
 {
   if (sql_mode & MODE_ANSI)
@@ -5407,6 +5407,7 @@ void TABLE::init(THD *thd, TABLE_LIST *tl)
   vers_write= s->versioned;
   opt_range_condition_rows=0;
   no_cache= false;
+  writeset_fk_known= false;
   initialize_opt_range_structures();
 #ifdef HAVE_REPLICATION
   /* used in RBR Triggers */
@@ -7927,6 +7928,10 @@ bool TABLE::check_tmp_key(uint key, uint key_parts,
     reg_field= field + fld_idx;
     if ((*reg_field)->type() == MYSQL_TYPE_BLOB)
       return FALSE;
+    /* MEMORY tables store GEOMETRY values, but cannot index them */
+    if (((*reg_field)->flags & BLOB_FLAG) &&
+        !(file->ha_table_flags() & HA_CAN_INDEX_BLOBS))
+      return FALSE;
     uint fld_store_len= (uint16) (*reg_field)->key_length();
     if ((*reg_field)->real_maybe_null())
       fld_store_len+= HA_KEY_NULL_LENGTH;
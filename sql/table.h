@@ -1490,6 +1490,12 @@ struct TABLE
   /* used in RBR Triggers */
   bool master_had_triggers;
 #endif
+  /*
+    Whether the table has or is referenced by foreign keys, for the writeset
+    of the binary log. Valid if writeset_fk_known is set, which is reset for
+    every statement.
+  */
+  bool writeset_fk_known, writeset_fk;
 
   REGINFO reginfo;			/* field connections */
   MEM_ROOT mem_root;
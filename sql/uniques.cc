@@ -29,6 +29,12 @@
 
   The unique entries will be returned in sort order, to ensure that we do the
   deletes in disk order.
+
+  Keys that can be compared byte-wise are stored in a hash set instead of the
+  tree. The set is sorted before it is written to disk, so the rest works the
+  same way. If the caller doesn't need sorted keys, the set is instead written
+  to files partitioned by hash value, which are deduplicated one by one
+  without a merge.
 */
 
 #include "mariadb.h"
@@ -40,6 +46,10 @@
 #include "uniques.h"	                        // Unique
 #include "sql_sort.h"
 
+/* A full hash set is split into this many files, see Unique::hash_spill() */
+#define UNIQUE_HASH_PART_BITS 4
+#define UNIQUE_HASH_PARTS (1U << UNIQUE_HASH_PART_BITS)
+
 int unique_write_to_file(uchar* key, element_count count, Unique *unique)
 {
   /*
@@ -77,11 +87,20 @@ int unique_intersect_write_to_ptrs(uchar* key, element_count count, Unique *uniq
 }
 
 
+/*
+  @param binary_keys  Two keys are equal if and only if their bytes are
+                      equal. Allows to use a hash set instead of the tree.
+*/
+
 Unique::Unique(qsort_cmp2 comp_func, void * comp_func_fixed_arg,
 	       uint size_arg, size_t max_in_memory_size_arg,
-               uint min_dupl_count_arg)
+               uint min_dupl_count_arg, bool binary_keys)
   :max_in_memory_size(max_in_memory_size_arg),
    size(size_arg),
+   use_hash(binary_keys && !min_dupl_count_arg && size_arg),
+   hash_sorted(false), hash_keys(NULL), hash_slots(NULL), hash_elements(0),
+   hash_capacity(0), hash_mask(0), unordered_walk(false),
+   hash_spilled(false), hash_merging(false), hash_parts(NULL),
    elements(0)
 {
   my_b_clear(&file);
@@ -95,13 +114,7 @@ Unique::Unique(qsort_cmp2 comp_func, void * comp_func_fixed_arg,
   /* If the following fail's the next add will also fail */
   my_init_dynamic_array(PSI_INSTRUMENT_ME, &file_ptrs, sizeof(Merge_chunk), 16,
                         16, MYF(MY_THREAD_SPECIFIC));
-  /*
-    If you change the following, change it in get_max_elements function, too.
-  */
-  max_elements= (ulong) (max_in_memory_size /
-                         ALIGN_SIZE(sizeof(TREE_ELEMENT)+size));
-  if (!max_elements)
-    max_elements= 1;
+  max_elements= get_max_elements(max_in_memory_size, size, use_hash);
 
   (void) open_cached_file(&file, mysql_tmpdir,TEMP_PREFIX, DISK_BUFFER_SIZE,
                           MYF(MY_WME));
@@ -268,6 +281,7 @@ static double get_merge_many_buffs_cost(uint *buffer,
       write_fl  if the result must be saved written to disk
       in_memory_elems  OUT estimate of the number of elements in memory
                            if disk is not used  
+      binary_keys  the keys will be kept in the hash set, see Unique::Unique
 
   RETURN
     Cost in disk seeks.
@@ -292,6 +306,10 @@ static double get_merge_many_buffs_cost(uint *buffer,
 
       Approximate value of log2(N!) is calculated by log2_n_fact function.
 
+      The hash set (binary_keys) instead takes one hash and about one
+      comparison per Unique::put, and sorts every full set once before it
+      is written to disk, which is log2(N!) comparisons.
+
     2. Cost of merging.
       If only one tree is created by Unique no merging will be necessary.
       Otherwise, we model execution of merge_many_buff function and count
@@ -307,26 +325,33 @@ static double get_merge_many_buffs_cost(uint *buffer,
 double Unique::get_use_cost(uint *buffer, size_t nkeys, uint key_size,
                             size_t max_in_memory_size,
                             double compare_factor,
-                            bool intersect_fl, bool *in_memory)
+                            bool intersect_fl, bool *in_memory,
+                            bool binary_keys)
 {
   size_t max_elements_in_tree;
   size_t last_tree_elems;
   size_t   n_full_trees; /* number of trees in unique - 1 */
   double result;
 
-  max_elements_in_tree= ((size_t) max_in_memory_size /
-                         ALIGN_SIZE(sizeof(TREE_ELEMENT)+key_size));
-
-  if (max_elements_in_tree == 0)
-    max_elements_in_tree= 1;
+  max_elements_in_tree= get_max_elements(max_in_memory_size, key_size,
+                                         binary_keys);
 
   n_full_trees=    nkeys / max_elements_in_tree;
   last_tree_elems= nkeys % max_elements_in_tree;
 
   /* Calculate cost of creating trees */
-  result= 2*log2_n_fact(last_tree_elems + 1.0);
-  if (n_full_trees)
-    result+= n_full_trees * log2_n_fact(max_elements_in_tree + 1.0);
+  if (binary_keys)
+  {
+    result= (double) nkeys + log2_n_fact(last_tree_elems + 1.0);
+    if (n_full_trees)
+      result+= n_full_trees * log2_n_fact(max_elements_in_tree + 1.0);
+  }
+  else
+  {
+    result= 2*log2_n_fact(last_tree_elems + 1.0);
+    if (n_full_trees)
+      result+= n_full_trees * log2_n_fact(max_elements_in_tree + 1.0);
+  }
   result /= compare_factor;
 
   DBUG_PRINT("info",("unique trees sizes: %u=%u*%u + %u", (uint)nkeys,
@@ -371,6 +396,305 @@ Unique::~Unique()
   close_cached_file(&file);
   delete_tree(&tree, 0);
   delete_dynamic(&file_ptrs);
+  hash_free();
+  if (hash_parts)
+  {
+    for (uint i= 0; i < UNIQUE_HASH_PARTS; i++)
+      close_cached_file(hash_parts + i);
+    my_free(hash_parts);
+  }
+}
+
+
+/*
+  Hash function for the hash set. Keys are compared byte-wise there, so
+  any function of the key bytes will do. This one mixes in 8-byte words
+  while at least 8 bytes are left, and then the remaining bytes one by one.
+*/
+
+static inline uint32 unique_key_hash(const uchar *key, uint length)
+{
+  ulonglong nr= 0x9E3779B97F4A7C15ULL ^ length;
+  for (; length >= 8; key+= 8, length-= 8)
+  {
+    nr= (nr ^ uint8korr(key)) * 0xFF51AFD7ED558CCDULL;
+    nr^= nr >> 29;
+  }
+  for (; length; key++, length--)
+    nr= (nr ^ *key) * 0x100000001B3ULL;
+  nr^= nr >> 33;
+  nr*= 0xC4CEB9FE1A85EC53ULL;
+  nr^= nr >> 33;
+  return (uint32) nr;
+}
+
+
+/*
+  Add a key to the hash set, dumping the set to the file if it is full.
+
+  RETURN VALUE
+    0  OK, the key was added or was already there
+    1  error
+*/
+
+bool Unique::hash_add(uchar *key)
+{
+  if (unlikely(hash_sorted))
+    hash_build_slots();
+  if (unlikely(!hash_slots) && hash_grow())
+    return 1;
+
+  ulong slot= unique_key_hash(key, size) & hash_mask;
+  uint32 idx;
+  while ((idx= hash_slots[slot]))
+  {
+    if (!memcmp(hash_keys + (size_t) (idx - 1) * size, key, size))
+      return 0;
+    slot= (slot + 1) & hash_mask;
+  }
+
+  if (unlikely(hash_elements == hash_capacity))
+  {
+    if (hash_elements >= max_elements ? flush() : hash_grow())
+      return 1;
+    /* The slots have been cleared or rebuilt, look for a free one again */
+    return hash_add(key);
+  }
+
+  memcpy(hash_keys + (size_t) hash_elements * size, key, size);
+  hash_slots[slot]= (uint32) ++hash_elements;
+  return 0;
+}
+
+
+/*
+  Double the room for keys, up to max_elements, and rebuild the slots.
+  The slot table is kept at least twice as large as the number of keys.
+*/
+
+bool Unique::hash_grow()
+{
+  ulong capacity= MY_MIN(MY_MAX(hash_capacity * 2, 256), max_elements);
+  ulong slots= 1;
+  while (slots < capacity * 2)
+    slots<<= 1;
+
+  uchar *keys= (uchar*) my_realloc(key_memory_Unique_hash_set, hash_keys,
+                                   (size_t) capacity * size,
+                                   MYF(MY_ALLOW_ZERO_PTR | MY_WME |
+                                       MY_THREAD_SPECIFIC));
+  if (!keys)
+    return 1;
+  hash_keys= keys;
+  hash_capacity= capacity;
+
+  if (slots != hash_mask + 1 || !hash_slots)
+  {
+    my_free(hash_slots);
+    if (!(hash_slots= (uint32*) my_malloc(key_memory_Unique_hash_set,
+                                          slots * sizeof(uint32),
+                                          MYF(MY_WME | MY_THREAD_SPECIFIC))))
+    {
+      hash_mask= 0;
+      return 1;
+    }
+    hash_mask= slots - 1;
+  }
+  hash_build_slots();
+  return 0;
+}
+
+
+/* Fill the slot table from hash_keys */
+
+void Unique::hash_build_slots()
+{
+  bzero(hash_slots, (hash_mask + 1) * sizeof(uint32));
+  uchar *key= hash_keys;
+  for (ulong i= 0; i < hash_elements; i++, key+= size)
+  {
+    ulong slot= unique_key_hash(key, size) & hash_mask;
+    while (hash_slots[slot])
+      slot= (slot + 1) & hash_mask;
+    hash_slots[slot]= (uint32) (i + 1);
+  }
+  hash_sorted= false;
+}
+
+
+/*
+  Sort the keys in the order of the compare function, which is the order
+  the tree would return them in. The slots must be rebuilt before the next
+  hash_add().
+*/
+
+void Unique::hash_sort()
+{
+  if (hash_elements > 1)
+  {
+    my_qsort2(hash_keys, hash_elements, size, (qsort2_cmp) tree.compare,
+              tree.custom_arg);
+    hash_sorted= true;
+  }
+}
+
+
+/*
+  Call the action for every key of the hash set, in sorted order unless
+  allow_unordered_walk() was called
+*/
+
+int Unique::hash_walk(tree_walk_action action, void *walk_action_arg)
+{
+  if (!unordered_walk)
+    hash_sort();
+  uchar *key= hash_keys;
+  for (ulong i= 0; i < hash_elements; i++, key+= size)
+  {
+    if (action(key, 1, walk_action_arg))
+      return 1;
+  }
+  return 0;
+}
+
+
+/*
+  Empty the hash set. A large slot table holding few keys is freed rather
+  than cleared, so that small groups don't pay for clearing it every time.
+*/
+
+void Unique::hash_reset()
+{
+  if (!hash_slots)
+    return;
+  if (hash_capacity > 256 && hash_elements < hash_capacity / 8)
+  {
+    hash_free();
+    return;
+  }
+  hash_elements= 0;
+  hash_sorted= false;
+  bzero(hash_slots, (hash_mask + 1) * sizeof(uint32));
+}
+
+
+void Unique::hash_free()
+{
+  my_free(hash_keys);
+  my_free(hash_slots);
+  hash_keys= NULL;
+  hash_slots= NULL;
+  hash_elements= hash_capacity= hash_mask= 0;
+  hash_sorted= false;
+}
+
+
+/*
+  Write the keys of the full hash set to the hash_parts files, choosing the
+  file by the top bits of the key hash, and empty the set. Equal keys always
+  go to the same file, so every file can be deduplicated on its own.
+*/
+
+bool Unique::hash_spill()
+{
+  if (!hash_parts)
+  {
+    if (!(hash_parts= (IO_CACHE*) my_malloc(key_memory_Unique_hash_set,
+                                            UNIQUE_HASH_PARTS *
+                                            sizeof(IO_CACHE),
+                                            MYF(MY_WME | MY_ZEROFILL |
+                                                MY_THREAD_SPECIFIC))))
+      return 1;
+    for (uint i= 0; i < UNIQUE_HASH_PARTS; i++)
+      my_b_clear(hash_parts + i);
+    /* Together the files buffer as much as the file of sorted runs does */
+    for (uint i= 0; i < UNIQUE_HASH_PARTS; i++)
+    {
+      if (open_cached_file(hash_parts + i, mysql_tmpdir, TEMP_PREFIX,
+                           DISK_BUFFER_SIZE / UNIQUE_HASH_PARTS, MYF(MY_WME)))
+        return 1;
+    }
+  }
+
+  uchar *key= hash_keys;
+  for (ulong i= 0; i < hash_elements; i++, key+= size)
+  {
+    uint part= unique_key_hash(key, size) >> (32 - UNIQUE_HASH_PART_BITS);
+    if (my_b_write(hash_parts + part, key, size))
+      return 1;
+  }
+  elements+= hash_elements;
+  hash_spilled= true;
+  hash_elements= 0;
+  if (hash_slots)
+    bzero(hash_slots, (hash_mask + 1) * sizeof(uint32));
+  return 0;
+}
+
+
+/*
+  walk() for a hash set that was spilled to hash_parts: every file is read
+  back into the hash set and walked on its own. If a file has more distinct
+  keys than fit in memory, the set is written to the file of sorted runs
+  while reading it, and the runs are merged like in walk().
+*/
+
+bool Unique::hash_walk_parts(TABLE *table, tree_walk_action action,
+                             void *walk_action_arg)
+{
+  if (hash_spill())
+    return 1;
+  hash_merging= true;
+
+  ulong buff_elems= MY_MAX(DISK_BUFFER_SIZE / size, 1);
+  uchar *buff;
+  if (!(buff= (uchar*) my_malloc(key_memory_Unique_merge_buffer,
+                                 (size_t) buff_elems * size,
+                                 MYF(MY_THREAD_SPECIFIC|MY_WME))))
+    return 1;
+
+  bool res= 0;
+  for (uint i= 0; !res && i < UNIQUE_HASH_PARTS; i++)
+  {
+    IO_CACHE *part= hash_parts + i;
+    ulong left= (ulong) (my_b_tell(part) / size);
+    if (!left)
+      continue;
+    if (flush_io_cache(part) || reinit_io_cache(part, READ_CACHE, 0L, 0, 0))
+    {
+      res= 1;
+      break;
+    }
+    while (!res && left)
+    {
+      ulong n= MY_MIN(left, buff_elems);
+      if (my_b_read(part, buff, (size_t) n * size))
+      {
+        res= 1;
+        break;
+      }
+      left-= n;
+      for (uchar *key= buff; !res && n--; key+= size)
+        res= hash_add(key);
+    }
+    if (res)
+      break;
+
+    if (file_ptrs.elements)
+    {
+      res= walk_runs(table, action, walk_action_arg);
+      reset_dynamic(&file_ptrs);
+      if (reinit_io_cache(&file, WRITE_CACHE, 0L, 0, 1))
+        res= 1;
+    }
+    else
+    {
+      res= hash_walk(action, walk_action_arg);
+      hash_reset();
+    }
+  }
+  my_free(buff);
+  return res;
 }
 
 
@@ -378,9 +702,28 @@ Unique::~Unique()
 bool Unique::flush()
 {
   Merge_chunk file_ptr;
+  file_ptr.set_file_position(my_b_tell(&file));
+
+  if (use_hash)
+  {
+    if (unordered_walk && !hash_merging)
+      return hash_spill();
+    /* The keys are written sorted, exactly as tree_walk() would do it */
+    elements+= hash_elements;
+    file_ptr.set_rowcount(hash_elements);
+    hash_sort();
+    if (my_b_write(&file, hash_keys, (size_t) hash_elements * size) ||
+        insert_dynamic(&file_ptrs, (uchar*) &file_ptr))
+      return 1;
+    hash_elements= 0;
+    hash_sorted= false;
+    if (hash_slots)
+      bzero(hash_slots, (hash_mask + 1) * sizeof(uint32));
+    return 0;
+  }
+
   elements+= tree.elements_in_tree;
   file_ptr.set_rowcount(tree.elements_in_tree);
-  file_ptr.set_file_position(my_b_tell(&file));
 
   tree_walk_action action= min_dupl_count ?
 		           (tree_walk_action) unique_write_to_file_with_count :
@@ -403,6 +746,13 @@ void
 Unique::reset()
 {
   reset_tree(&tree);
+  hash_reset();
+  if (hash_spilled)
+  {
+    for (uint i= 0; i < UNIQUE_HASH_PARTS; i++)
+      reinit_io_cache(hash_parts + i, WRITE_CACHE, 0L, 0, 1);
+    hash_spilled= hash_merging= false;
+  }
   /*
     If elements != 0, some trees were stored in the file (see how
     flush() works). Note, that we can not count on my_b_tell(&file) == 0
@@ -647,16 +997,31 @@ static bool merge_walk(uchar *merge_buffer, size_t merge_buffer_size,
 
 bool Unique::walk(TABLE *table, tree_walk_action action, void *walk_action_arg)
 {
-  int res= 0;
-  uchar *merge_buffer;
-
   if (elements == 0)                       /* the whole tree is in memory */
+  {
+    if (use_hash)
+      return hash_walk(action, walk_action_arg);
     return tree_walk(&tree, action, walk_action_arg, left_root_right);
+  }
+  if (hash_spilled)
+    return hash_walk_parts(table, action, walk_action_arg);
+  return walk_runs(table, action, walk_action_arg);
+}
+
 
-  sort.return_rows= elements+tree.elements_in_tree;
+/* walk() for keys that were written to the file in sorted runs */
+
+bool Unique::walk_runs(TABLE *table, tree_walk_action action,
+                       void *walk_action_arg)
+{
+  int res= 0;
+  uchar *merge_buffer;
+
+  sort.return_rows= elements+elements_in_tree();
   /* flush current tree to the file to have some memory for merge buffer */
   if (flush())
     return 1;
+  hash_free();
   if (flush_io_cache(&file) || reinit_io_cache(&file, READ_CACHE, 0L, 0, 0))
     return 1;
   /*
@@ -786,23 +1151,27 @@ bool Unique::get(TABLE *table)
 {
   bool rc= 1;
   uchar *sort_buffer= NULL;
-  sort.return_rows= elements+tree.elements_in_tree;
+  sort.return_rows= elements+elements_in_tree();
   DBUG_ENTER("Unique::get");
+  DBUG_ASSERT(!unordered_walk);
 
   if (my_b_tell(&file) == 0)
   {
     /* Whole tree is in memory;  Don't use disk if you don't need to */
     if ((sort.record_pointers= (uchar*)
 	 my_malloc(key_memory_Filesort_info_record_pointers,
-                   size * tree.elements_in_tree, MYF(MY_THREAD_SPECIFIC))))
+                   size * elements_in_tree(), MYF(MY_THREAD_SPECIFIC))))
     {
       uchar *save_record_pointers= sort.record_pointers;
       tree_walk_action action= min_dupl_count ?
 		         (tree_walk_action) unique_intersect_write_to_ptrs :
 		         (tree_walk_action) unique_write_to_ptrs;
       filtered_out_elems= 0;
-      (void) tree_walk(&tree, action,
-		       this, left_root_right);
+      if (use_hash)
+        (void) hash_walk(action, this);
+      else
+        (void) tree_walk(&tree, action,
+                         this, left_root_right);
       /* Restore record_pointers that was changed in by 'action' above */
       sort.record_pointers= save_record_pointers;
       sort.return_rows-= filtered_out_elems;
@@ -812,6 +1181,7 @@ bool Unique::get(TABLE *table)
   /* Not enough memory; Save the result to file && free memory used by tree */
   if (flush())
     DBUG_RETURN(1);
+  hash_free();
   /*
     merge_buffer must fit at least MERGEBUFF2 + 1 keys, because
     merge_index() can merge that many BUFFPEKs at once. The extra space for
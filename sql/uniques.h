@@ -24,6 +24,14 @@
    it's dumped to the file. User can request sorted values, or
    just iterate through them. In the last case tree merging is performed in
    memory simultaneously with iteration, so it should be ~2-3x faster.
+
+   If keys are equal only when they are byte-wise equal (binary_keys), a hash
+   set is used instead of the tree: keys are appended to a contiguous array
+   and found by an open addressing table of indexes into it. The array is
+   sorted only when it is dumped to the file or its values are requested.
+   If the caller doesn't need walk() to return the keys in order, a full hash
+   set is instead split by hash value into several files, and every file is
+   later deduplicated in memory on its own.
  */
 
 class Unique :public Sql_alloc
@@ -45,20 +53,48 @@ class Unique :public Sql_alloc
                             always 0 for unions, > 0 for intersections */
   bool with_counters;
 
+  /* Hash set used instead of the tree, see the class comment */
+  bool use_hash;
+  bool hash_sorted;         /* hash_keys were sorted, hash_slots are stale */
+  uchar *hash_keys;         /* hash_elements keys of 'size' bytes */
+  uint32 *hash_slots;       /* 0 for a free slot, otherwise key number + 1 */
+  ulong hash_elements;
+  ulong hash_capacity;      /* Number of keys hash_keys has room for */
+  ulong hash_mask;          /* Number of slots - 1 */
+  bool unordered_walk;      /* spill to hash_parts, see allow_unordered_walk() */
+  bool hash_spilled;        /* some keys were written to hash_parts */
+  bool hash_merging;        /* hash_parts are being read back */
+  IO_CACHE *hash_parts;     /* UNIQUE_HASH_PARTS files, keys split by hash */
+
   bool merge(TABLE *table, uchar *buff, size_t size, bool without_last_merge);
   bool flush();
+  bool walk_runs(TABLE *table, tree_walk_action action, void *walk_action_arg);
+
+  bool hash_add(uchar *key);
+  bool hash_grow();
+  void hash_build_slots();
+  void hash_sort();
+  int hash_walk(tree_walk_action action, void *walk_action_arg);
+  void hash_reset();
+  void hash_free();
+  bool hash_spill();
+  bool hash_walk_parts(TABLE *table, tree_walk_action action,
+                       void *walk_action_arg);
 
 public:
   ulong elements;
   SORT_INFO sort;
   Unique(qsort_cmp2 comp_func, void *comp_func_fixed_arg,
 	 uint size_arg, size_t max_in_memory_size_arg,
-         uint min_dupl_count_arg= 0);
+         uint min_dupl_count_arg= 0, bool binary_keys= false);
   ~Unique();
-  ulong elements_in_tree() { return tree.elements_in_tree; }
+  ulong elements_in_tree()
+  { return use_hash ? hash_elements : tree.elements_in_tree; }
   inline bool unique_add(void *ptr)
   {
     DBUG_ENTER("unique_add");
+    if (use_hash)
+      DBUG_RETURN(hash_add((uchar*) ptr));
     DBUG_PRINT("info", ("tree %u - %lu", tree.elements_in_tree, max_elements));
     if (!(tree.flag & TREE_ONLY_DUPS) && 
         tree.elements_in_tree >= max_elements && flush())
@@ -66,8 +102,18 @@ class Unique :public Sql_alloc
     DBUG_RETURN(!tree_insert(&tree, ptr, 0, tree.custom_arg));
   }
 
-  bool is_in_memory() { return (my_b_tell(&file) == 0); }
-  void close_for_expansion() { tree.flag= TREE_ONLY_DUPS; }
+  bool is_in_memory() { return (my_b_tell(&file) == 0 && !hash_spilled); }
+  /*
+    walk() may call the action for the keys in any order. This allows to
+    spill the hash set to files partitioned by hash value, which don't have
+    to be merged. get() must not be used then.
+  */
+  void allow_unordered_walk() { unordered_walk= use_hash; }
+  void close_for_expansion()
+  {
+    DBUG_ASSERT(!use_hash);
+    tree.flag= TREE_ONLY_DUPS;
+  }
 
   bool get(TABLE *table);
   
@@ -78,17 +124,37 @@ class Unique :public Sql_alloc
     return log((double) tree_elems) / (compare_factor * M_LN2);
   }  
 
+  /* Number of keys kept in memory before they are written to disk */
+  inline static ulong get_max_elements(size_t max_in_memory_size,
+                                       uint key_size, bool binary_keys)
+  {
+    ulong max_elems;
+    if (binary_keys)
+    {
+      /*
+        The open addressing table is a power of two at least twice as
+        large as the number of keys, that is, up to 4 slots per key.
+      */
+      max_elems= (ulong) (max_in_memory_size /
+                          (key_size + 4 * sizeof(uint32)));
+      set_if_smaller(max_elems, UINT_MAX32 / 4);
+    }
+    else
+      max_elems= (ulong) (max_in_memory_size /
+                          ALIGN_SIZE(sizeof(TREE_ELEMENT)+key_size));
+    return max_elems ? max_elems : 1;
+  }
+
   static double get_use_cost(uint *buffer, size_t nkeys, uint key_size,
                              size_t max_in_memory_size, double compare_factor,
-                             bool intersect_fl, bool *in_memory);
+                             bool intersect_fl, bool *in_memory,
+                             bool binary_keys= false);
   inline static int get_cost_calc_buff_size(size_t nkeys, uint key_size,
-                                            size_t max_in_memory_size)
+                                            size_t max_in_memory_size,
+                                            bool binary_keys= false)
   {
     size_t max_elems_in_tree=
-      max_in_memory_size / ALIGN_SIZE(sizeof(TREE_ELEMENT)+key_size);
-
-    if (max_elems_in_tree == 0)
-      max_elems_in_tree= 1;
+      get_max_elements(max_in_memory_size, key_size, binary_keys);
     return (int) (sizeof(uint)*(1 + nkeys/max_elems_in_tree));
   }
 
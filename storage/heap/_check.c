@@ -108,7 +108,9 @@ static int check_one_key(HP_KEYDEF *keydef, uint keynr, ulong records,
   for (i=found=max_links=seek=0 ; i < records ; i++)
   {
     hash_info=hp_find_hash(&keydef->block,i);
-    if (hash_info->hash_of_key != hp_rec_hashnr(keydef, hash_info->ptr_to_rec))
+    /* Stored records point to the chunks of their blobs, not to the data */
+    if (!(keydef->flag & HA_UNIQUE_CHECK) &&
+        hash_info->hash_of_key != hp_rec_hashnr(keydef, hash_info->ptr_to_rec))
     {
       DBUG_PRINT("error",
                  ("Found row with wrong hash_of_key at position %lu", i));
@@ -377,6 +377,8 @@ int ha_heap::info(uint flag)
   (void) heap_info(file,&hp_info,flag);
 
   errkey=                     hp_info.errkey;
+  if (flag & HA_STATUS_ERRKEY)
+    memcpy(dup_ref, &hp_info.dupp_key_pos, sizeof(HEAP_PTR));
   stats.records=              hp_info.records;
   stats.deleted=              hp_info.deleted;
   stats.mean_rec_length=      hp_info.reclength;
@@ -611,10 +613,12 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
                             HP_CREATE_INFO *hp_create_info)
 {
   uint key, parts, mem_per_row= 0, keys= table_arg->s->keys;
+  uint blobs= table_arg->s->blob_fields;
   uint auto_key= 0, auto_key_type= 0;
   ha_rows max_rows;
   HP_KEYDEF *keydef;
   HA_KEYSEG *seg;
+  HP_BLOB_DESC *blob_descs;
   TABLE_SHARE *share= table_arg->s;
   bool found_real_auto_increment= 0;
 
@@ -625,10 +629,18 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
 
   if (!(keydef= (HP_KEYDEF*) my_malloc(hp_key_memory_HP_KEYDEF,
                                        keys * sizeof(HP_KEYDEF) +
-				       parts * sizeof(HA_KEYSEG),
+				       parts * sizeof(HA_KEYSEG) +
+                                       blobs * sizeof(HP_BLOB_DESC),
 				       MYF(MY_WME | MY_THREAD_SPECIFIC))))
     return my_errno;
   seg= reinterpret_cast<HA_KEYSEG*>(keydef + keys);
+  blob_descs= reinterpret_cast<HP_BLOB_DESC*>(seg + parts);
+  for (uint i= 0; i < blobs; i++)
+  {
+    Field_blob *field= (Field_blob*) table_arg->field[share->blob_field[i]];
+    blob_descs[i].offset= (uint) field->offset(table_arg->record[0]);
+    blob_descs[i].packlength= field->pack_length_no_ptr();
+  }
   for (key= 0; key < keys; key++)
   {
     KEY *pos= table_arg->key_info+key;
@@ -672,6 +684,18 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
       seg->start=   (uint) key_part->offset;
       seg->length=  (uint) key_part->length;
       seg->flag=    key_part->key_part_flag;
+      if (field->flags & BLOB_FLAG)
+      {
+        /*
+          Only the unique keys of internal temporary tables have blob
+          segments. They are used to find duplicates, not to search.
+        */
+        DBUG_ASSERT(internal_table && pos->algorithm != HA_KEY_ALG_BTREE &&
+                    (pos->flags & HA_NOSAME));
+        keydef[key].flag|= HA_UNIQUE_CHECK;
+        seg->flag|= HA_BLOB_PART;
+        seg->type= HA_KEYTYPE_TEXT;             /* Kept by heap_create() */
+      }
 
       if (field->flags & (ENUM_FLAG | SET_FLAG))
         seg->charset= &my_charset_bin;
@@ -705,6 +729,12 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
         seg->bit_pos= (uint) (((Field_bit *) field)->bit_ptr -
                                           (uchar*) table_arg->record[0]);
       }
+      else if (seg->flag & HA_BLOB_PART)
+      {
+        seg->bit_length= 0;
+        seg->bit_start= ((Field_blob*) field)->pack_length_no_ptr();
+        seg->bit_pos= 0;
+      }
       else
       {
         seg->bit_length= seg->bit_start= 0;
@@ -721,6 +751,13 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->auto_key= auto_key;
   hp_create_info->auto_key_type= auto_key_type;
   hp_create_info->max_table_size=current_thd->variables.max_heap_table_size;
+  /*
+    The number of records of internal temporary tables is limited by
+    tmp_memory_table_size, which does not account for the data of blobs.
+  */
+  if (internal_table && blobs)
+    set_if_smaller(hp_create_info->max_table_size,
+                   current_thd->variables.tmp_memory_table_size);
   hp_create_info->with_auto_increment= found_real_auto_increment;
   hp_create_info->internal_table= internal_table;
 
@@ -733,6 +770,8 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->keys= share->keys;
   hp_create_info->reclength= share->reclength;
   hp_create_info->keydef= keydef;
+  hp_create_info->blob_descs= blob_descs;
+  hp_create_info->blobs= blobs;
   return 0;
 }
 
@@ -818,7 +857,7 @@ int ha_heap::find_unique_row(uchar *record, uint unique_idx)
                                        share->blength, share->records));
   do
   {
-    if (!hp_rec_key_cmp(keyinfo, pos->ptr_to_rec, record))
+    if (!hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, file))
     {
       file->current_hash_ptr= pos;
       file->current_ptr= pos->ptr_to_rec;
@@ -827,7 +866,8 @@ int ha_heap::find_unique_row(uchar *record, uint unique_idx)
         We compare it only by record in the index, so better to read all
         records.
       */
-      memcpy(record, file->current_ptr, (size_t) share->reclength);
+      if (hp_copy_record(file, record, file->current_ptr))
+        DBUG_RETURN(-1);
 
       DBUG_RETURN(0); // found and position set
     }
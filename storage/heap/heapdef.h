@@ -33,6 +33,9 @@ C_MODE_START
 #define HP_MIN_RECORDS_IN_BLOCK 16
 #define HP_MAX_RECORDS_IN_BLOCK 8192
 
+/* Size of the chunks storing the data of blobs, see hp_blob.c */
+#define HP_BLOB_CHUNK_LENGTH 256
+
 	/* Some extern variables */
 
 extern LIST *heap_open_list,*heap_share_list;
@@ -85,7 +88,7 @@ extern ulong hp_rec_hashnr(HP_KEYDEF *keyinfo,const uchar *rec);
 extern void hp_movelink(HASH_INFO *pos,HASH_INFO *next_link,
 			 HASH_INFO *newlink);
 extern int hp_rec_key_cmp(HP_KEYDEF *keydef,const uchar *rec1,
-			  const uchar *rec2);
+			  const uchar *rec2, HP_INFO *info);
 extern int hp_key_cmp(HP_KEYDEF *keydef,const uchar *rec,
 		      const uchar *key);
 extern void hp_make_key(HP_KEYDEF *keydef,uchar *key,const uchar *rec);
@@ -100,6 +103,16 @@ extern void hp_clear(HP_SHARE *info);
 extern void hp_clear_keys(HP_SHARE *info);
 extern uint hp_rb_pack_key(HP_KEYDEF *keydef, uchar *key, const uchar *old,
                            key_part_map keypart_map);
+extern int hp_write_blobs(HP_SHARE *share, uchar *pos);
+extern void hp_free_blobs(HP_SHARE *share, uchar *pos);
+extern int hp_read_blobs(HP_INFO *info, uchar *record);
+extern int hp_blob_rec_cmp(HP_INFO *info, const uchar *pos,
+                           const uchar *record);
+extern const uchar *hp_blob_key_data(const HA_KEYSEG *seg,
+                                     const uchar *record, size_t *length);
+extern int hp_read_blob_key(HP_INFO *info, const HA_KEYSEG *seg,
+                            const uchar *pos, const uchar **data,
+                            size_t *length);
 
 extern mysql_mutex_t THR_LOCK_heap;
 
@@ -134,3 +147,20 @@ static inline ulong hp_mask(ulong hashnr, ulong buffmax, ulong maxlength)
   if ((hashnr & (buffmax-1)) < maxlength) return (hashnr & (buffmax-1));
   return (hashnr & ((buffmax >> 1) -1));
 }
+
+
+/*
+  Copy a stored record to the record buffer of the upper level.
+  The data of blobs is read into the blob buffer of the handle.
+
+  RETURN
+    0      Ok
+    other  Error code
+*/
+
+static inline int hp_copy_record(HP_INFO *info, uchar *record,
+                                 const uchar *pos)
+{
+  memcpy(record, pos, (size_t) info->s->reclength);
+  return info->s->blobs ? hp_read_blobs(info, record) : 0;
+}
@@ -0,0 +1,380 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*
+  Storage of BLOB and TEXT columns
+
+  Records are stored with the fixed length share->reclength. The data of
+  a blob column is stored apart from the record in a chain of chunks of
+  HP_BLOB_CHUNK_LENGTH bytes allocated from share->blob_block. A chunk
+  starts with the pointer to the next chunk of the chain, the rest of it
+  is the data. In the stored record the pointer to the data of the blob
+  is replaced by the pointer to the first chunk of the chain (0 for an
+  empty blob).
+
+  The chunks of deleted blobs are linked into share->blob_del_link and
+  reused by following writes. The memory of the chunks is accounted in
+  share->data_length, so max_heap_table_size limits the blobs as well.
+
+  When a record is read, the data of its blobs is assembled in
+  info->blob_buffer, which is valid until the next read with the handle.
+
+  Hash keys of internal temporary tables may have blob segments
+  (HA_BLOB_PART, the number of bytes of the length in bit_start). The
+  whole data of the blob is hashed and compared, which is enough to check
+  uniqueness; such keys are never used to search.
+*/
+
+#include "heapdef.h"
+
+#define HP_BLOB_CHUNK_DATA (HP_BLOB_CHUNK_LENGTH - sizeof(uchar*))
+
+static inline uchar *hp_next_chunk(const uchar *chunk)
+{
+  return *((uchar* const*) chunk);
+}
+
+
+static inline ulong hp_blob_length(const HP_BLOB_DESC *desc,
+                                   const uchar *record)
+{
+  const uchar *pos= record + desc->offset;
+  switch (desc->packlength) {
+  case 1:
+    return (ulong) *pos;
+  case 2:
+    return (ulong) uint2korr(pos);
+  case 3:
+    return (ulong) uint3korr(pos);
+  case 4:
+    return (ulong) uint4korr(pos);
+  default:
+    DBUG_ASSERT(0);
+  }
+  return 0;
+}
+
+
+/* The data pointer of a blob follows its length in the record */
+
+static inline uchar *hp_blob_ptr(const HP_BLOB_DESC *desc, const uchar *record)
+{
+  uchar *ptr;
+  memcpy(&ptr, record + desc->offset + desc->packlength, sizeof(ptr));
+  return ptr;
+}
+
+
+static inline void hp_set_blob_ptr(const HP_BLOB_DESC *desc, uchar *record,
+                                   const uchar *ptr)
+{
+  memcpy(record + desc->offset + desc->packlength, &ptr, sizeof(ptr));
+}
+
+
+	/* Find where to place a new chunk */
+
+static uchar *next_free_blob_chunk(HP_SHARE *share)
+{
+  ulong block_pos;
+  uchar *pos;
+  size_t length;
+
+  if ((pos= share->blob_del_link))
+  {
+    share->blob_del_link= hp_next_chunk(pos);
+    return pos;
+  }
+  if (share->data_length + share->index_length >= share->max_table_size)
+  {
+    my_errno= HA_ERR_RECORD_FILE_FULL;
+    return NULL;
+  }
+  if (!(block_pos= share->blob_chunks % share->blob_block.records_in_block))
+  {
+    if (hp_get_new_block(share, &share->blob_block, &length))
+      return NULL;
+    share->data_length+= length;
+  }
+  share->blob_chunks++;
+  return ((uchar*) share->blob_block.level_info[0].last_blocks +
+          block_pos * share->blob_block.recbuffer);
+}
+
+
+static void free_blob_chain(HP_SHARE *share, uchar *chunk)
+{
+  while (chunk)
+  {
+    uchar *next= hp_next_chunk(chunk);
+    *((uchar**) chunk)= share->blob_del_link;
+    share->blob_del_link= chunk;
+    chunk= next;
+  }
+}
+
+
+static int write_blob_chain(HP_SHARE *share, const uchar *data, ulong length,
+                            uchar **chain)
+{
+  uchar **link= chain;
+
+  *chain= 0;
+  while (length)
+  {
+    size_t part= MY_MIN(length, HP_BLOB_CHUNK_DATA);
+    uchar *chunk;
+    if (!(chunk= next_free_blob_chunk(share)))
+    {
+      free_blob_chain(share, *chain);
+      *chain= 0;
+      return my_errno;
+    }
+    *((uchar**) chunk)= 0;
+    *link= chunk;
+    link= (uchar**) chunk;
+    memcpy(chunk + sizeof(uchar*), data, part);
+    data+= part;
+    length-= part;
+  }
+  return 0;
+}
+
+
+/*
+  Store the data of the blobs of a record in chunk chains
+
+  SYNOPSIS
+    hp_write_blobs()
+    share	Heap table share
+    pos		Copy of the record to be stored. The data pointers of its
+		blobs are replaced by the heads of the chains
+
+  RETURN
+    0      Ok
+    other  Error code. No chunks are left allocated for the record
+*/
+
+int hp_write_blobs(HP_SHARE *share, uchar *pos)
+{
+  HP_BLOB_DESC *desc, *end;
+  DBUG_ENTER("hp_write_blobs");
+
+  for (desc= share->blob_descs, end= desc + share->blobs; desc < end; desc++)
+  {
+    uchar *chain;
+    if (write_blob_chain(share, hp_blob_ptr(desc, pos),
+                         hp_blob_length(desc, pos), &chain))
+    {
+      while (desc-- > share->blob_descs)
+        free_blob_chain(share, hp_blob_ptr(desc, pos));
+      DBUG_RETURN(my_errno);
+    }
+    hp_set_blob_ptr(desc, pos, chain);
+  }
+  DBUG_RETURN(0);
+}
+
+
+/* Free the chunk chains of the blobs of a stored record */
+
+void hp_free_blobs(HP_SHARE *share, uchar *pos)
+{
+  HP_BLOB_DESC *desc, *end;
+
+  for (desc= share->blob_descs, end= desc + share->blobs; desc < end; desc++)
+  {
+    free_blob_chain(share, hp_blob_ptr(desc, pos));
+    hp_set_blob_ptr(desc, pos, 0);
+  }
+}
+
+
+/*
+  Read the data of the blobs of a record into the blob buffer
+
+  SYNOPSIS
+    hp_read_blobs()
+    info	Heap handle
+    record	Record copied from the stored record. The heads of the
+		chunk chains are replaced by pointers into info->blob_buffer
+
+  RETURN
+    0                  Ok
+    HA_ERR_OUT_OF_MEM  The blob buffer could not be allocated
+*/
+
+int hp_read_blobs(HP_INFO *info, uchar *record)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOB_DESC *desc, *end= share->blob_descs + share->blobs;
+  size_t total_length= 0;
+  uchar *to;
+
+  for (desc= share->blob_descs; desc < end; desc++)
+    total_length+= hp_blob_length(desc, record);
+
+  if (total_length > info->blob_buffer_length)
+  {
+    uchar *buffer;
+    if (!(buffer= (uchar*) my_realloc(hp_key_memory_HP_INFO,
+                                      info->blob_buffer, total_length,
+                                      MYF(MY_ALLOW_ZERO_PTR |
+                                          (share->internal ?
+                                           MY_THREAD_SPECIFIC : 0)))))
+      return (my_errno= HA_ERR_OUT_OF_MEM);
+    info->blob_buffer= buffer;
+    info->blob_buffer_length= total_length;
+  }
+
+  for (desc= share->blob_descs, to= info->blob_buffer; desc < end; desc++)
+  {
+    ulong length= hp_blob_length(desc, record);
+    const uchar *chunk= hp_blob_ptr(desc, record);
+    hp_set_blob_ptr(desc, record, to);
+    while (length)
+    {
+      size_t part= MY_MIN(length, HP_BLOB_CHUNK_DATA);
+      DBUG_ASSERT(chunk);
+      memcpy(to, chunk + sizeof(uchar*), part);
+      to+= part;
+      length-= part;
+      chunk= hp_next_chunk(chunk);
+    }
+  }
+  return 0;
+}
+
+
+/*
+  Compare a stored record with a record in the format of the upper level
+
+  RETURN
+    0  The records are equal
+    1  The records differ
+*/
+
+int hp_blob_rec_cmp(HP_INFO *info, const uchar *pos, const uchar *record)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOB_DESC *desc, *end= share->blob_descs + share->blobs;
+  uchar *buff= info->blob_record;
+
+  /* Compare everything but the blob pointers at first */
+  memcpy(buff, pos, (size_t) share->reclength);
+  for (desc= share->blob_descs; desc < end; desc++)
+    hp_set_blob_ptr(desc, buff, hp_blob_ptr(desc, record));
+  if (memcmp(buff, record, (size_t) share->reclength))
+    return 1;
+
+  for (desc= share->blob_descs; desc < end; desc++)
+  {
+    ulong length= hp_blob_length(desc, record);
+    const uchar *chunk= hp_blob_ptr(desc, pos);
+    const uchar *data= hp_blob_ptr(desc, record);
+    while (length)
+    {
+      size_t part= MY_MIN(length, HP_BLOB_CHUNK_DATA);
+      if (!chunk || memcmp(chunk + sizeof(uchar*), data, part))
+        return 1;
+      data+= part;
+      length-= part;
+      chunk= hp_next_chunk(chunk);
+    }
+  }
+  return 0;
+}
+
+
+/*
+  Get the data of a blob key segment of a record of the upper level
+
+  RETURN
+    Pointer to the data, the length is stored in *length
+*/
+
+const uchar *hp_blob_key_data(const HA_KEYSEG *seg, const uchar *record,
+                              size_t *length)
+{
+  HP_BLOB_DESC desc;
+  const uchar *data;
+
+  desc.offset= seg->start;
+  desc.packlength= seg->bit_start;
+  *length= hp_blob_length(&desc, record);
+  data= hp_blob_ptr(&desc, record);
+  return data ? data : (const uchar*) "";
+}
+
+
+/*
+  Get the data of a blob key segment of a stored record
+
+  SYNOPSIS
+    hp_read_blob_key()
+    info	Heap handle
+    seg		Blob segment of the key
+    pos		Stored record
+    data	Out: the data of the blob. A blob of more than one chunk is
+		assembled in info->blob_key_buffer, which is not used for
+		the records read by the handle
+    length	Out: the length of the blob
+
+  RETURN
+    0                  Ok
+    HA_ERR_OUT_OF_MEM  The buffer could not be allocated
+*/
+
+int hp_read_blob_key(HP_INFO *info, const HA_KEYSEG *seg, const uchar *pos,
+                     const uchar **data, size_t *length)
+{
+  HP_BLOB_DESC desc;
+  const uchar *chunk;
+  size_t left;
+  uchar *to;
+
+  desc.offset= seg->start;
+  desc.packlength= seg->bit_start;
+  *length= left= hp_blob_length(&desc, pos);
+  chunk= hp_blob_ptr(&desc, pos);
+
+  if (left <= HP_BLOB_CHUNK_DATA)
+  {
+    *data= chunk ? chunk + sizeof(uchar*) : (const uchar*) "";
+    return 0;
+  }
+  if (left > info->blob_key_buffer_length)
+  {
+    uchar *buffer;
+    if (!(buffer= (uchar*) my_realloc(hp_key_memory_HP_INFO,
+                                      info->blob_key_buffer, left,
+                                      MYF(MY_ALLOW_ZERO_PTR |
+                                          (info->s->internal ?
+                                           MY_THREAD_SPECIFIC : 0)))))
+      return (my_errno= HA_ERR_OUT_OF_MEM);
+    info->blob_key_buffer= buffer;
+    info->blob_key_buffer_length= left;
+  }
+  for (to= info->blob_key_buffer; left; chunk= hp_next_chunk(chunk))
+  {
+    size_t part= MY_MIN(left, HP_BLOB_CHUNK_DATA);
+    DBUG_ASSERT(chunk);
+    memcpy(to, chunk + sizeof(uchar*), part);
+    to+= part;
+    left-= part;
+  }
+  *data= info->blob_key_buffer;
+  return 0;
+}
@@ -306,7 +306,13 @@ ulong hp_rec_hashnr(register HP_KEYDEF *keydef, register const uchar *rec)
 	continue;
       }
     }
-    if (seg->type == HA_KEYTYPE_TEXT)
+    if (seg->flag & HA_BLOB_PART)               /* The whole blob is hashed */
+    {
+      size_t length;
+      const uchar *data= hp_blob_key_data(seg, rec, &length);
+      my_ci_hash_sort(seg->charset, data, length, &nr, &nr2);
+    }
+    else if (seg->type == HA_KEYTYPE_TEXT)
     {
       CHARSET_INFO *cs= seg->charset;
       size_t char_length= seg->length;
@@ -368,17 +374,23 @@ ulong hp_rec_hashnr(register HP_KEYDEF *keydef, register const uchar *rec)
     keydef		Key definition
     rec1		Record to compare
     rec2		Other record to compare
+    info		If not 0, rec2 is a stored record and the data of its
+			blobs is read with this handle
 
   NOTES
     diff_if_only_endspace_difference is used to allow us to insert
     'a' and 'a ' when there is an an unique key.
 
+    If the blob of the stored record cannot be read, the keys are
+    reported to differ.
+
   RETURN
     0		Key is identical
     <> 0 	Key differes
 */
 
-int hp_rec_key_cmp(HP_KEYDEF *keydef, const uchar *rec1, const uchar *rec2)
+int hp_rec_key_cmp(HP_KEYDEF *keydef, const uchar *rec1, const uchar *rec2,
+                   HP_INFO *info)
 {
   HA_KEYSEG *seg,*endseg;
 
@@ -392,7 +404,19 @@ int hp_rec_key_cmp(HP_KEYDEF *keydef, const uchar *rec1, const uchar *rec2)
       if (rec1[seg->null_pos] & seg->null_bit)
 	continue;
     }
-    if (seg->type == HA_KEYTYPE_TEXT)
+    if (seg->flag & HA_BLOB_PART)
+    {
+      const uchar *data1, *data2;
+      size_t length1, length2;
+      data1= hp_blob_key_data(seg, rec1, &length1);
+      if (!info)
+        data2= hp_blob_key_data(seg, rec2, &length2);
+      else if (hp_read_blob_key(info, seg, rec2, &data2, &length2))
+        return 1;
+      if (my_ci_strnncollsp(seg->charset, data1, length1, data2, length2))
+        return 1;
+    }
+    else if (seg->type == HA_KEYTYPE_TEXT)
     {
       CHARSET_INFO *cs= seg->charset;
       size_t char_length1;
@@ -46,6 +46,15 @@ int heap_write(HP_INFO *info, const uchar *record)
     DBUG_RETURN(my_errno);
   share->changed=1;
 
+  memcpy(pos,record,(size_t) share->reclength);
+  if (share->blobs && hp_write_blobs(share, pos))
+  {
+    share->deleted++;
+    *((uchar**) pos)=share->del_link;
+    share->del_link=pos;
+    DBUG_RETURN(my_errno);
+  }
+
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end;
        keydef++)
   {
@@ -53,7 +62,6 @@ int heap_write(HP_INFO *info, const uchar *record)
       goto err;
   }
 
-  memcpy(pos,record,(size_t) share->reclength);
   pos[share->visible]= 1;                     /* Mark record as not deleted */
   if (++share->records == share->blength)
     share->blength+= share->blength;
@@ -87,6 +95,8 @@ int heap_write(HP_INFO *info, const uchar *record)
     keydef--;
   } 
 
+  if (share->blobs)
+    hp_free_blobs(share, pos);
   share->deleted++;
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
@@ -384,8 +394,9 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
       do
       {
 	if (pos->hash_of_key == hash_of_key &&
-            ! hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec))
+            ! hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, info))
 	{
+          info->dupp_key_pos= pos->ptr_to_rec;
 	  DBUG_RETURN(my_errno=HA_ERR_FOUND_DUPP_KEY);
 	}
       } while ((pos=pos->next_key));
@@ -1238,6 +1238,41 @@ void btr_free(const page_id_t page_id)
 	mtr.commit();
 }
 
+/** Empty an index tree, in the rollback of TRX_UNDO_EMPTY.
+All pages except the root page are freed, the leaf segment is created
+again, and the root page is reinitialized as an empty leaf page.
+@param[in,out]	index	index tree
+@return	error code */
+dberr_t btr_clear(dict_index_t* index)
+{
+	ut_ad(!index->table->is_temporary());
+
+	dberr_t	err = DB_SUCCESS;
+	mtr_t	mtr;
+	mtr.start();
+	index->set_modified(mtr);
+	mtr_x_lock_index(index, &mtr);
+
+	if (buf_block_t* root = btr_root_block_get(index, RW_X_LATCH, &mtr)) {
+		btr_free_but_not_root(root, mtr.get_log_mode());
+		mtr.memset(root, PAGE_HEADER + PAGE_BTR_SEG_LEAF,
+			   FSEG_HEADER_SIZE, 0);
+		if (fseg_create(index->table->space,
+				PAGE_HEADER + PAGE_BTR_SEG_LEAF, &mtr,
+				false, root)) {
+			btr_page_empty(root, buf_block_get_page_zip(root),
+				       index, 0, &mtr);
+		} else {
+			err = DB_OUT_OF_FILE_SPACE;
+		}
+	} else {
+		err = DB_CORRUPTION;
+	}
+
+	mtr.commit();
+	return err;
+}
+
 /** Read the last used AUTO_INCREMENT value from PAGE_ROOT_AUTO_INC.
 @param[in,out]	index	clustered index
 @return	the last used AUTO_INCREMENT value
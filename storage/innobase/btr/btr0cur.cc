@@ -3521,7 +3521,9 @@ btr_cur_optimistic_insert(
 			ut_ad(trx_id[1].len == DATA_ROLL_PTR_LEN);
 			ut_ad(*static_cast<const byte*>
 			      (trx_id[1].data) & 0x80);
-			if (flags & BTR_NO_UNDO_LOG_FLAG) {
+			if ((flags & BTR_NO_UNDO_LOG_FLAG)
+			    && (!thr || !thr->graph->trx->is_bulk_insert(
+					index->table))) {
 				ut_ad(!memcmp(trx_id->data, reset_trx_id,
 					      DATA_TRX_ID_LEN));
 			} else {
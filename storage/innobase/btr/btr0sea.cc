@@ -472,14 +472,13 @@ __attribute__((nonnull))
 Insert an entry into the hash table. If an entry with the same fold number
 is found, its node is updated to point to the new data, and no new node
 is inserted.
-@param table hash table
-@param heap  memory heap
+@param part  adaptive hash index partition
 @param fold  folded value of the record
 @param block buffer block containing the record
 @param data  the record
 @retval true on success
 @retval false if no more memory could be allocated */
-static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
+static bool ha_insert_for_fold(btr_search_sys_t::partition *part,
                                ulint fold,
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
                                buf_block_t *block, /*!< buffer block of data */
@@ -491,6 +490,7 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
   ut_ad(btr_search_enabled);
 
+  hash_table_t *table= &part->table;
   hash_cell_t *cell= &table->array[table->calc_hash(fold)];
 
   for (ha_node_t *prev= static_cast<ha_node_t*>(cell->node); prev;
@@ -498,6 +498,7 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
   {
     if (prev->fold == fold)
     {
+      part->begin_modify();
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
       buf_block_t *prev_block= prev->block;
       ut_a(prev_block->frame == page_align(prev->data));
@@ -506,17 +507,22 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
 
       prev->block= block;
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
-      prev->data= data;
+      reinterpret_cast<std::atomic<const rec_t*>&>(prev->data).
+        store(data, std::memory_order_relaxed);
+      part->end_modify();
       return true;
     }
   }
 
   /* We have to allocate a new chain node */
-  ha_node_t *node= static_cast<ha_node_t*>(mem_heap_alloc(heap, sizeof *node));
+  ha_node_t *node= static_cast<ha_node_t*>(mem_heap_alloc(part->heap,
+                                                          sizeof *node));
 
   if (!node)
     return false;
 
+  part->begin_modify();
+
   ha_node_set_data(node, block, data);
 
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
@@ -535,18 +541,20 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
       prev= prev->next;
     prev->next= node;
   }
+  part->end_modify();
   return true;
 }
 
 __attribute__((nonnull))
 /** Delete a record.
-@param table     hash table
-@param heap      memory heap
+@param part      adaptive hash index partition
 @param del_node  record to be deleted */
-static void ha_delete_hash_node(hash_table_t *table, mem_heap_t *heap,
+static void ha_delete_hash_node(btr_search_sys_t::partition *part,
                                 ha_node_t *del_node)
 {
   ut_ad(btr_search_enabled);
+  hash_table_t *table= &part->table;
+  mem_heap_t *heap= part->heap;
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
   ut_a(del_node->block->frame == page_align(del_node->data));
   ut_a(del_node->block->n_pointers-- < MAX_N_POINTERS);
@@ -554,6 +562,7 @@ static void ha_delete_hash_node(hash_table_t *table, mem_heap_t *heap,
 
   const ulint fold= del_node->fold;
 
+  part->begin_modify();
   HASH_DELETE(ha_node_t, next, table, fold, del_node);
 
   ha_node_t *top= static_cast<ha_node_t*>(mem_heap_get_top(heap, sizeof *top));
@@ -583,21 +592,23 @@ static void ha_delete_hash_node(hash_table_t *table, mem_heap_t *heap,
 
   /* Free the occupied space */
   mem_heap_free_top(heap, sizeof *top);
+  part->end_modify();
 }
 
 __attribute__((nonnull))
 /** Delete all pointers to a page.
-@param table     hash table
-@param heap      memory heap
+@param part      adaptive hash index partition
 @param page      record to be deleted */
-static void ha_remove_all_nodes_to_page(hash_table_t *table, mem_heap_t *heap,
+static void ha_remove_all_nodes_to_page(btr_search_sys_t::partition *part,
                                         ulint fold, const page_t *page)
 {
+  hash_table_t *table= &part->table;
+
   for (ha_node_t *node= ha_chain_get_first(table, fold); node; )
   {
     if (page_align(ha_node_get_data(node)) == page)
     {
-      ha_delete_hash_node(table, heap, node);
+      ha_delete_hash_node(part, node);
       /* The deletion may compact the heap of nodes and move other nodes! */
       node= ha_chain_get_first(table, fold);
     }
@@ -613,18 +624,16 @@ static void ha_remove_all_nodes_to_page(hash_table_t *table, mem_heap_t *heap,
 }
 
 /** Delete a record if found.
-@param table     hash table
-@param heap      memory heap for the hash bucket chain
+@param part      adaptive hash index partition
 @param fold      folded value of the searched data
 @param data      pointer to the record
 @return whether the record was found */
-static bool ha_search_and_delete_if_found(hash_table_t *table,
-                                          mem_heap_t *heap,
+static bool ha_search_and_delete_if_found(btr_search_sys_t::partition *part,
                                           ulint fold, const rec_t *data)
 {
-  if (ha_node_t *node= ha_search_with_data(table, fold, data))
+  if (ha_node_t *node= ha_search_with_data(&part->table, fold, data))
   {
-    ha_delete_hash_node(table, heap, node);
+    ha_delete_hash_node(part, node);
     return true;
   }
 
@@ -634,12 +643,13 @@ static bool ha_search_and_delete_if_found(hash_table_t *table,
 __attribute__((nonnull))
 /** Looks for an element when we know the pointer to the data and
 updates the pointer to data if found.
-@param table     hash table
+@param part      adaptive hash index partition
 @param fold      folded value of the searched data
 @param data      pointer to the data
 @param new_data  new pointer to the data
 @return whether the element was found */
-static bool ha_search_and_update_if_found(hash_table_t *table, ulint fold,
+static bool ha_search_and_update_if_found(btr_search_sys_t::partition *part,
+                                          ulint fold,
                                           const rec_t *data,
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
                                           /** block containing new_data */
@@ -654,14 +664,17 @@ static bool ha_search_and_update_if_found(hash_table_t *table, ulint fold,
   if (!btr_search_enabled)
     return false;
 
-  if (ha_node_t *node= ha_search_with_data(table, fold, data))
+  if (ha_node_t *node= ha_search_with_data(&part->table, fold, data))
   {
+    part->begin_modify();
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
     ut_a(node->block->n_pointers-- < MAX_N_POINTERS);
     ut_a(new_block->n_pointers++ < MAX_N_POINTERS);
     node->block= new_block;
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
-    node->data= new_data;
+    reinterpret_cast<std::atomic<const rec_t*>&>(node->data).
+      store(new_data, std::memory_order_relaxed);
+    part->end_modify();
 
     return true;
   }
@@ -671,9 +684,9 @@ static bool ha_search_and_update_if_found(hash_table_t *table, ulint fold,
 
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 #else
-# define ha_insert_for_fold(t,h,f,b,d) ha_insert_for_fold(t,h,f,d)
-# define ha_search_and_update_if_found(table,fold,data,new_block,new_data) \
-	ha_search_and_update_if_found(table,fold,data,new_data)
+# define ha_insert_for_fold(p,f,b,d) ha_insert_for_fold(p,f,d)
+# define ha_search_and_update_if_found(part,fold,data,new_block,new_data) \
+	ha_search_and_update_if_found(part,fold,data,new_data)
 #endif
 
 /** Updates a hash node reference when it has been unsuccessfully used in a
@@ -739,7 +752,7 @@ btr_search_update_hash_ref(
 			mem_heap_free(heap);
 		}
 
-		ha_insert_for_fold(&part->table, part->heap, fold, block, rec);
+		ha_insert_for_fold(part, fold, block, rec);
 
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 	}
@@ -971,14 +984,102 @@ inline buf_block_t* buf_pool_t::block_from_ahi(const byte *ptr) const
   /* buf_pool_t::chunk_t::init() invokes buf_block_init() so that
   block[n].frame == block->frame + n * srv_page_size.  Check it. */
   ut_ad(block->frame == page_align(ptr));
-  /* Read the state of the block without holding hash_lock.
-  A state transition from BUF_BLOCK_FILE_PAGE to
-  BUF_BLOCK_REMOVE_HASH is possible during this execution. */
-  ut_d(const buf_page_state state = block->page.state());
-  ut_ad(state == BUF_BLOCK_FILE_PAGE || state == BUF_BLOCK_REMOVE_HASH);
+  /* The state of the block is not checked here. If the adaptive hash
+  index latch is not being held, the block may have been freed after
+  the lookup; btr_search_guess_on_hash() checks it under hash_lock. */
   return block;
 }
 
+/** Registration of an adaptive hash index lookup that does not
+acquire the latch of the partition */
+class btr_search_reader
+{
+  /** the partition, or nullptr if the latch is being held */
+  btr_search_sys_t::partition *const part;
+public:
+  explicit btr_search_reader(btr_search_sys_t::partition *part) : part(part)
+  {
+    if (part)
+      part->n_readers.fetch_add(1);
+  }
+  ~btr_search_reader()
+  {
+    if (part)
+      part->n_readers.fetch_sub(1, std::memory_order_release);
+  }
+};
+
+/** Read a field of the adaptive hash index that a holder of the
+partition latch may be modifying concurrently.
+@param field  field of a partition or of a hash node
+@return the value of the field */
+template<typename T> static inline T ha_load_relaxed(const T &field)
+{
+  static_assert(sizeof(std::atomic<T>) == sizeof(T), "compatibility");
+  return reinterpret_cast<const std::atomic<T>&>(field).
+    load(std::memory_order_relaxed);
+}
+
+/** Number of attempts of a lookup that does not acquire the latch
+of the partition, when the partition is being modified concurrently */
+static constexpr unsigned BTR_SEARCH_LOCKFREE_ATTEMPTS= 4;
+
+/** Look up a record in an adaptive hash index partition without
+acquiring its latch. The caller must be registered in part.n_readers
+and must have checked btr_search_enabled after registering.
+If the partition is modified during the lookup, the lookup is retried.
+@param part  adaptive hash index partition
+@param fold  folded value of the searched data
+@param busy  set to whether the partition was being modified
+             during every attempt of the lookup
+@return the record
+@retval nullptr if not found */
+static const rec_t *ha_search_lockfree(const btr_search_sys_t::partition &part,
+                                       ulint fold, bool *busy)
+{
+  for (unsigned i= 0; i < BTR_SEARCH_LOCKFREE_ATTEMPTS; i++, ut_delay(1))
+  {
+    const uint32_t v= part.version.load(std::memory_order_acquire);
+    if (v & 1)
+      continue;
+
+    const hash_cell_t *array= ha_load_relaxed(part.table.array);
+    if (!part.validate(v))
+      continue;
+    if (!array)
+    {
+      *busy= false;
+      return nullptr;
+    }
+
+    /* A node may be freed while we are reading it. A pointer that was
+    read from a node is only followed after validate() has shown that
+    the partition was not modified meanwhile. */
+    const ha_node_t *node= static_cast<const ha_node_t*>(
+      ha_load_relaxed(array[part.table.calc_hash(fold)].node));
+    const rec_t *data= nullptr;
+
+    while (node && part.validate(v))
+    {
+      if (ha_load_relaxed(node->fold) == fold)
+      {
+        data= ha_load_relaxed(node->data);
+        break;
+      }
+      node= ha_load_relaxed(node->next);
+    }
+
+    if (part.validate(v))
+    {
+      *busy= false;
+      return data;
+    }
+  }
+
+  *busy= true;
+  return nullptr;
+}
+
 /** Tries to guess the right search position based on the hash search info
 of the index. Note that if mode is PAGE_CUR_LE, which is used in inserts,
 and the function returns TRUE, then cursor->up_match and cursor->low_match
@@ -1055,65 +1156,74 @@ btr_search_guess_on_hash(
 	cursor->flag = BTR_CUR_HASH;
 
 	auto part = btr_search_sys.get_part(*index);
+	/* Unless the caller is holding ahi_latch, the partition is
+	looked up without acquiring its latch, so that the lookup is
+	never blocked by a modification of the adaptive hash index. */
+	btr_search_reader reader(ahi_latch ? nullptr : part);
 	const rec_t* rec;
 
 	if (!ahi_latch) {
-		rw_lock_s_lock(&part->latch);
-
 		if (!btr_search_enabled) {
 			goto fail;
 		}
+
+		bool busy;
+		rec = ha_search_lockfree(*part, fold, &busy);
+
+		if (busy) {
+			goto busy;
+		}
 	} else {
 		ut_ad(btr_search_enabled);
 		ut_ad(rw_lock_own(ahi_latch, RW_LOCK_S));
-	}
 
-	rec = static_cast<const rec_t*>(
-		ha_search_and_get_data(&part->table, fold));
+		rec = static_cast<const rec_t*>(
+			ha_search_and_get_data(&part->table, fold));
+	}
 
 	if (!rec) {
-		if (!ahi_latch) {
 fail:
-			rw_lock_s_unlock(&part->latch);
-		}
-
 		btr_search_failure(info, cursor);
 		return false;
+busy:
+		/* The adaptive hash index or the page is being modified
+		concurrently. Fall back to a search in the B-tree without
+		counting this as a failure of the adaptive hash index, so
+		that the hash reference of the index is not rebuilt. */
+		cursor->flag = BTR_CUR_BINARY;
+		return false;
 	}
 
 	buf_block_t* block = buf_pool.block_from_ahi(rec);
 
 	if (!ahi_latch) {
-		page_hash_latch* hash_lock = buf_pool.hash_lock_get(
-			block->page.id());
-		hash_lock->read_lock();
-
-		if (block->page.state() == BUF_BLOCK_REMOVE_HASH) {
-			/* Another thread is just freeing the block
-			from the LRU list of the buffer pool: do not
-			try to access this page. */
-			hash_lock->read_unlock();
-			goto fail;
+		const page_id_t id(block->page.id());
+		page_hash_latch* hash_lock = buf_pool.hash_lock_get(id);
+
+		if (!hash_lock->read_trylock()) {
+			goto busy;
 		}
 
-		const bool fail = index != block->index
-			&& index_id == block->index->id;
-		ut_a(!fail || block->index->freed());
-		ut_ad(block->page.state() == BUF_BLOCK_FILE_PAGE);
-		DBUG_ASSERT(fail || block->page.status != buf_page_t::FREED);
+		if (block->page.state() != BUF_BLOCK_FILE_PAGE
+		    || block->page.id() != id) {
+			/* The block was freed after the lookup, or
+			another thread is just freeing it from the LRU
+			list of the buffer pool: do not try to access
+			this page. */
+			hash_lock->read_unlock();
+			goto busy;
+		}
 
 		buf_block_buf_fix_inc(block, __FILE__, __LINE__);
 		hash_lock->read_unlock();
-		block->page.set_accessed();
 
-		buf_page_make_young_if_needed(&block->page);
 		mtr_memo_type_t	fix_type;
 		if (latch_mode == BTR_SEARCH_LEAF) {
 			if (!rw_lock_s_lock_nowait(&block->lock,
 						   __FILE__, __LINE__)) {
 got_no_latch:
 				buf_block_buf_fix_dec(block);
-				goto fail;
+				goto busy;
 			}
 			fix_type = MTR_MEMO_PAGE_S_FIX;
 		} else {
@@ -1125,12 +1235,36 @@ btr_search_guess_on_hash(
 		}
 		mtr->memo_push(block, fix_type);
 
-		buf_pool.stat.n_page_gets++;
+		/* The adaptive hash index entries of a page are removed
+		while the page is exclusively latched, before its records
+		are moved or the page is freed. If fold still maps to rec
+		now that we are holding the page latch, rec is a record of
+		the page, no matter which other entries of the partition
+		were modified since the lookup. */
+		const dict_index_t* block_index = block->index;
+		bool busy;
+		const rec_t* latched_rec = ha_search_lockfree(*part, fold,
+							      &busy);
+
+		if (UNIV_UNLIKELY(busy)) {
+			btr_leaf_page_release(block, latch_mode, mtr);
+			goto busy;
+		}
 
-		rw_lock_s_unlock(&part->latch);
+		if (latched_rec != rec) {
+			goto fail_and_release_page;
+		}
+
+		block->page.set_accessed();
+		buf_page_make_young_if_needed(&block->page);
+		buf_pool.stat.n_page_gets++;
 
 		buf_block_dbg_add_level(block, SYNC_TREE_NODE_FROM_HASH);
-		if (UNIV_UNLIKELY(fail)) {
+		DBUG_ASSERT(block->page.status != buf_page_t::FREED);
+
+		if (UNIV_UNLIKELY(index != block_index)) {
+			/* The page belongs to another index, or
+			to a freed index with the same index_id. */
 			goto fail_and_release_page;
 		}
 	} else if (UNIV_UNLIKELY(index != block->index
@@ -1371,8 +1505,7 @@ void btr_search_drop_page_hash_index(buf_block_t* block)
 	}
 
 	for (i = 0; i < n_cached; i++) {
-		ha_remove_all_nodes_to_page(&part->table, part->heap,
-					    folds[i], page);
+		ha_remove_all_nodes_to_page(part, folds[i], page);
 	}
 
 	switch (index->search_info->ref_count--) {
@@ -1633,8 +1766,7 @@ btr_search_build_page_hash_index(
 	{
 		auto part = btr_search_sys.get_part(*index);
 		for (ulint i = 0; i < n_cached; i++) {
-			ha_insert_for_fold(&part->table, part->heap,
-					   folds[i], block, recs[i]);
+			ha_insert_for_fold(part, folds[i], block, recs[i]);
 		}
 	}
 
@@ -1823,8 +1955,7 @@ void btr_search_update_hash_on_delete(btr_cur_t* cursor)
 	if (block->index && btr_search_enabled) {
 		ut_a(block->index == index);
 
-		if (ha_search_and_delete_if_found(&part->table, part->heap,
-						  fold, rec)) {
+		if (ha_search_and_delete_if_found(part, fold, rec)) {
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_REMOVED);
 		} else {
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND);
@@ -1888,7 +2019,7 @@ btr_search_update_hash_node_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 	    && !block->curr_left_side) {
 
 		if (ha_search_and_update_if_found(
-			&btr_search_sys.get_part(*cursor->index)->table,
+			btr_search_sys.get_part(*cursor->index),
 			cursor->fold, rec, block,
 			page_rec_get_next(rec))) {
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_UPDATED);
@@ -1999,8 +2130,7 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 			}
 
 			part = btr_search_sys.get_part(*index);
-			ha_insert_for_fold(&part->table, part->heap,
-					   ins_fold, block, ins_rec);
+			ha_insert_for_fold(part, ins_fold, block, ins_rec);
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 		}
 
@@ -2020,11 +2150,9 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 		}
 
 		if (!left_side) {
-			ha_insert_for_fold(&part->table, part->heap,
-					   fold, block, rec);
+			ha_insert_for_fold(part, fold, block, rec);
 		} else {
-			ha_insert_for_fold(&part->table, part->heap,
-					   ins_fold, block, ins_rec);
+			ha_insert_for_fold(part, ins_fold, block, ins_rec);
 		}
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 	}
@@ -2043,8 +2171,7 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 				part = btr_search_sys.get_part(*index);
 			}
 
-			ha_insert_for_fold(&part->table, part->heap,
-					   ins_fold, block, ins_rec);
+			ha_insert_for_fold(part, ins_fold, block, ins_rec);
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 		}
 
@@ -2063,11 +2190,9 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 		}
 
 		if (!left_side) {
-			ha_insert_for_fold(&part->table, part->heap,
-					   ins_fold, block, ins_rec);
+			ha_insert_for_fold(part, ins_fold, block, ins_rec);
 		} else {
-			ha_insert_for_fold(&part->table, part->heap,
-					   next_fold, block, next_rec);
+			ha_insert_for_fold(part, next_fold, block, next_rec);
 		}
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 	}
@@ -49,6 +49,7 @@ Created 11/11/1995 Heikki Tuuri
 #include "srv0mon.h"
 #include "ut0stage.h"
 #include "fil0pagecompress.h"
+#include <vector>
 #ifdef UNIV_LINUX
 /* include defs for CPU time priority settings */
 #include <unistd.h>
@@ -98,8 +99,11 @@ mysql_pfs_key_t page_cleaner_thread_key;
 /** Event to synchronise with the flushing. */
 os_event_t	buf_flush_event;
 
+/** Maximum number of page cleaner slots */
+static const ulint PAGE_CLEANER_SLOTS_MAX = 64;
+
 static void pc_flush_slot_func(void *);
-static tpool::task_group page_cleaner_task_group(1);
+static tpool::task_group page_cleaner_task_group(PAGE_CLEANER_SLOTS_MAX - 1);
 static tpool::waitable_task pc_flush_slot_task(
 	pc_flush_slot_func, 0, &page_cleaner_task_group);
 
@@ -123,10 +127,13 @@ struct page_cleaner_slot_t {
 					set to PAGE_CLEANER_STATE_FLUSHING,
 					n_flushed_lru and n_flushed_list can be
 					updated only by the worker thread */
-	/* This value is set during state==PAGE_CLEANER_STATE_NONE */
+	/* These values are set during state==PAGE_CLEANER_STATE_NONE */
 	ulint			n_pages_requested;
 					/*!< number of requested pages
 					for the slot */
+	std::vector<page_id_t>	pages;	/*!< dirty blocks from the end of
+					buf_pool.flush_list that belong to
+					the partition of this slot */
 	/* These values are updated during state==PAGE_CLEANER_STATE_FLUSHING,
 	and commited with state==PAGE_CLEANER_STATE_FINISHED.
 	The consistency is protected by the 'state' */
@@ -136,9 +143,6 @@ struct page_cleaner_slot_t {
 	ulint			n_flushed_list;
 					/*!< number of flushed pages
 					by flush_list flushing */
-	bool			succeeded_list;
-					/*!< true if flush_list flushing
-					succeeded. */
 	ulint			flush_lru_time;
 					/*!< elapsed time for LRU flushing */
 	ulint			flush_list_time;
@@ -161,8 +165,15 @@ struct page_cleaner_t {
 						slots were finished. */
 	bool			requested;	/*!< true if requested pages
 						to flush */
+	bool			succeeded_list;	/*!< true if the flush_list
+						batch could be started */
+	ulint			n_pages_requested;
+						/*!< number of requested pages
+						for all slots */
 	lsn_t			lsn_limit;	/*!< upper limit of LSN to be
 						flushed */
+	ulint			n_slots;	/*!< number of slots in use
+						for the current request */
 #if 1 /* FIXME: use bool for these, or remove some of these */
 	ulint			n_slots_requested;
 						/*!< number of slots
@@ -181,7 +192,11 @@ struct page_cleaner_t {
 						requests for all slots */
 	ulint			flush_pass;	/*!< count to finish to flush
 						requests for all slots */
-	page_cleaner_slot_t	slot;
+	page_cleaner_slot_t	slots[PAGE_CLEANER_SLOTS_MAX];
+						/*!< slot 0 also flushes
+						the LRU list; the dirty blocks
+						are partitioned between the
+						slots by buf_flush_list_collect() */
 	bool			is_running;	/*!< false if attempt
 						to shutdown */
 };
@@ -1659,6 +1674,104 @@ static ulint buf_do_flush_list_batch(ulint min_n, lsn_t lsn_limit)
   return count;
 }
 
+/** Collect dirty blocks from the end of the flush_list for a flush_list
+batch that is executed by several threads. The blocks are partitioned by
+a hash of the tablespace and of the neighborhood of the page that
+buf_flush_try_neighbors() may flush along with it, so that neighbors are
+flushed by the same thread while the pages of a single tablespace are
+spread over all threads.
+The caller must have started the batch by buf_flush_start(false), so that
+buf_pool.flush_hp is not being used by anyone else.
+@param[in]	min_n		wished minimum number of blocks to collect
+@param[in]	lsn_limit	all blocks whose oldest_modification is smaller
+than this should be collected (if their number does not exceed min_n)
+@param[out]	parts		partitions to append the blocks to
+@param[in]	n_parts		number of partitions
+@return number of collected blocks */
+static ulint buf_flush_list_collect(ulint min_n, lsn_t lsn_limit,
+                                    std::vector<page_id_t> **parts,
+                                    ulint n_parts)
+{
+  ulint scanned= 0;
+  /* The size of a neighborhood, see buf_flush_check_neighbors() */
+  const uint32_t area= std::max<uint32_t>(
+    1, std::min<uint32_t>(buf_pool.read_ahead_area,
+                          static_cast<uint32_t>(buf_pool.curr_size / 16)));
+
+  mutex_enter(&buf_pool.flush_list_mutex);
+  ulint len= UT_LIST_GET_LEN(buf_pool.flush_list);
+
+  for (buf_page_t *bpage= UT_LIST_GET_LAST(buf_pool.flush_list);
+       bpage && len && scanned < min_n; len--)
+  {
+    const lsn_t oldest_modification= bpage->oldest_modification();
+    if (oldest_modification >= lsn_limit)
+      break;
+    ut_a(oldest_modification);
+
+    const page_id_t id(bpage->id());
+    parts[ut_fold_ulint_pair(id.space(), id.page_no() / area) % n_parts]->
+      push_back(id);
+    bpage= UT_LIST_GET_PREV(list, bpage);
+
+    if (!(++scanned % 1024) && bpage)
+    {
+      /* Let mini-transactions add blocks to the flush_list. */
+      buf_pool.flush_hp.set(bpage);
+      mutex_exit(&buf_pool.flush_list_mutex);
+      mutex_enter(&buf_pool.flush_list_mutex);
+      bpage= buf_pool.flush_hp.get();
+    }
+  }
+
+  buf_pool.flush_hp.set(nullptr);
+  mutex_exit(&buf_pool.flush_list_mutex);
+
+  if (scanned)
+    MONITOR_INC_VALUE_CUMULATIVE(MONITOR_FLUSH_BATCH_SCANNED,
+                                 MONITOR_FLUSH_BATCH_SCANNED_NUM_CALL,
+                                 MONITOR_FLUSH_BATCH_SCANNED_PER_CALL,
+                                 scanned);
+  return scanned;
+}
+
+/** Flush a partition of the blocks that were collected by
+buf_flush_list_collect(). Blocks that were written or evicted since
+they were collected are skipped.
+The calling thread is not allowed to own any latches on pages!
+@param[in]	pages		identifiers of the collected blocks
+@param[in]	n_to_flush	maximum number of blocks to flush,
+including the flushed neighbors
+@return number of blocks for which the write request was queued */
+static ulint buf_flush_list_partition(const std::vector<page_id_t> &pages,
+                                      ulint n_to_flush)
+{
+  ulint count= 0;
+
+  for (const page_id_t id : pages)
+  {
+    if (count >= n_to_flush)
+      break;
+
+    /* Skip the blocks that are clean or being written. This is only
+    a hint, checked under the page_hash latch so that the threads do not
+    contend on buf_pool.mutex; buf_flush_try_neighbors() checks the
+    block again. */
+    page_hash_latch *hash_lock= buf_pool.hash_lock_get(id);
+    hash_lock->read_lock();
+    const buf_page_t *bpage= buf_pool.page_hash_get_low(id, id.fold());
+    const bool flush= bpage && !buf_pool.watch_is_sentinel(*bpage) &&
+      bpage->oldest_modification() && bpage->io_fix() == BUF_IO_NONE;
+    hash_lock->read_unlock();
+
+    if (flush)
+      count+= buf_flush_try_neighbors(id, IORequest::FLUSH_LIST,
+                                      count, n_to_flush);
+  }
+
+  return count;
+}
+
 /** This utility flushes dirty blocks from the end of the LRU list or
 flush_list.
 NOTE 1: in the case of an LRU flush the calling thread may own latches to
@@ -2134,14 +2247,21 @@ page_cleaner_flush_pages_recommendation(ulint last_pages_in)
 		page_cleaner.flush_time = 0;
 		page_cleaner.flush_pass = 0;
 
-		ulint	lru_tm = page_cleaner.slot.flush_lru_time;
-		ulint	list_tm = page_cleaner.slot.flush_list_time;
-		ulint	lru_pass = page_cleaner.slot.flush_lru_pass;
-		ulint	list_pass = page_cleaner.slot.flush_list_pass;
-		page_cleaner.slot.flush_lru_time  = 0;
-		page_cleaner.slot.flush_lru_pass  = 0;
-		page_cleaner.slot.flush_list_time = 0;
-		page_cleaner.slot.flush_list_pass = 0;
+		ulint	lru_tm = 0;
+		ulint	list_tm = 0;
+		ulint	lru_pass = 0;
+		ulint	list_pass = 0;
+
+		for (page_cleaner_slot_t& slot : page_cleaner.slots) {
+			lru_tm += slot.flush_lru_time;
+			list_tm += slot.flush_list_time;
+			lru_pass += slot.flush_lru_pass;
+			list_pass += slot.flush_list_pass;
+			slot.flush_lru_time  = 0;
+			slot.flush_lru_pass  = 0;
+			slot.flush_list_time = 0;
+			slot.flush_list_pass = 0;
+		}
 		mutex_exit(&page_cleaner.mutex);
 
 		/* minimum values are 1, to avoid dividing by zero. */
@@ -2222,8 +2342,8 @@ page_cleaner_flush_pages_recommendation(ulint last_pages_in)
 	mutex_exit(&buf_pool.flush_list_mutex);
 
 	mutex_enter(&page_cleaner.mutex);
-	ut_ad(page_cleaner.slot.state == PAGE_CLEANER_STATE_NONE);
-	page_cleaner.slot.n_pages_requested
+	ut_ad(page_cleaner.n_slots_requested == 0);
+	page_cleaner.n_pages_requested
 		= pages_for_lsn / buf_flush_lsn_scan_factor + 1;
 	mutex_exit(&page_cleaner.mutex);
 
@@ -2252,10 +2372,10 @@ page_cleaner_flush_pages_recommendation(ulint last_pages_in)
 	/* if REDO has enough of free space,
 	don't care about age distribution of pages */
 	if (pct_for_lsn > 30) {
-		page_cleaner.slot.n_pages_requested *= n_pages
+		page_cleaner.n_pages_requested *= n_pages
 			/ pages_for_lsn + 1;
 	} else {
-		page_cleaner.slot.n_pages_requested = n_pages;
+		page_cleaner.n_pages_requested = n_pages;
 	}
 	mutex_exit(&page_cleaner.mutex);
 
@@ -2318,31 +2438,70 @@ Requests for all slots to flush.
 */
 static void pc_request(ulint min_n, lsn_t lsn_limit)
 {
+	ulint	n_slots = 1;
+
+	if (min_n == 0 || min_n == ULINT_MAX) {
+		page_cleaner.n_pages_requested = min_n;
+	}
+
+	/* page_cleaner.n_pages_requested was already set by
+	page_cleaner_flush_pages_recommendation() */
+
+	/* The flush_list batch is started here on behalf of all slots.
+	The dirty blocks at the end of buf_pool.flush_list are
+	partitioned by tablespace and neighborhood, so that each block
+	and its neighbors are flushed by the same slot. */
+	const bool	started = min_n > 0 && buf_flush_start(false);
+
+	if (started) {
+		std::vector<page_id_t>*	parts[PAGE_CLEANER_SLOTS_MAX];
+
+		n_slots = std::min<ulint>(srv_n_page_cleaners,
+					  PAGE_CLEANER_SLOTS_MAX);
+
+		for (ulint i = 0; i < n_slots; i++) {
+			ut_ad(page_cleaner.slots[i].pages.empty());
+			parts[i] = &page_cleaner.slots[i].pages;
+		}
+
+		buf_flush_list_collect(page_cleaner.n_pages_requested,
+				       lsn_limit, parts, n_slots);
+	}
+
 	mutex_enter(&page_cleaner.mutex);
 
 	ut_ad(page_cleaner.n_slots_requested == 0);
 	ut_ad(page_cleaner.n_slots_flushing == 0);
 	ut_ad(page_cleaner.n_slots_finished == 0);
 
-	page_cleaner.requested = (min_n > 0);
+	page_cleaner.requested = started;
+	page_cleaner.succeeded_list = started || min_n == 0;
 	page_cleaner.lsn_limit = lsn_limit;
+	page_cleaner.n_slots = n_slots;
 
-	ut_ad(page_cleaner.slot.state == PAGE_CLEANER_STATE_NONE);
-
-	if (min_n == 0 || min_n == ULINT_MAX) {
-		page_cleaner.slot.n_pages_requested = min_n;
-	}
+	for (ulint i = 0; i < n_slots; i++) {
+		page_cleaner_slot_t&	slot = page_cleaner.slots[i];
 
-	/* page_cleaner.slot.n_pages_requested was already set by
-	page_cleaner_flush_pages_recommendation() */
+		ut_ad(slot.state == PAGE_CLEANER_STATE_NONE);
 
-	page_cleaner.slot.state = PAGE_CLEANER_STATE_REQUESTED;
+		/* The neighbors that are flushed along with the
+		collected blocks count towards the share of the slot. */
+		slot.n_pages_requested
+			= page_cleaner.n_pages_requested == ULINT_MAX
+			? ULINT_MAX : slot.pages.size();
+		slot.state = PAGE_CLEANER_STATE_REQUESTED;
+	}
 
-	page_cleaner.n_slots_requested = 1;
+	page_cleaner.n_slots_requested = n_slots;
 	page_cleaner.n_slots_flushing = 0;
 	page_cleaner.n_slots_finished = 0;
 
 	mutex_exit(&page_cleaner.mutex);
+
+	/* The coordinator flushes slots as well. */
+	for (ulint i = 1; i < n_slots; i++) {
+		srv_thread_pool->submit_task(&pc_flush_slot_task);
+	}
 }
 
 /**
@@ -2358,63 +2517,65 @@ static ulint pc_flush_slot()
 	mutex_enter(&page_cleaner.mutex);
 
 	if (page_cleaner.n_slots_requested) {
-		ut_ad(page_cleaner.slot.state == PAGE_CLEANER_STATE_REQUESTED);
+		page_cleaner_slot_t*	slot = page_cleaner.slots;
+
+		while (slot->state != PAGE_CLEANER_STATE_REQUESTED) {
+			slot++;
+			ut_ad(slot < page_cleaner.slots + page_cleaner.n_slots);
+		}
+
 		page_cleaner.n_slots_requested--;
 		page_cleaner.n_slots_flushing++;
-		page_cleaner.slot.state = PAGE_CLEANER_STATE_FLUSHING;
+		slot->state = PAGE_CLEANER_STATE_FLUSHING;
 
 		if (UNIV_UNLIKELY(!page_cleaner.is_running)) {
-			page_cleaner.slot.n_flushed_lru = 0;
-			page_cleaner.slot.n_flushed_list = 0;
+			slot->n_flushed_lru = 0;
+			slot->n_flushed_list = 0;
 			goto finish_mutex;
 		}
 
 		mutex_exit(&page_cleaner.mutex);
 
-		lru_tm = ut_time_ms();
+		if (slot == page_cleaner.slots) {
+			lru_tm = ut_time_ms();
 
-		/* Flush pages from end of LRU if required */
-		page_cleaner.slot.n_flushed_lru = buf_flush_LRU_list();
+			/* Flush pages from end of LRU if required */
+			slot->n_flushed_lru = buf_flush_LRU_list();
 
-		lru_tm = ut_time_ms() - lru_tm;
-		lru_pass++;
+			lru_tm = ut_time_ms() - lru_tm;
+			lru_pass++;
+		} else {
+			slot->n_flushed_lru = 0;
+		}
 
 		if (UNIV_UNLIKELY(!page_cleaner.is_running)) {
-			page_cleaner.slot.n_flushed_list = 0;
+			slot->n_flushed_list = 0;
 			goto finish;
 		}
 
 		/* Flush pages from flush_list if required */
 		if (page_cleaner.requested) {
-			flush_counters_t n;
-			memset(&n, 0, sizeof(flush_counters_t));
 			list_tm = ut_time_ms();
 
-			page_cleaner.slot.succeeded_list = buf_flush_do_batch(
-				false,
-				page_cleaner.slot.n_pages_requested,
-				page_cleaner.lsn_limit,
-				&n);
-
-			page_cleaner.slot.n_flushed_list = n.flushed;
+			slot->n_flushed_list = buf_flush_list_partition(
+				slot->pages, slot->n_pages_requested);
 
 			list_tm = ut_time_ms() - list_tm;
 			list_pass++;
 		} else {
-			page_cleaner.slot.n_flushed_list = 0;
-			page_cleaner.slot.succeeded_list = true;
+			slot->n_flushed_list = 0;
 		}
 finish:
 		mutex_enter(&page_cleaner.mutex);
 finish_mutex:
 		page_cleaner.n_slots_flushing--;
 		page_cleaner.n_slots_finished++;
-		page_cleaner.slot.state = PAGE_CLEANER_STATE_FINISHED;
+		slot->state = PAGE_CLEANER_STATE_FINISHED;
 
-		page_cleaner.slot.flush_lru_time += lru_tm;
-		page_cleaner.slot.flush_list_time += list_tm;
-		page_cleaner.slot.flush_lru_pass += lru_pass;
-		page_cleaner.slot.flush_list_pass += list_pass;
+		slot->flush_lru_time += lru_tm;
+		slot->flush_list_time += list_tm;
+		slot->flush_lru_pass += lru_pass;
+		slot->flush_list_pass += list_pass;
 
 		if (page_cleaner.n_slots_requested == 0
 		    && page_cleaner.n_slots_flushing == 0) {
@@ -2452,21 +2613,43 @@ pc_wait_finished(
 
 	ut_ad(page_cleaner.n_slots_requested == 0);
 	ut_ad(page_cleaner.n_slots_flushing == 0);
-	ut_ad(page_cleaner.n_slots_finished == 1);
+	ut_ad(page_cleaner.n_slots_finished == page_cleaner.n_slots);
+
+	for (ulint i = 0; i < page_cleaner.n_slots; i++) {
+		page_cleaner_slot_t&	slot = page_cleaner.slots[i];
+
+		ut_ad(slot.state == PAGE_CLEANER_STATE_FINISHED);
+		slot.state = PAGE_CLEANER_STATE_NONE;
+		*n_flushed_lru += slot.n_flushed_lru;
+		*n_flushed_list += slot.n_flushed_list;
+		slot.n_pages_requested = 0;
+		slot.pages.clear();
+	}
 
-	ut_ad(page_cleaner.slot.state == PAGE_CLEANER_STATE_FINISHED);
-	page_cleaner.slot.state = PAGE_CLEANER_STATE_NONE;
-	*n_flushed_lru = page_cleaner.slot.n_flushed_lru;
-	*n_flushed_list = page_cleaner.slot.n_flushed_list;
-	all_succeeded = page_cleaner.slot.succeeded_list;
-	page_cleaner.slot.n_pages_requested = 0;
+	all_succeeded = page_cleaner.succeeded_list;
+	page_cleaner.n_pages_requested = 0;
 
 	page_cleaner.n_slots_finished = 0;
 
 	os_event_reset(page_cleaner.is_finished);
 
+	const bool	started = page_cleaner.requested;
+	page_cleaner.requested = false;
+
 	mutex_exit(&page_cleaner.mutex);
 
+	if (started) {
+		buf_flush_end(false);
+
+		if (*n_flushed_list) {
+			MONITOR_INC_VALUE_CUMULATIVE(
+				MONITOR_FLUSH_BATCH_TOTAL_PAGE,
+				MONITOR_FLUSH_BATCH_COUNT,
+				MONITOR_FLUSH_BATCH_PAGES,
+				*n_flushed_list);
+		}
+	}
+
 	return(all_succeeded);
 }
 
@@ -2840,6 +3023,8 @@ static os_thread_ret_t DECLARE_THREAD(buf_flush_page_cleaner)(void*)
 
 thread_exit:
 	page_cleaner.is_running = false;
+	/* Wait for any pc_flush_slot_task that was submitted late. */
+	pc_flush_slot_task.wait();
 	mutex_destroy(&page_cleaner.mutex);
 
 	os_event_destroy(page_cleaner.is_finished);
@@ -100,6 +100,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "row0ins.h"
 #include "row0merge.h"
 #include "row0mysql.h"
+#include "row0pread.h"
 #include "row0quiesce.h"
 #include "row0sel.h"
 #include "row0upd.h"
@@ -122,7 +123,6 @@ this program; if not, write to the Free Software Foundation, Inc.,
 
 #define thd_get_trx_isolation(X) ((enum_tx_isolation)thd_tx_isolation(X))
 
-extern "C" void thd_mark_transaction_to_rollback(MYSQL_THD thd, bool all);
 unsigned long long thd_get_query_id(const MYSQL_THD thd);
 void thd_clear_error(MYSQL_THD thd);
 
@@ -528,7 +528,6 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(trx_pool_mutex),
 	PSI_KEY(trx_pool_manager_mutex),
 	PSI_KEY(srv_sys_mutex),
-	PSI_KEY(lock_mutex),
 	PSI_KEY(lock_wait_mutex),
 	PSI_KEY(trx_mutex),
 	PSI_KEY(srv_threads_mutex),
@@ -555,6 +554,7 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	PSI_RWLOCK_KEY(buf_block_debug_latch),
 #  endif /* UNIV_DEBUG */
 	PSI_RWLOCK_KEY(dict_operation_lock),
+	PSI_RWLOCK_KEY(lock_latch),
 	PSI_RWLOCK_KEY(fil_space_latch),
 	PSI_RWLOCK_KEY(fts_cache_rw_lock),
 	PSI_RWLOCK_KEY(fts_cache_init_rw_lock),
@@ -958,6 +958,8 @@ static SHOW_VAR innodb_status_variables[]= {
   {"pages_created", &export_vars.innodb_pages_created, SHOW_SIZE_T},
   {"pages_read", &export_vars.innodb_pages_read, SHOW_SIZE_T},
   {"pages_written", &export_vars.innodb_pages_written, SHOW_SIZE_T},
+  {"purge_pages", &srv_stats.n_purge_pages, SHOW_SIZE_T},
+  {"purge_records", &srv_stats.n_purge_recs, SHOW_SIZE_T},
   {"row_lock_current_waits", &export_vars.innodb_row_lock_current_waits,
    SHOW_SIZE_T},
   {"row_lock_time", &export_vars.innodb_row_lock_time, SHOW_LONGLONG},
@@ -2474,6 +2476,7 @@ ha_innobase::ha_innobase(
                           | HA_CAN_TABLES_WITHOUT_ROLLBACK
                           | HA_CAN_ONLINE_BACKUPS
 			  | HA_CONCURRENT_OPTIMIZE
+			  | HA_HAS_RECORDS
 			  |  (srv_force_primary_key ? HA_REQUIRE_PRIMARY_KEY : 0)
 		  ),
 	m_start_of_scan(),
@@ -3494,6 +3497,10 @@ static int innodb_init_params()
 	if (srv_use_native_aio) {
 		ib::info() << "Using Linux native AIO";
 	}
+#elif defined HAVE_URING
+	if (srv_use_native_aio) {
+		ib::info() << "Using liburing";
+	}
 #elif !defined _WIN32
 	/* Currently native AIO is supported only on windows and linux
 	and that also when the support is compiled in. In all other
@@ -8733,6 +8740,8 @@ ha_innobase::change_active_index(
 
 	build_template(false);
 
+	row_sel_set_fetch_cache_size(m_prebuilt, estimation_rows_to_read);
+
 	DBUG_RETURN(0);
 }
 
@@ -13634,6 +13643,55 @@ ha_innobase::estimate_rows_upper_bound()
 	DBUG_RETURN((ha_rows) estimate);
 }
 
+/*********************************************************************//**
+Counts the rows of the table that are visible in the read view of the
+transaction, by scanning key ranges of the clustered index in parallel.
+This is used for COUNT(*) without a WHERE condition.
+@return number of rows, or HA_POS_ERROR if the rows must be read by
+the SQL layer */
+
+ha_rows
+ha_innobase::records()
+/*===================*/
+{
+	DBUG_ENTER("ha_innobase::records");
+
+	update_thd(ha_thd());
+
+	dict_table_t*	table = m_prebuilt->table;
+	dict_index_t*	index = dict_table_get_first_index(table);
+	trx_t*		trx = m_prebuilt->trx;
+
+	/* Locking reads and tables without MVCC are left to the
+	SQL layer, as well as a single thread, for which a parallel
+	scan has no advantage over an ordinary table scan. EXPLAIN
+	shows the plan of reading the rows and must not count them. */
+	if (srv_parallel_read_threads <= 1
+	    || ha_thd()->lex->describe
+	    || m_prebuilt->select_lock_type != LOCK_NONE
+	    || table->is_temporary()
+	    || table->no_rollback()
+	    || !table->is_readable()
+	    || !index
+	    || index->is_corrupted()
+	    || srv_read_only_mode) {
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	trx_start_if_not_started(trx, false);
+	trx->read_view.open(trx);
+
+	trx->op_info = "counting rows";
+
+	ulint	n_rows;
+	dberr_t	err = row_count_parallel(trx, index,
+					 srv_parallel_read_threads, &n_rows);
+
+	trx->op_info = "";
+
+	DBUG_RETURN(err == DB_SUCCESS ? ha_rows(n_rows) : HA_POS_ERROR);
+}
+
 /*********************************************************************//**
 How many seeks it will take to read through the table. This is to be
 comparable to the number returned by records_in_range so that we can
@@ -15172,6 +15230,60 @@ ha_innobase::extra(
 	return(0);
 }
 
+/** Start a multi-row INSERT, INSERT...SELECT or LOAD DATA.
+If the table is empty, the index entries will be buffered and sorted,
+and the indexes will be built by end_bulk_insert().
+@param[in]	rows	estimated number of rows (unused)
+@param[in]	flags	unused */
+void ha_innobase::start_bulk_insert(ha_rows, uint)
+{
+	DBUG_ENTER("ha_innobase::start_bulk_insert");
+	ut_ad(!m_prebuilt->bulk_store);
+	m_prebuilt->bulk_insert = true;
+	DBUG_VOID_RETURN;
+}
+
+/** End a bulk insert, and build the indexes from any buffered
+index entries.
+@return error code */
+int ha_innobase::end_bulk_insert()
+{
+	DBUG_ENTER("ha_innobase::end_bulk_insert");
+
+	m_prebuilt->bulk_insert = false;
+
+	row_merge_bulk_t*	bulk = m_prebuilt->bulk_store;
+
+	if (!bulk) {
+		DBUG_RETURN(0);
+	}
+
+	m_prebuilt->bulk_store = NULL;
+
+	trx_t*	trx = m_prebuilt->trx;
+	dberr_t	error = DB_SUCCESS;
+
+	/* If the transaction was rolled back, the TRX_UNDO_EMPTY
+	record is gone, and the buffered entries must be discarded. */
+	if (trx->is_bulk_insert(m_prebuilt->table)) {
+		trx->op_info = "building indexes of an empty table";
+		error = bulk->apply(trx, table);
+		trx->op_info = "";
+	}
+
+	UT_DELETE(bulk);
+
+	int	err = convert_error_code_to_mysql(
+		error, m_prebuilt->table->flags, m_user_thd);
+
+	if (err) {
+		/* The caller reports my_errno. */
+		my_errno = err;
+	}
+
+	DBUG_RETURN(err);
+}
+
 /**
 MySQL calls this method at the end of each statement */
 int
@@ -15181,6 +15293,10 @@ ha_innobase::reset()
 		row_mysql_prebuilt_free_blob_heap(m_prebuilt);
 	}
 
+	/* end_bulk_insert() must have been called. */
+	ut_ad(!m_prebuilt->bulk_store);
+	m_prebuilt->bulk_insert = false;
+
 	reset_template();
 
 	m_ds_mrr.dsmrr_close();
@@ -19076,6 +19192,23 @@ static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(ddl_threads, srv_ddl_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads for sorting and building non-unique secondary"
+  " indexes in ALTER TABLE",
+  NULL, NULL, 1, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(parallel_read_threads, srv_parallel_read_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads for counting the rows of a table in"
+  " SELECT COUNT(*) without a WHERE condition (1=disable)",
+  NULL, NULL, 1, 1, 256, 0);
+
+static MYSQL_SYSVAR_ULONG(page_cleaners, srv_n_page_cleaners,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of page cleaner threads that flush dirty pages in parallel",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
@@ -19125,6 +19258,12 @@ static MYSQL_SYSVAR_ULONG(log_write_ahead_size, srv_log_write_ahead_size,
   NULL, innodb_log_write_ahead_size_update,
   8*1024L, OS_FILE_LOG_BLOCK_SIZE, UNIV_PAGE_SIZE_DEF, OS_FILE_LOG_BLOCK_SIZE);
 
+static MYSQL_SYSVAR_BOOL(log_writer_threads, srv_log_writer_threads,
+  PLUGIN_VAR_OPCMDARG,
+  "Whether dedicated threads write and flush the redo log, while the"
+  " committing threads wait for them",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_UINT(old_blocks_pct, innobase_old_blocks_pct,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of the buffer pool to reserve for 'old' blocks.",
@@ -19596,6 +19735,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(log_buffer_size),
   MYSQL_SYSVAR(log_file_size),
   MYSQL_SYSVAR(log_write_ahead_size),
+  MYSQL_SYSVAR(log_writer_threads),
   MYSQL_SYSVAR(log_group_home_dir),
   MYSQL_SYSVAR(max_dirty_pages_pct),
   MYSQL_SYSVAR(max_dirty_pages_pct_lwm),
@@ -19630,6 +19770,9 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(status_file),
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(ddl_threads),
+  MYSQL_SYSVAR(parallel_read_threads),
+  MYSQL_SYSVAR(page_cleaners),
   MYSQL_SYSVAR(online_alter_log_max_size),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
@@ -20902,6 +21045,18 @@ static void innodb_remember_check_sysvar_funcs()
 
 static const size_t MAX_BUF_SIZE = 4 * 1024;
 
+/** Warn that a statement or savepoint rollback rolled back the whole
+transaction, because it covered rows that were inserted into an empty
+table without undo logging them individually.
+@param thd  thread handle */
+void innodb_bulk_insert_rollback_warning(THD *thd)
+{
+	push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+			    ER_WARN_ENGINE_TRANSACTION_ROLLBACK,
+			    ER_THD(thd, ER_WARN_ENGINE_TRANSACTION_ROLLBACK),
+			    innobase_hton_name);
+}
+
 /********************************************************************//**
 Helper function to push warnings from InnoDB internals to SQL-layer. */
 UNIV_INTERN
@@ -177,6 +177,10 @@ class ha_innobase final : public handler
 
 	int extra(ha_extra_function operation) override;
 
+	void start_bulk_insert(ha_rows rows, uint flags) override;
+
+	int end_bulk_insert() override;
+
 	int reset() override;
 
 	int external_lock(THD *thd, int lock_type) override;
@@ -191,6 +195,8 @@ class ha_innobase final : public handler
 
 	ha_rows estimate_rows_upper_bound() override;
 
+	ha_rows records() override;
+
 	void update_create_info(HA_CREATE_INFO* create_info) override;
 
 	inline int create(
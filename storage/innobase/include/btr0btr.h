@@ -362,6 +362,14 @@ btr_free_if_exists(
 @param[in]	page_id		root page id */
 void btr_free(const page_id_t page_id);
 
+/** Empty an index tree, in the rollback of TRX_UNDO_EMPTY.
+All pages except the root page are freed, the leaf segment is created
+again, and the root page is reinitialized as an empty leaf page.
+@param[in,out]	index	index tree
+@return	error code */
+dberr_t btr_clear(dict_index_t* index)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
 /** Read the last used AUTO_INCREMENT value from PAGE_ROOT_AUTO_INC.
 @param[in,out]	index	clustered index
 @return	the last used AUTO_INCREMENT value
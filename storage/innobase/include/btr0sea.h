@@ -66,7 +66,8 @@ both have sensible values.
 				to protect the record!
 @param[out]	cursor		tree cursor
 @param[in]	ahi_latch	the adaptive hash index latch being held,
-				or NULL
+				or NULL to look up the adaptive hash index
+				without acquiring its latch
 @param[in]	mtr		mini transaction
 @return whether the search succeeded */
 bool
@@ -248,7 +249,12 @@ struct btr_search_t{
 /** The hash index system */
 struct btr_search_sys_t
 {
-  /** Partition of the hash table */
+  /** Partition of the hash table.
+
+  Modifications of the table are protected by latch in exclusive mode.
+  btr_search_guess_on_hash() looks up the table without the latch:
+  it validates what it read against version, and registers itself in
+  n_readers so that the table is not freed while it is being read. */
   struct partition
   {
     /** latches protecting hash_table */
@@ -257,9 +263,15 @@ struct btr_search_sys_t
     hash_table_t table;
     /** memory heap for table */
     mem_heap_t *heap;
+    /** number of modifications of table; odd while table is
+    being modified */
+    std::atomic<uint32_t> version;
+    /** number of lookups that do not hold latch */
+    std::atomic<uint32_t> n_readers;
 
     char pad[(CPU_LEVEL1_DCACHE_LINESIZE - sizeof(rw_lock_t) -
-              sizeof(hash_table_t) - sizeof(mem_heap_t)) &
+              sizeof(hash_table_t) - sizeof(mem_heap_t) -
+              2 * sizeof(std::atomic<uint32_t>)) &
              (CPU_LEVEL1_DCACHE_LINESIZE - 1)];
 
     void init()
@@ -268,28 +280,73 @@ struct btr_search_sys_t
       rw_lock_create(btr_search_latch_key, &latch, SYNC_SEARCH_SYS);
     }
 
+    /** Start a modification of table */
+    void begin_modify()
+    {
+      ut_ad(rw_lock_own(&latch, RW_LOCK_X));
+      ut_ad(!(version.load(std::memory_order_relaxed) & 1));
+      version.store(version.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /** Finish a modification of table */
+    void end_modify()
+    {
+      ut_ad(version.load(std::memory_order_relaxed) & 1);
+      version.store(version.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+    }
+
+    /** Check that table was not modified since a lookup started.
+    @param v  version at the start of the lookup
+    @return whether everything that was read since then is valid */
+    bool validate(uint32_t v) const
+    {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return version.load(std::memory_order_relaxed) == v;
+    }
+
     void alloc(ulint hash_size)
     {
+      begin_modify();
       table.create(hash_size);
       heap= mem_heap_create_typed(std::min<ulong>(4096,
                                                   MEM_MAX_ALLOC_IN_BUF / 2
                                                   - MEM_BLOCK_HEADER_SIZE
                                                   - MEM_SPACE_NEEDED(0)),
                                   MEM_HEAP_FOR_BTR_SEARCH);
+      end_modify();
     }
 
     void clear()
+    {
+      begin_modify();
+      free_table();
+      end_modify();
+    }
+
+    /** Free table and heap */
+    void free_table()
     {
       mem_heap_free(heap);
       heap= nullptr;
       ut_free(table.array);
+      table.array= nullptr;
+    }
+
+    /** Wait for the lookups that do not hold latch to finish */
+    void wait_for_readers() const
+    {
+      while (n_readers.load(std::memory_order_acquire))
+        os_thread_yield();
     }
 
     void free()
     {
       rw_lock_free(&latch);
       if (heap)
-        clear();
+        free_table();
     }
   };
 
@@ -332,7 +389,17 @@ struct btr_search_sys_t
   }
 
   /** Clear when disabling the adaptive hash index */
-  void clear() { for (ulong i= 0; i < btr_ahi_parts; ++i) parts[i].clear(); }
+  void clear()
+  {
+    /* Lookups that started before btr_search_enabled was reset
+    may still be reading the tables. */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (ulong i= 0; i < btr_ahi_parts; ++i)
+    {
+      parts[i].wait_for_readers();
+      parts[i].clear();
+    }
+  }
 
   /** Free at shutdown */
   void free()
@@ -126,6 +126,18 @@ Get high resolution timestamp for the current query start time.
 */
 unsigned long long thd_query_start_micro(const MYSQL_THD thd);
 
+/** Mark the current transaction of a thread to be rolled back.
+@param thd  thread handle
+@param all  whether the whole transaction (not only the statement)
+must be rolled back */
+extern "C" void thd_mark_transaction_to_rollback(MYSQL_THD thd, bool all);
+
+/** Warn that a statement or savepoint rollback rolled back the whole
+transaction, because it covered rows that were inserted into an empty
+table without undo logging them individually.
+@param thd  thread handle */
+void innodb_bulk_insert_rollback_warning(MYSQL_THD thd);
+
 /*************************************************************//**
 Prints info of a THD object (== user session thread) to the given file. */
 void
@@ -430,13 +430,18 @@ lock_table(
 	lock_mode	mode,	/*!< in: lock mode */
 	que_thr_t*	thr)	/*!< in: query thread */
 	MY_ATTRIBUTE((warn_unused_result));
-/*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
-void
-lock_table_ix_resurrect(
-/*====================*/
-	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx);	/*!< in/out: transaction */
+/** Create a table lock object for a resurrected transaction.
+@param[in,out]	table	table to be locked
+@param[in,out]	trx	transaction
+@param[in]	mode	LOCK_X or LOCK_IX */
+void lock_table_resurrect(dict_table_t* table, trx_t* trx, lock_mode mode);
+
+/** Check if a transaction holds an exclusive lock on a table.
+@param[in]	trx	transaction
+@param[in]	table	table
+@return whether trx holds LOCK_X on table */
+bool lock_table_has_x(const trx_t* trx, const dict_table_t* table)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
 
 /** Sets a lock on a table based on the given mode.
 @param[in]	table	table to lock
@@ -538,7 +543,7 @@ lock_print_info_all_transactions(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding exclusive lock_sys.latch. */
 ulint
 lock_number_of_rows_locked(
 /*=======================*/
@@ -547,7 +552,7 @@ lock_number_of_rows_locked(
 
 /*********************************************************************//**
 Return the number of table locks for a transaction.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding exclusive lock_sys.latch. */
 ulint
 lock_number_of_tables_locked(
 /*=========================*/
@@ -714,9 +719,33 @@ class lock_sys_t
   bool m_initialised;
 
 public:
+  /** Latch protecting rec_hash cells while latch is being held in
+  shared mode; in exclusive mode, latch protects everything */
+  class MY_ALIGNED(CPU_LEVEL1_DCACHE_LINESIZE) hash_latch : public rw_lock
+  {
+    /** Wait for the latch */
+    void wait();
+  public:
+    /** Acquire the latch */
+    void acquire() { if (!write_trylock()) wait(); }
+    /** Release the latch */
+    void release() { write_unlock(); }
+  };
+
+  /** Number of hash_latch in hash_latches[]; a power of 2 */
+  static constexpr ulint N_HASH_LATCHES= 1024;
+
 	MY_ALIGNED(CACHE_LINE_SIZE)
-	LockMutex	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t	latch;			/*!< Latch protecting the
+						locks. Exclusive mode is
+						needed for table locks, for
+						deadlock detection and for
+						any operation that spans
+						multiple pages. Shared mode
+						together with the hash_latch
+						of a rec_hash cell suffices
+						for granting record locks
+						that do not have to wait. */
   /** record locks */
   hash_table_t rec_hash;
   /** predicate locks for SPATIAL INDEX */
@@ -778,9 +807,50 @@ class lock_sys_t
   /** Closes the lock system at database shutdown. */
   void close();
 
+#ifdef UNIV_DEBUG
+  /** @return whether the current thread is holding latch exclusively */
+  bool is_writer() const
+  { return rw_lock_own_flagged(&latch, RW_LOCK_FLAG_X); }
+  /** @return whether the current thread is holding latch in any mode */
+  bool is_holder() const
+  { return rw_lock_own_flagged(&latch, RW_LOCK_FLAG_X | RW_LOCK_FLAG_S); }
+  /** Assert that the locks of a page may be accessed.
+  @param lock_hash   hash table of the locks
+  @param id          page number */
+  void assert_locked(const hash_table_t &lock_hash, const page_id_t id) const
+  {
+    if (is_writer())
+      return;
+    ut_ad(&lock_hash == &rec_hash);
+    ut_ad(rw_lock_own_flagged(&latch, RW_LOCK_FLAG_S));
+    ut_ad(hash_latch_get(id)->is_write_locked());
+  }
+  /** Assert that a record lock may be accessed.
+  @param lock  record lock */
+  void assert_locked(const lock_t &lock) const;
+#endif /* UNIV_DEBUG */
+
   /** @return the hash value for a page address */
   ulint hash(const page_id_t id) const
-  { ut_ad(mutex_own(&mutex)); return rec_hash.calc_hash(id.fold()); }
+  { ut_ad(is_holder()); return rec_hash.calc_hash(id.fold()); }
+
+  /** Get the latch of the rec_hash cell of a page.
+  @param id   page number
+  @return the latch that protects the record locks of the page
+  when latch is being held in shared mode */
+  hash_latch *hash_latch_get(const page_id_t id) const
+  {
+    return const_cast<hash_latch*>
+      (&hash_latches[hash(id) & (N_HASH_LATCHES - 1)]);
+  }
+
+  /** Acquire latch in shared mode and the hash_latch of a page.
+  @param id   page number
+  @return the acquired hash_latch */
+  hash_latch *rd_lock(const page_id_t id);
+  /** Release rd_lock().
+  @param l    the hash_latch that rd_lock() returned */
+  void rd_unlock(hash_latch *l);
 
   /** Get the first lock on a page.
   @param lock_hash   hash table to look at
@@ -791,6 +861,7 @@ class lock_sys_t
   {
     ut_ad(&lock_hash == &rec_hash || &lock_hash == &prdt_hash ||
           &lock_hash == &prdt_page_hash);
+    ut_d(assert_locked(lock_hash, id));
     for (lock_t *lock= static_cast<lock_t*>
          (HASH_GET_FIRST(&lock_hash, hash(id)));
          lock; lock= static_cast<lock_t*>(HASH_GET_NEXT(hash, lock)))
@@ -817,6 +888,10 @@ class lock_sys_t
   @retval nullptr if none exists */
   lock_t *get_first_prdt_page(const page_id_t id) const
   { return get_first(prdt_page_hash, id); }
+
+private:
+  /** latches protecting rec_hash cells in shared mode of latch */
+  hash_latch hash_latches[N_HASH_LATCHES];
 };
 
 /*********************************************************************//**
@@ -930,21 +1005,22 @@ lock_rec_free_all_from_discard_page(
 /** The lock system */
 extern lock_sys_t lock_sys;
 
-/** Test if lock_sys.mutex can be acquired without waiting. */
+/** Test if lock_sys.latch can be acquired exclusively without waiting.
+@return 0 on success, nonzero if the latch is being held */
 #define lock_mutex_enter_nowait() 		\
-	(lock_sys.mutex.trylock(__FILE__, __LINE__))
+	(!rw_lock_x_lock_nowait(&lock_sys.latch))
 
-/** Test if lock_sys.mutex is owned. */
-#define lock_mutex_own() (lock_sys.mutex.is_owned())
+/** Test if lock_sys.latch is exclusively owned. */
+#define lock_mutex_own() lock_sys.is_writer()
 
-/** Acquire the lock_sys.mutex. */
+/** Acquire the lock_sys.latch in exclusive mode. */
 #define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys.mutex);		\
+	rw_lock_x_lock(&lock_sys.latch);	\
 } while (0)
 
-/** Release the lock_sys.mutex. */
+/** Release the exclusive lock_sys.latch. */
 #define lock_mutex_exit() do {			\
-	lock_sys.mutex.exit();			\
+	rw_lock_x_unlock(&lock_sys.latch);	\
 } while (0)
 
 /** Test if lock_sys.wait_mutex is owned. */
@@ -152,6 +152,16 @@ be flushed to the file system
 @param[in]	rotate_key	whether to rotate the encryption key */
 void log_write_up_to(lsn_t lsn, bool flush_to_disk, bool rotate_key = false);
 
+/** Initialize the dedicated log writer and flusher threads. They are
+started now if innodb_log_writer_threads=ON, or otherwise by the first
+log_write_up_to() after it has been enabled. */
+void log_writer_threads_init();
+
+/** Stop the dedicated log writer and flusher threads, after they have
+served all requests. Subsequent calls to log_write_up_to() will write
+and flush the log by themselves. */
+void log_writer_threads_shutdown();
+
 /** write to the log file up to the last log entry.
 @param[in]	sync	whether we want the written log
 also to be flushed to disk. */
@@ -336,6 +336,11 @@ struct recv_sys_t
   /** Apply buffered log to persistent data pages.
   @param last_batch     whether it is possible to write more redo log */
   void apply(bool last_batch);
+  /** Apply buffered log to a page that is in the buffer pool or that is
+  initialized by the log. If the page was evicted meanwhile, read it.
+  @param page_id  page identifier
+  @param mtr      mini-transaction */
+  void apply_page(const page_id_t page_id, mtr_t &mtr);
 
 #ifdef UNIV_DEBUG
   /** whether all redo log in the current batch has been applied */
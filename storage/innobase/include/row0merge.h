@@ -459,4 +459,67 @@ row_merge_read_rec(
 	row_merge_block_t*	crypt_block, /*!< in: crypt buf or NULL */
 	ulint			space)	   /*!< in: space id */
 	MY_ATTRIBUTE((warn_unused_result));
+
+/** Index entries of a bulk insert into an empty table
+(ha_innobase::start_bulk_insert()). The entries are buffered and
+sorted for each index, and each index is built bottom-up by BtrBulk.
+The rows are covered by a single TRX_UNDO_EMPTY undo log record. */
+class row_merge_bulk_t
+{
+	/** sort buffer of each index, in dict_table_t::indexes order */
+	std::vector<row_merge_buf_t*>	m_bufs;
+	/** sorted runs of each index that did not fit in m_bufs */
+	std::vector<merge_file_t>	m_files;
+	/** temporary file for row_merge_sort() */
+	pfs_os_file_t			m_tmpfd;
+	/** allocator of m_block and m_crypt_block */
+	ut_allocator<row_merge_block_t>	m_alloc;
+	/** 3 buffers for writing and merging the runs, or NULL */
+	row_merge_block_t*		m_block;
+	/** allocation of m_block */
+	ut_new_pfx_t			m_block_pfx;
+	/** buffer for encrypting the runs, or NULL */
+	row_merge_block_t*		m_crypt_block;
+	/** allocation of m_crypt_block */
+	ut_new_pfx_t			m_crypt_pfx;
+	/** largest buffered AUTO_INCREMENT value, or 0 */
+	ib_uint64_t			m_autoinc;
+
+	/** Sort the buffer of an index and write it to a temporary file.
+	@param[in,out]	trx	transaction
+	@param[in,out]	table	MySQL table, for reporting duplicates
+	@param[in]	i	position of the index in m_bufs
+	@return error code */
+	dberr_t write_run(trx_t* trx, TABLE* table, ulint i);
+
+public:
+	/** Constructor.
+	@param[in]	table	empty table */
+	explicit row_merge_bulk_t(dict_table_t* table);
+
+	/** Destructor. Discards any entries that were not applied. */
+	~row_merge_bulk_t();
+
+	/** Determine if the inserts into an empty table may be buffered.
+	Columns that may be stored off-page and SPATIAL or FULLTEXT
+	indexes are not supported.
+	@param[in]	table	empty table
+	@return whether row_merge_bulk_t can be used */
+	static bool is_eligible(const dict_table_t* table);
+
+	/** Buffer an index entry.
+	@param[in,out]	trx	transaction
+	@param[in,out]	table	MySQL table, for reporting duplicates
+	@param[in]	index	index of the table
+	@param[in,out]	entry	index entry; DB_ROLL_PTR will be written
+	@return error code */
+	dberr_t add(trx_t* trx, TABLE* table, dict_index_t* index,
+		    dtuple_t* entry);
+
+	/** Sort the buffered entries and build the indexes.
+	@param[in,out]	trx	transaction
+	@param[in,out]	table	MySQL table, for reporting duplicates
+	@return error code */
+	dberr_t apply(trx_t* trx, TABLE* table);
+};
 #endif /* row0merge.h */
@@ -44,6 +44,7 @@ extern ibool row_rollback_on_timeout;
 
 struct row_prebuilt_t;
 class ha_innobase;
+class row_merge_bulk_t;
 
 /*******************************************************************//**
 Frees the blob heap in prebuilt when no longer needed. */
@@ -563,6 +564,9 @@ struct mysql_row_templ_t {
 };
 
 #define MYSQL_FETCH_CACHE_SIZE		8
+/* Maximum number of rows cached in fetch_cache when the optimizer
+expects a scan to read many rows */
+#define MYSQL_FETCH_CACHE_MAX_SIZE	256
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -737,7 +741,7 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+	byte**		fetch_cache;
 					/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
@@ -746,7 +750,16 @@ struct row_prebuilt_t {
 					pointers point 4 bytes past the
 					allocated mem buf start, because
 					there is a 4 byte magic number at the
-					start and at the end */
+					start and at the end; NULL until
+					the cache is used */
+	ulint		fetch_cache_alloc;/*!< number of rows allocated
+					in fetch_cache */
+	ulint		fetch_cache_size;/*!< number of rows to fetch into
+					fetch_cache in a batch; chosen by
+					row_sel_set_fetch_cache_size() */
+	ulint		fetch_cache_threshold;/*!< number of rows to fetch
+					after positioning the cursor before
+					starting to cache them */
 	bool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -813,6 +826,12 @@ struct row_prebuilt_t {
 	/** The MySQL table object */
 	TABLE*		m_mysql_table;
 
+	/** whether ha_innobase::start_bulk_insert() was invoked */
+	bool		bulk_insert;
+	/** index entries that are being inserted into an empty table,
+	or NULL; applied by ha_innobase::end_bulk_insert() */
+	row_merge_bulk_t* bulk_store;
+
 	/** Get template by dict_table_t::cols[] number */
 	const mysql_row_templ_t* get_template_by_col(ulint col) const
 	{
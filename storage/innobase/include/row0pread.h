@@ -0,0 +1,51 @@
+/*****************************************************************************
+
+Copyright (c) 2021, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel scan of a clustered index
+
+The clustered index is split into key ranges at the node pointers of
+the root page. The ranges are scanned by tasks of srv_thread_pool and
+by the calling thread, each using its own cursor and mini-transaction,
+and the visible records are passed to a consumer of each thread.
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "trx0types.h"
+#include "dict0types.h"
+
+/** Count the records of a clustered index that are visible in the read
+view of a transaction, scanning key ranges of the index in parallel.
+@param[in,out]	trx		transaction; the read view must be open
+				unless the isolation level is READ UNCOMMITTED
+@param[in]	index		clustered index
+@param[in]	n_threads	maximum number of threads to use
+@param[out]	n_rows		number of visible records
+@return DB_SUCCESS or error code */
+dberr_t
+row_count_parallel(
+	trx_t*		trx,
+	dict_index_t*	index,
+	ulint		n_threads,
+	ulint*		n_rows)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
+#endif /* row0pread_h */
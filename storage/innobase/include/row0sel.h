@@ -110,6 +110,22 @@ row_sel_copy_cached_fields_for_mysql(
 	const byte*	cached_rec,
 	row_prebuilt_t*	prebuilt);
 
+/** Choose the number of rows that row_search_mvcc() caches in a batch
+for the scans of the current index.
+@param[in,out]	prebuilt	prebuilt struct
+@param[in]	rows		number of rows the optimizer expects a scan
+				to read, or 0 if unknown */
+void
+row_sel_set_fetch_cache_size(
+	row_prebuilt_t*	prebuilt,
+	ib_uint64_t	rows);
+
+/** Free the prefetch cache.
+@param[in,out]	prebuilt	prebuilt struct */
+void
+row_sel_prefetch_cache_free(
+	row_prebuilt_t*	prebuilt);
+
 /****************************************************************//**
 Converts a key value stored in MySQL format to an Innobase dtuple. The last
 field of the key value may be just a prefix of a fixed length field: hence
@@ -334,6 +334,8 @@ enum monitor_id_t {
 	MONITOR_OVLD_LOG_WRITE_REQUEST,
 	MONITOR_OVLD_LOG_WRITES,
 	MONITOR_OVLD_LOG_PADDED,
+	MONITOR_LOG_WRITER_WRITES,
+	MONITOR_LOG_FLUSHER_FLUSHES,
 
 	/* Page Manager related counters */
 	MONITOR_MODULE_PAGE,
@@ -194,6 +194,12 @@ struct srv_stats_t
 
 	/** Number of lock deadlocks */
 	ulint_ctr_1_t		lock_deadlock_count;
+
+	/** Number of undo log pages handled by purge */
+	ulint_ctr_1_t		n_purge_pages;
+
+	/** Number of undo log records handled by purge */
+	ulint_ctr_1_t		n_purge_recs;
 };
 
 /** We are prepared for a situation that we have this many threads waiting for
@@ -251,6 +257,14 @@ extern my_bool	srv_file_per_table;
 
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Number of threads for sorting and building secondary indexes
+in index creation */
+extern ulong	srv_ddl_threads;
+/** Number of threads for counting the rows of a table */
+extern ulong	srv_parallel_read_threads;
+/** Number of page cleaner slots that flush buf_pool.flush_list
+in parallel */
+extern ulong	srv_n_page_cleaners;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
 
@@ -310,6 +324,9 @@ extern ulong	srv_log_buffer_size;
 extern ulong	srv_flush_log_at_trx_commit;
 extern uint	srv_flush_log_at_timeout;
 extern ulong	srv_log_write_ahead_size;
+/** innodb_log_writer_threads; whether log_write_up_to() lets the
+dedicated log writer and flusher threads write and flush the log */
+extern my_bool	srv_log_writer_threads;
 extern my_bool	srv_adaptive_flushing;
 extern my_bool	srv_flush_sync;
 
@@ -144,7 +144,7 @@ V
 lock_sys_wait_mutex			Mutex protecting lock timeout data
 |
 V
-lock_sys_mutex				Mutex protecting lock_sys_t
+lock_sys_latch				Latch protecting lock_sys_t
 |
 V
 trx_sys.mutex				Mutex protecting trx_sys.trx_list
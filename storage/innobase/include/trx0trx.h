@@ -264,7 +264,7 @@ trx_print_latched(
 
 /**********************************************************************//**
 Prints info about a transaction.
-Acquires and releases lock_sys.mutex. */
+Acquires and releases lock_sys.latch. */
 void
 trx_print(
 /*======*/
@@ -474,7 +474,7 @@ To query the state either of the mutexes is sufficient within the locking
 code and no mutex is required when the query thread is no longer waiting. */
 
 /** The locks and state of an active transaction. Protected by
-lock_sys.mutex, trx->mutex or both. */
+lock_sys.latch, trx->mutex or both. */
 struct trx_lock_t {
 #ifdef UNIV_DEBUG
 	/** number of active query threads; at most 1, except for the
@@ -489,10 +489,10 @@ struct trx_lock_t {
 					TRX_QUE_LOCK_WAIT, this points to
 					the lock request, otherwise this is
 					NULL; set to non-NULL when holding
-					both trx->mutex and lock_sys.mutex;
+					both trx->mutex and lock_sys.latch;
 					set to NULL when holding
-					lock_sys.mutex; readers should
-					hold lock_sys.mutex, except when
+					lock_sys.latch; readers should
+					hold lock_sys.latch, except when
 					they are holding trx->mutex and
 					wait_lock==NULL */
 	ib_uint64_t	deadlock_mark;	/*!< A mark field that is initialized
@@ -506,13 +506,13 @@ struct trx_lock_t {
 					resolution, it sets this to true.
 					Protected by trx->mutex. */
 	time_t		wait_started;	/*!< lock wait started at this time,
-					protected only by lock_sys.mutex */
+					protected only by lock_sys.latch */
 
 	que_thr_t*	wait_thr;	/*!< query thread belonging to this
 					trx that is in QUE_THR_LOCK_WAIT
 					state. For threads suspended in a
 					lock wait, this is protected by
-					lock_sys.mutex. Otherwise, this may
+					lock_sys.latch. Otherwise, this may
 					only be modified by the thread that is
 					serving the running transaction. */
 #ifdef WITH_WSREP
@@ -536,12 +536,15 @@ struct trx_lock_t {
 	unsigned	table_cached;
 
 	mem_heap_t*	lock_heap;	/*!< memory heap for trx_locks;
-					protected by lock_sys.mutex */
+					protected by trx->mutex and
+					lock_sys.latch in any mode, or
+					by exclusive lock_sys.latch */
 
 	trx_lock_list_t trx_locks;	/*!< locks requested by the transaction;
 					insertions are protected by trx->mutex
-					and lock_sys.mutex; removals are
-					protected by lock_sys.mutex */
+					and lock_sys.latch in any mode;
+					removals are protected by
+					exclusive lock_sys.latch */
 
 	lock_list	table_locks;	/*!< All table locks requested by this
 					transaction, including AUTOINC locks */
@@ -560,7 +563,10 @@ struct trx_lock_t {
 					mutex to prevent recursive deadlocks.
 					Protected by both the lock sys mutex
 					and the trx_t::mutex. */
-	ulint		n_rec_locks;	/*!< number of rec locks in this trx */
+	ulint		n_rec_locks;	/*!< number of rec locks in this trx;
+					protected by trx->mutex and
+					lock_sys.latch in any mode, or
+					by exclusive lock_sys.latch */
 };
 
 /** Logical first modification time of a table in a transaction */
@@ -575,6 +581,11 @@ class trx_mod_table_time_t
 	table was never modified in a transaction. */
 	static const undo_no_t UNVERSIONED = IB_ID_MAX;
 
+	/** Flag in 'first' to indicate that the transaction started
+	by inserting into the empty table, and subsequent inserts are
+	covered by a single TRX_UNDO_EMPTY undo log record */
+	static constexpr undo_no_t BULK = 1ULL << 63;
+
 public:
 	/** Constructor
 	@param[in]	rows	number of modified rows so far */
@@ -587,12 +598,24 @@ class trx_mod_table_time_t
 	@return	whether the object is valid */
 	bool valid(undo_no_t rows = UNVERSIONED) const
 	{
-		return first <= first_versioned && first <= rows;
+		return (first & ~BULK) <= first_versioned
+			&& (first & ~BULK) <= rows;
 	}
 #endif /* UNIV_DEBUG */
 	/** @return if versioned columns were modified */
 	bool is_versioned() const { return first_versioned != UNVERSIONED; }
 
+	/** @return the number of modified rows before the first
+	modification of the table */
+	undo_no_t get_first() const { return first & ~BULK; }
+
+	/** @return whether inserts into the table are not undo logged */
+	bool is_bulk_insert() const { return first & BULK; }
+
+	/** After writing a TRX_UNDO_EMPTY undo log record, stop undo
+	logging and record locking for further inserts into the table */
+	void start_bulk_insert() { ut_ad(!is_bulk_insert()); first |= BULK; }
+
 	/** After writing an undo log record, set is_versioned() if needed
 	@param[in]	rows	number of modified rows so far */
 	void set_versioned(undo_no_t rows)
@@ -608,7 +631,7 @@ class trx_mod_table_time_t
 	bool rollback(undo_no_t limit)
 	{
 		ut_ad(valid());
-		if (first >= limit) {
+		if ((first & ~BULK) >= limit) {
 			return true;
 		}
 
@@ -662,7 +685,7 @@ transactions (state == TRX_STATE_ACTIVE && is_recovered)
 while the system is already processing new user transactions (!is_recovered).
 
 * trx_print_low() may access transactions not associated with the current
-thread. The caller must be holding lock_sys.mutex.
+thread. The caller must be holding lock_sys.latch.
 
 * When a transaction handle is in the trx_sys.trx_list, some of its fields
 must not be modified without holding trx->mutex.
@@ -670,7 +693,7 @@ must not be modified without holding trx->mutex.
 * The locking code (in particular, lock_deadlock_recursive() and
 lock_rec_convert_impl_to_expl()) will access transactions associated
 to other connections. The locks of transactions are protected by
-lock_sys.mutex (insertions also by trx->mutex). */
+lock_sys.latch (insertions also by trx->mutex). */
 
 /** Represents an instance of rollback segment along with its state variables.*/
 struct trx_undo_ptr_t {
@@ -722,7 +745,7 @@ struct trx_t : ilist_node<> {
 	TrxMutex	mutex;		/*!< Mutex protecting the fields
 					state and lock (except some fields
 					of lock, which are protected by
-					lock_sys.mutex) */
+					lock_sys.latch) */
 
 	trx_id_t	id;		/*!< transaction id */
 
@@ -800,7 +823,7 @@ struct trx_t : ilist_node<> {
 					transaction, or NULL if not yet set */
 	trx_lock_t	lock;		/*!< Information about the transaction
 					locks and state. Protected by
-					lock_sys.mutex (insertions also
+					lock_sys.latch (insertions also
 					by trx_t::mutex). */
 
 	/* These fields are not protected by any mutex. */
@@ -940,7 +963,7 @@ struct trx_t : ilist_node<> {
 					also in the lock list trx_locks. This
 					vector needs to be freed explicitly
 					when the trx instance is destroyed.
-					Protected by lock_sys.mutex. */
+					Protected by lock_sys.latch. */
 	/*------------------------------*/
 	bool		read_only;	/*!< true if transaction is flagged
 					as a READ-ONLY transaction.
@@ -1039,6 +1062,14 @@ struct trx_t : ilist_node<> {
   /** Release any explicit locks of a committing transaction. */
   inline void release_locks();
 
+  /** @return whether inserts into a table are not being undo logged
+  @param table   table that was inserted into by this transaction */
+  bool is_bulk_insert(const dict_table_t *table) const
+  {
+    auto t= mod_tables.find(const_cast<dict_table_t*>(table));
+    return t != mod_tables.end() && t->second.is_bulk_insert();
+  }
+
   /** Evict a table definition due to the rollback of ALTER TABLE.
   @param[in]	table_id	table identifier */
   void evict_table(table_id_t table_id);
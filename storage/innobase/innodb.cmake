@@ -56,12 +56,16 @@ IF(UNIX)
 
     ADD_DEFINITIONS("-DUNIV_LINUX -D_GNU_SOURCE=1")
 
-    CHECK_INCLUDE_FILES (libaio.h HAVE_LIBAIO_H)
-    CHECK_LIBRARY_EXISTS(aio io_queue_init "" HAVE_LIBAIO)
-
-    IF(HAVE_LIBAIO_H AND HAVE_LIBAIO)
-      ADD_DEFINITIONS(-DLINUX_NATIVE_AIO=1)
-      LINK_LIBRARIES(aio)
+    IF(WITH_URING)
+      LINK_LIBRARIES(${LIBURING})
+    ELSE()
+      CHECK_INCLUDE_FILES (libaio.h HAVE_LIBAIO_H)
+      CHECK_LIBRARY_EXISTS(aio io_queue_init "" HAVE_LIBAIO)
+
+      IF(HAVE_LIBAIO_H AND HAVE_LIBAIO)
+        ADD_DEFINITIONS(-DLINUX_NATIVE_AIO=1)
+        LINK_LIBRARIES(aio)
+      ENDIF()
     ENDIF()
     IF(HAVE_LIBNUMA)
       LINK_LIBRARIES(numa)
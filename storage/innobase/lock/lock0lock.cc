@@ -42,6 +42,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "row0mysql.h"
 #include "row0vers.h"
 #include "pars0pars.h"
+#include "sync0sync.h"
 
 #include <set>
 
@@ -248,7 +249,7 @@ class DeadlockChecker {
 		ulint		m_heap_no;	/*!< heap number if rec lock */
 	};
 
-	/** Used in deadlock tracking. Protected by lock_sys.mutex. */
+	/** Used in deadlock tracking. Protected by lock_sys.latch. */
 	static ib_uint64_t	s_lock_mark_counter;
 
 	/** Calculation steps thus far. It is the count of the nodes visited. */
@@ -455,7 +456,7 @@ void lock_sys_t::create(ulint n_cells)
 		(ut_zalloc_nokey(srv_max_n_threads * sizeof *waiting_threads));
 	last_slot = waiting_threads;
 
-	mutex_create(LATCH_ID_LOCK_SYS, &mutex);
+	rw_lock_create(lock_latch_key, &latch, SYNC_LOCK_SYS);
 
 	mutex_create(LATCH_ID_LOCK_SYS_WAIT, &wait_mutex);
 
@@ -489,7 +490,7 @@ void lock_sys_t::resize(ulint n_cells)
 {
 	ut_ad(this == &lock_sys);
 
-	mutex_enter(&mutex);
+	lock_mutex_enter();
 
 	hash_table_t old_hash(rec_hash);
 	rec_hash.create(n_cells);
@@ -508,8 +509,58 @@ void lock_sys_t::resize(ulint n_cells)
 	HASH_MIGRATE(&old_hash, &prdt_page_hash, lock_t, hash,
 		     lock_rec_lock_fold);
 	old_hash.free();
-	mutex_exit(&mutex);
+	lock_mutex_exit();
+}
+
+/** Wait for a lock_sys_t::hash_latch */
+void lock_sys_t::hash_latch::wait()
+{
+  write_lock_wait_start();
+
+  /* First, try busy spinning for a while. */
+  for (auto spin= srv_n_spin_wait_rounds; spin--; )
+  {
+    if (write_lock_poll())
+      return;
+    ut_delay(srv_spin_wait_delay);
+  }
+
+  /* Fall back to yielding to other threads. */
+  do
+    os_thread_yield();
+  while (!write_lock_poll());
+}
+
+/** Acquire latch in shared mode and the hash_latch of a page.
+@param id   page number
+@return the acquired hash_latch */
+lock_sys_t::hash_latch *lock_sys_t::rd_lock(const page_id_t id)
+{
+  rw_lock_s_lock(&latch);
+  hash_latch *l= hash_latch_get(id);
+  l->acquire();
+  return l;
+}
+
+/** Release rd_lock().
+@param l    the hash_latch that rd_lock() returned */
+void lock_sys_t::rd_unlock(hash_latch *l)
+{
+  ut_ad(rw_lock_own(&latch, RW_LOCK_S));
+  l->release();
+  rw_lock_s_unlock(&latch);
+}
+
+#ifdef UNIV_DEBUG
+/** Assert that a record lock may be accessed.
+@param lock  record lock */
+void lock_sys_t::assert_locked(const lock_t &lock) const
+{
+  ut_ad(lock_get_type_low(&lock) == LOCK_REC);
+  assert_locked(*lock_hash_get(lock.type_mode),
+                lock.un_member.rec_lock.page_id);
 }
+#endif /* UNIV_DEBUG */
 
 
 /** Closes the lock system at database shutdown. */
@@ -528,7 +579,7 @@ void lock_sys_t::close()
 	prdt_hash.free();
 	prdt_page_hash.free();
 
-	mutex_destroy(&mutex);
+	rw_lock_free(&latch);
 	mutex_destroy(&wait_mutex);
 
 	for (ulint i = srv_max_n_threads; i--; ) {
@@ -913,7 +964,7 @@ lock_rec_has_expl(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_d(lock_sys.assert_locked(lock_sys.rec_hash, block->page.id()));
 	ut_ad((precise_mode & LOCK_MODE_MASK) == LOCK_S
 	      || (precise_mode & LOCK_MODE_MASK) == LOCK_X);
 	ut_ad(!(precise_mode & LOCK_INSERT_INTENTION));
@@ -962,7 +1013,7 @@ lock_rec_other_has_expl_req(
 					are taken into account */
 {
 
-	ut_ad(lock_mutex_own());
+	ut_d(lock_sys.assert_locked(lock_sys.rec_hash, block->page.id()));
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 
 	/* Only GAP lock can be on SUPREMUM, and we are not looking for
@@ -1073,7 +1124,7 @@ lock_rec_other_has_conflicting(
 {
 	lock_t*		lock;
 
-	ut_ad(lock_mutex_own());
+	ut_d(lock_sys.assert_locked(lock_sys.rec_hash, block->page.id()));
 
 	bool	is_supremum = (heap_no == PAGE_HEAP_NO_SUPREMUM);
 
@@ -1154,7 +1205,7 @@ lock_sec_rec_some_has_impl(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch. */
 ulint
 lock_number_of_rows_locked(
 /*=======================*/
@@ -1167,7 +1218,7 @@ lock_number_of_rows_locked(
 
 /*********************************************************************//**
 Return the number of table locks for a transaction.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch. */
 ulint
 lock_number_of_tables_locked(
 /*=========================*/
@@ -1251,7 +1302,7 @@ lock_rec_create_low(
 	ulint		n_bits;
 	ulint		n_bytes;
 
-	ut_ad(lock_mutex_own());
+	ut_d(lock_sys.assert_locked(*lock_hash_get(type_mode), page_id));
 	ut_ad(holds_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
@@ -1297,6 +1348,14 @@ lock_rec_create_low(
 		}
 	}
 
+	/* While lock_sys.latch is being held in shared mode,
+	trx->mutex protects the lock memory and trx->lock.trx_locks
+	against concurrent lock_rec_convert_impl_to_expl_for_trx(). */
+	if (!holds_trx_mutex) {
+		trx_mutex_enter(trx);
+	}
+	ut_ad(trx_mutex_own(trx));
+
 	if (trx->lock.rec_cached >= UT_ARR_SIZE(trx->lock.rec_pool)
 	    || sizeof *lock + n_bytes > sizeof *trx->lock.rec_pool) {
 		lock = static_cast<lock_t*>(
@@ -1364,9 +1423,7 @@ lock_rec_create_low(
 			   victim lock release. This will eventually call
 			   lock_grant, which wants to grant trx mutex again
 			*/
-			if (holds_trx_mutex) {
-				trx_mutex_exit(trx);
-			}
+			trx_mutex_exit(trx);
 			lock_cancel_waiting_and_release(
 				c_lock->trx->lock.wait_lock);
 
@@ -1390,10 +1447,6 @@ lock_rec_create_low(
 		HASH_INSERT(lock_t, hash, lock_hash_get(type_mode),
 			    page_id.fold(), lock);
 
-	if (!holds_trx_mutex) {
-		trx_mutex_enter(trx);
-	}
-	ut_ad(trx_mutex_own(trx));
 	if (type_mode & LOCK_WAIT) {
 		lock_set_lock_and_trx_wait(lock, trx);
 	}
@@ -1401,8 +1454,8 @@ lock_rec_create_low(
 	if (!holds_trx_mutex) {
 		trx_mutex_exit(trx);
 	}
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
 	return lock;
 }
@@ -1527,8 +1580,6 @@ lock_rec_find_similar_on_page(
 	lock_t*         lock,           /*!< in: lock_sys.get_first() */
 	const trx_t*    trx)            /*!< in: transaction */
 {
-	ut_ad(lock_mutex_own());
-
 	for (/* No op */;
 	     lock != NULL;
 	     lock = lock_rec_get_next_on_page(lock)) {
@@ -1569,7 +1620,7 @@ lock_rec_add_to_queue(
 					transaction mutex */
 {
 #ifdef UNIV_DEBUG
-	ut_ad(lock_mutex_own());
+	lock_sys.assert_locked(*lock_hash_get(type_mode), block->page.id());
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index)
 	      || dict_index_get_online_status(index) != ONLINE_INDEX_CREATION);
@@ -1687,6 +1738,7 @@ lock_rec_lock(
 	que_thr_t*		thr)	/*!< in: query thread */
 {
   trx_t *trx= thr_get_trx(thr);
+  const page_id_t id(block->page.id());
   dberr_t err= DB_SUCCESS;
 
   ut_ad(!srv_read_only_mode);
@@ -1698,7 +1750,17 @@ lock_rec_lock(
   ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
   DBUG_EXECUTE_IF("innodb_report_deadlock", return DB_DEADLOCK;);
 
-  lock_mutex_enter();
+  /* First, try to acquire the lock while holding lock_sys.latch in
+  shared mode and only the latch of the rec_hash cell of the page.
+  That is sufficient unless we would have to wait. Galera may need
+  to kill conflicting transactions, so it always uses exclusive mode. */
+  bool exclusive= trx->is_wsrep();
+  lock_sys_t::hash_latch *latch= nullptr;
+retry:
+  if (exclusive)
+    lock_mutex_enter();
+  else
+    latch= lock_sys.rd_lock(id);
   ut_ad((LOCK_MODE_MASK & mode) != LOCK_S ||
         lock_table_has(trx, index->table, LOCK_IS));
   ut_ad((LOCK_MODE_MASK & mode) != LOCK_X ||
@@ -1706,7 +1768,7 @@ lock_rec_lock(
 
   if (lock_table_has(trx, index->table,
                      static_cast<lock_mode>(LOCK_MODE_MASK & mode)));
-  else if (lock_t *lock= lock_sys.get_first(block->page.id()))
+  else if (lock_t *lock= lock_sys.get_first(id))
   {
     trx_mutex_enter(trx);
     if (lock_rec_get_next_on_page(lock) ||
@@ -1723,6 +1785,15 @@ lock_rec_lock(
 #endif
 	    lock_rec_other_has_conflicting(mode, block, heap_no, trx))
         {
+          if (!exclusive)
+          {
+            /* Deadlock detection requires exclusive lock_sys.latch.
+            Start over, because the queue may change meanwhile. */
+            trx_mutex_exit(trx);
+            lock_sys.rd_unlock(latch);
+            exclusive= true;
+            goto retry;
+          }
           /*
             If another transaction has a non-gap conflicting
             request in the queue, as this transaction does not
@@ -1772,7 +1843,10 @@ lock_rec_lock(
 
     err= DB_SUCCESS_LOCKED_REC;
   }
-  lock_mutex_exit();
+  if (exclusive)
+    lock_mutex_exit();
+  else
+    lock_sys.rd_unlock(latch);
   MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
   return err;
 }
@@ -3574,17 +3648,16 @@ lock_table(
 	return(err);
 }
 
-/*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
-void
-lock_table_ix_resurrect(
-/*====================*/
-	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx)	/*!< in/out: transaction */
+/** Create a table lock object for a resurrected transaction.
+@param[in,out]	table	table to be locked
+@param[in,out]	trx	transaction
+@param[in]	mode	LOCK_X or LOCK_IX */
+void lock_table_resurrect(dict_table_t* table, trx_t* trx, lock_mode mode)
 {
 	ut_ad(trx->is_recovered);
+	ut_ad(mode == LOCK_X || mode == LOCK_IX);
 
-	if (lock_table_has(trx, table, LOCK_IX)) {
+	if (lock_table_has(trx, table, mode)) {
 		return;
 	}
 
@@ -3594,14 +3667,23 @@ lock_table_ix_resurrect(
 	other transactions have in the table lock queue. */
 
 	ut_ad(!lock_table_other_has_incompatible(
-		      trx, LOCK_WAIT, table, LOCK_IX));
+		      trx, LOCK_WAIT, table, mode));
 
 	trx_mutex_enter(trx);
-	lock_table_create(table, LOCK_IX, trx);
+	lock_table_create(table, mode, trx);
 	lock_mutex_exit();
 	trx_mutex_exit(trx);
 }
 
+/** Check if a transaction holds an exclusive lock on a table.
+@param[in]	trx	transaction
+@param[in]	table	table
+@return whether trx holds LOCK_X on table */
+bool lock_table_has_x(const trx_t* trx, const dict_table_t* table)
+{
+	return lock_table_has(trx, table, LOCK_X) != NULL;
+}
+
 /*********************************************************************//**
 Checks if a waiting table lock request still has to wait in a queue.
 @return TRUE if still has to wait */
@@ -4339,7 +4421,7 @@ lock_table_queue_validate(
 	     lock = UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock)) {
 
 		/* lock->trx->state cannot change from or to NOT_STARTED
-		while we are holding the lock_sys.mutex. It may change
+		while we are holding the lock_sys.latch. It may change
 		from ACTIVE or PREPARED to PREPARED or COMMITTED. */
 		trx_mutex_enter(lock->trx);
 		check_trx_state(lock->trx);
@@ -4807,7 +4889,6 @@ lock_rec_insert_check_and_lock(
 	ulint		heap_no = page_rec_get_heap_no(next_rec);
 	ut_ad(!rec_is_metadata(next_rec, *index));
 
-	lock_mutex_enter();
 	/* Because this code is invoked for a running transaction by
 	the thread that is serving the transaction, it is not necessary
 	to hold trx->mutex here. */
@@ -4817,13 +4898,23 @@ lock_rec_insert_check_and_lock(
 	BTR_NO_LOCKING_FLAG and skip the locking altogether. */
 	ut_ad(lock_table_has(trx, index->table, LOCK_IX));
 
+	/* In the common case, there are no locks on the successor record,
+	and the shared lock_sys.latch suffices for determining that. */
+	lock_sys_t::hash_latch*	latch = lock_sys.rd_lock(block->page.id());
 	lock = lock_rec_get_first(&lock_sys.rec_hash, block, heap_no);
+	lock_sys.rd_unlock(latch);
+
+	if (lock != NULL) {
+		lock_mutex_enter();
+		lock = lock_rec_get_first(&lock_sys.rec_hash, block, heap_no);
+		if (lock == NULL) {
+			lock_mutex_exit();
+		}
+	}
 
 	if (lock == NULL) {
 		/* We optimize CPU time usage in the simplest case */
 
-		lock_mutex_exit();
-
 		if (inherit_in && !dict_index_is_clust(index)) {
 			/* Update the page max trx id field */
 			page_update_max_trx_id(block,
@@ -4839,6 +4930,7 @@ lock_rec_insert_check_and_lock(
 	/* Spatial index does not use GAP lock protection. It uses
 	"predicate lock" to protect the "range" */
 	if (dict_index_is_spatial(index)) {
+		lock_mutex_exit();
 		return(DB_SUCCESS);
 	}
 
@@ -4936,7 +5028,10 @@ lock_rec_convert_impl_to_expl_for_trx(
 	ut_ad(!rec_is_metadata(rec, *index));
 
 	DEBUG_SYNC_C("before_lock_rec_convert_impl_to_expl_for_trx");
-	lock_mutex_enter();
+	/* No other transaction can hold a conflicting lock on the record,
+	so we never have to wait, and the shared lock_sys.latch suffices.
+	This must hold trx->mutex of only one transaction at a time. */
+	lock_sys_t::hash_latch*	latch = lock_sys.rd_lock(block->page.id());
 	trx_mutex_enter(trx);
 	ut_ad(!trx_state_eq(trx, TRX_STATE_NOT_STARTED));
 
@@ -4947,7 +5042,7 @@ lock_rec_convert_impl_to_expl_for_trx(
 				      block, heap_no, index, trx, true);
 	}
 
-	lock_mutex_exit();
+	lock_sys.rd_unlock(latch);
 	trx_mutex_exit(trx);
 	trx->release_reference();
 
@@ -53,6 +53,9 @@ Created 12/9/1995 Heikki Tuuri
 #include "buf0dump.h"
 #include "log0sync.h"
 
+#include <atomic>
+#include <mutex>
+
 /*
 General philosophy of InnoDB redo-logs:
 
@@ -1081,6 +1084,85 @@ bool log_write_lock_own()
 }
 #endif
 
+/** Whether the dedicated log writer and flusher threads accept requests */
+static std::atomic<bool> log_writer_threads_active;
+/** Whether the dedicated log writer and flusher threads may be started;
+reset when they are started and at shutdown */
+static bool log_writer_threads_startable;
+/** Protects log_writer_threads_startable */
+static std::mutex log_writer_threads_mutex;
+/** Number of dedicated log writer and flusher threads that are running */
+static std::atomic<ulint> log_writer_threads_running;
+/** Largest LSN that was requested to be written by the log writer thread */
+static std::atomic<lsn_t> log_write_requested;
+/** Largest LSN that was requested to be flushed by the log flusher thread */
+static std::atomic<lsn_t> log_flush_requested;
+/** Event to wake up the log writer thread */
+static os_event_t log_writer_event;
+/** Event to wake up the log flusher thread */
+static os_event_t log_flusher_event;
+
+/** Write the log buffer to the file, unless another thread already
+wrote it up to a given LSN.
+@param[in]	lsn		log sequence number that should be written
+@param[in]	rotate_key	whether to rotate the encryption key */
+static void log_write_lsn(lsn_t lsn, bool rotate_key)
+{
+  if (write_lock.acquire(lsn) == group_commit_lock::ACQUIRED)
+  {
+    log_mutex_enter();
+    lsn_t write_lsn= log_sys.get_lsn();
+    write_lock.set_pending(write_lsn);
+
+    log_write(rotate_key);
+
+    ut_a(log_sys.write_lsn == write_lsn);
+    write_lock.release(write_lsn);
+  }
+}
+
+/** Flush the written log to the file system. The caller must have
+acquired flush_lock. */
+static void log_flush_written()
+{
+  /* Flush the highest written lsn.*/
+  auto flush_lsn = write_lock.value();
+  flush_lock.set_pending(flush_lsn);
+
+  if (!log_sys.log.writes_are_durable())
+  {
+    log_write_flush_to_disk_low(flush_lsn);
+  }
+
+  flush_lock.release(flush_lsn);
+
+  innobase_mysql_log_notify(flush_lsn);
+}
+
+/** Request a write or flush from the log writer and flusher threads.
+@param[in,out]	requested	log_write_requested or log_flush_requested
+@param[in]	lsn		log sequence number to be written or flushed
+@return whether the request was accepted */
+static bool log_writer_request(std::atomic<lsn_t> &requested, lsn_t lsn)
+{
+  lsn_t old= requested.load(std::memory_order_relaxed);
+  bool wake= false;
+
+  while (old < lsn && !(wake= requested.compare_exchange_weak(old, lsn)));
+
+  /* The request must be visible before log_writer_threads_active
+  is read, so that log_writer_threads_shutdown() cannot miss it. */
+  if (!log_writer_threads_active)
+    return false;
+
+  if (wake)
+    os_event_set(log_writer_event);
+
+  return true;
+}
+
+static void log_writer_threads_start();
+
 /** Ensure that the log has been written to the log file up to a given
 log entry (such as that of a transaction commit). Start a new write, or
 wait and check if an already running write is covering the request.
@@ -1101,41 +1183,174 @@ void log_write_up_to(lsn_t lsn, bool flush_to_disk, bool rotate_key)
     return;
   }
 
+  if (srv_log_writer_threads && !rotate_key)
+  {
+    /* Let the dedicated threads do the work, and wait for
+    the notification that the lsn was written or flushed. */
+    group_commit_lock &lock= flush_to_disk ? flush_lock : write_lock;
+
+    if (lsn <= lock.value())
+      return;
+
+    if (UNIV_UNLIKELY(!log_writer_threads_active))
+      log_writer_threads_start();
+
+    if (log_writer_request(flush_to_disk
+                           ? log_flush_requested : log_write_requested, lsn))
+    {
+      lock.wait(lsn);
+      return;
+    }
+  }
+
   if (flush_to_disk &&
     flush_lock.acquire(lsn) != group_commit_lock::ACQUIRED)
   {
     return;
   }
 
-  if (write_lock.acquire(lsn) == group_commit_lock::ACQUIRED)
+  log_write_lsn(lsn, rotate_key);
+
+  if (flush_to_disk)
   {
-    log_mutex_enter();
-    lsn_t write_lsn= log_sys.get_lsn();
-    write_lock.set_pending(write_lsn);
+    log_flush_written();
+  }
+}
 
-    log_write(rotate_key);
+/** The dedicated log writer thread. It writes the log buffer to the file
+whenever a write or flush was requested by log_write_up_to(), and lets
+the log flusher thread know about the written log. */
+static os_thread_ret_t DECLARE_THREAD(log_writer_thread)(void*)
+{
+  my_thread_init();
+  ut_ad(!srv_read_only_mode);
 
-    ut_a(log_sys.write_lsn == write_lsn);
-    write_lock.release(write_lsn);
+  for (;;)
+  {
+    const int64_t sig_count= os_event_reset(log_writer_event);
+    const bool active= log_writer_threads_active;
+    const lsn_t lsn= std::max(log_write_requested.load(),
+                              log_flush_requested.load());
+
+    if (lsn > write_lock.value())
+    {
+      log_write_lsn(lsn, false);
+      MONITOR_INC(MONITOR_LOG_WRITER_WRITES);
+    }
+
+    if (log_flush_requested.load(std::memory_order_relaxed) >
+        flush_lock.value())
+      os_event_set(log_flusher_event);
+
+    if (lsn > write_lock.value())
+      continue;
+    if (!active)
+      break;
+
+    os_event_wait_low(log_writer_event, sig_count);
   }
 
-  if (!flush_to_disk)
+  log_writer_threads_running--;
+  my_thread_end();
+  os_thread_exit();
+  OS_THREAD_DUMMY_RETURN;
+}
+
+/** The dedicated log flusher thread. It makes the log that was written
+by the log writer thread durable, while the log writer thread may
+already be writing more log. */
+static os_thread_ret_t DECLARE_THREAD(log_flusher_thread)(void*)
+{
+  my_thread_init();
+  ut_ad(!srv_read_only_mode);
+
+  for (;;)
   {
-    return;
+    const int64_t sig_count= os_event_reset(log_flusher_event);
+    /* The log writer thread exits before us. */
+    const bool active= log_writer_threads_running > 1;
+    const lsn_t lsn= log_flush_requested;
+    const lsn_t flushed= flush_lock.value();
+    const lsn_t written= write_lock.value();
+
+    if (lsn > flushed && written > flushed)
+    {
+      if (flush_lock.acquire(written) == group_commit_lock::ACQUIRED)
+      {
+        log_flush_written();
+        MONITOR_INC(MONITOR_LOG_FLUSHER_FLUSHES);
+      }
+      continue;
+    }
+
+    if (!active)
+      break;
+
+    os_event_wait_low(log_flusher_event, sig_count);
   }
 
-  /* Flush the highest written lsn.*/
-  auto flush_lsn = write_lock.value();
-  flush_lock.set_pending(flush_lsn);
+  log_writer_threads_running--;
+  my_thread_end();
+  os_thread_exit();
+  OS_THREAD_DUMMY_RETURN;
+}
 
-  if (!log_sys.log.writes_are_durable())
+/** Start the dedicated log writer and flusher threads, unless they
+were already started or log_writer_threads_shutdown() was invoked.
+Once started, the threads keep running until shutdown, even if
+innodb_log_writer_threads is switched OFF: a thread that is waiting
+for them in log_write_up_to() must still be served. */
+static void log_writer_threads_start()
+{
+  std::lock_guard<std::mutex> lock(log_writer_threads_mutex);
+
+  if (!log_writer_threads_startable)
+    return;
+
+  log_writer_threads_startable= false;
+  ut_ad(!log_writer_threads_running);
+  log_writer_threads_running= 2;
+  log_writer_threads_active= true;
+  os_thread_create(log_writer_thread, nullptr, nullptr);
+  os_thread_create(log_flusher_thread, nullptr, nullptr);
+}
+
+/** Initialize the dedicated log writer and flusher threads. They are
+started now if innodb_log_writer_threads=ON, or otherwise by the first
+log_write_up_to() after it has been enabled. */
+void log_writer_threads_init()
+{
+  ut_ad(!srv_read_only_mode);
+  ut_ad(!log_writer_threads_running);
+
+  log_writer_event= os_event_create(0);
+  log_flusher_event= os_event_create(0);
+  log_writer_threads_startable= true;
+
+  if (srv_log_writer_threads)
+    log_writer_threads_start();
+}
+
+/** Stop the dedicated log writer and flusher threads, after they have
+served all requests. Subsequent calls to log_write_up_to() will write
+and flush the log by themselves. */
+void log_writer_threads_shutdown()
+{
   {
-    log_write_flush_to_disk_low(flush_lsn);
+    std::lock_guard<std::mutex> lock(log_writer_threads_mutex);
+    log_writer_threads_startable= false;
   }
 
-  flush_lock.release(flush_lsn);
+  if (!log_writer_threads_active.exchange(false))
+    return;
 
-  innobase_mysql_log_notify(flush_lsn);
+  os_event_set(log_writer_event);
+  while (log_writer_threads_running > 1)
+    os_thread_sleep(1000);
+
+  os_event_set(log_flusher_event);
+  while (log_writer_threads_running)
+    os_thread_sleep(1000);
 }
 
 /** write to the log file up to the last log entry.
@@ -1648,6 +1863,10 @@ void logs_empty_and_mark_files_at_shutdown()
 		}
 	}
 
+	/* The page cleaner has finished. From now on, log_write_up_to()
+	will write and flush the log by itself. */
+	log_writer_threads_shutdown();
+
 	if (log_sys.is_initialised()) {
 		log_mutex_enter();
 		const ulint	n_write	= log_sys.n_pending_checkpoint_writes;
@@ -1837,6 +2056,13 @@ void log_t::close()
   mutex_free(&mutex);
   mutex_free(&log_flush_order_mutex);
 
+  if (log_writer_event)
+  {
+    ut_ad(!log_writer_threads_running);
+    os_event_destroy(log_writer_event);
+    os_event_destroy(log_flusher_event);
+  }
+
   recv_sys.close();
 }
 
@@ -2650,6 +2650,125 @@ buf_block_t *recv_sys_t::recover_low(const page_id_t page_id)
   return block;
 }
 
+/** Apply buffered log to a page that is in the buffer pool or that is
+initialized by the log. If the page was evicted meanwhile, read it.
+@param page_id  page identifier
+@param mtr      mini-transaction */
+void recv_sys_t::apply_page(const page_id_t page_id, mtr_t &mtr)
+{
+  ut_ad(mutex_own(&mutex));
+  map::iterator p= pages.find(page_id);
+
+  if (p == pages.end())
+    /* The log was applied when the page was read. */
+    return;
+
+  switch (p->second.state) {
+  case page_recv_t::RECV_BEING_READ:
+  case page_recv_t::RECV_BEING_PROCESSED:
+    return;
+  case page_recv_t::RECV_WILL_NOT_READ:
+    recover_low(page_id, p, mtr);
+    return;
+  case page_recv_t::RECV_NOT_PROCESSED:
+    mtr.start();
+    mtr.set_log_mode(MTR_LOG_NO_REDO);
+    if (buf_block_t *block= buf_page_get_low(page_id, 0, RW_X_LATCH,
+                                             nullptr, BUF_GET_IF_IN_POOL,
+                                             __FILE__, __LINE__,
+                                             &mtr, nullptr, false))
+    {
+      buf_block_dbg_add_level(block, SYNC_NO_ORDER_CHECK);
+      recv_recover_page(block, mtr, p);
+      ut_ad(mtr.has_committed());
+      p->second.log.clear();
+      pages.erase(p);
+    }
+    else
+    {
+      mtr.commit();
+      recv_read_in_area(page_id);
+    }
+  }
+}
+
+/** Pages whose buffered log is applied by tasks of srv_thread_pool in
+recv_sys_t::apply(). The pages are in the buffer pool or they are
+initialized by the log, so that they need not be read. The page
+identifiers are partitioned into ranges, and each range is applied by
+one task at a time. Pages that need to be read are applied on read
+completion, as before. */
+class recv_apply_parallel_t
+{
+  /** Number of pages in a range */
+  static constexpr size_t RANGE_SIZE= 64;
+
+  /** pages to apply the log to, in ascending order */
+  std::vector<page_id_t> m_pages;
+  /** next range of m_pages to be applied */
+  std::atomic<size_t> m_next;
+
+  /** Apply the log to ranges of pages until all have been claimed. */
+  void apply()
+  {
+    mtr_t mtr;
+    mutex_enter(&recv_sys.mutex);
+    for (size_t i; (i= m_next++ * RANGE_SIZE) < m_pages.size(); )
+    {
+      const size_t end= std::min(i + RANGE_SIZE, m_pages.size());
+      for (; i < end && !recv_sys.found_corrupt_log; i++)
+        recv_sys.apply_page(m_pages[i], mtr);
+    }
+    mutex_exit(&recv_sys.mutex);
+  }
+
+  /** Task callback
+  @param arg  recv_apply_parallel_t */
+  static void apply_task(void *arg)
+  {
+    static_cast<recv_apply_parallel_t*>(arg)->apply();
+  }
+
+public:
+  recv_apply_parallel_t() : m_next(0) {}
+
+  /** Add a page whose log is to be applied.
+  @param page_id  page identifier, greater than any previously added */
+  void add(const page_id_t page_id)
+  {
+    ut_ad(m_pages.empty() || m_pages.back() < page_id);
+    m_pages.push_back(page_id);
+  }
+
+  /** Apply the log to the pages in the calling thread and in tasks,
+  and wait for the tasks to complete.
+  @param n_threads  maximum number of threads */
+  void run(ulint n_threads)
+  {
+    ut_ad(!mutex_own(&recv_sys.mutex));
+    std::vector<tpool::waitable_task*> tasks;
+    n_threads= std::min<ulint>(n_threads,
+                               (m_pages.size() + RANGE_SIZE - 1) / RANGE_SIZE);
+    if (!srv_thread_pool)
+      n_threads= 1;
+
+    for (ulint i= 1; i < n_threads; i++)
+    {
+      tpool::waitable_task *task= new tpool::waitable_task(apply_task, this);
+      tasks.push_back(task);
+      srv_thread_pool->submit_task(task);
+    }
+
+    apply();
+
+    for (tpool::waitable_task *task : tasks)
+    {
+      task->wait();
+      delete task;
+    }
+  }
+};
+
 /** Apply buffered log to persistent data pages.
 @param last_batch     whether it is possible to write more redo log */
 void recv_sys_t::apply(bool last_batch)
@@ -2701,6 +2820,11 @@ void recv_sys_t::apply(bool last_batch)
         trim(page_id_t(id + srv_undo_space_id_start, t.pages), t.lsn);
     }
 
+    /* Initiate the reads of the pages that are not in the buffer pool.
+    The log will be applied to them on read completion. The rest of
+    the pages are applied by multiple threads below. */
+    recv_apply_parallel_t parallel;
+
     for (map::iterator p= pages.begin(); p != pages.end(); )
     {
       const page_id_t page_id= p->first;
@@ -2713,35 +2837,26 @@ void recv_sys_t::apply(bool last_batch)
         p++;
         continue;
       case page_recv_t::RECV_WILL_NOT_READ:
-        recover_low(page_id, p, mtr);
+        parallel.add(page_id);
+        p++;
         continue;
       case page_recv_t::RECV_NOT_PROCESSED:
-        mtr.start();
-        mtr.set_log_mode(MTR_LOG_NO_REDO);
-        if (buf_block_t *block= buf_page_get_low(page_id, 0, RW_X_LATCH,
-                                                 nullptr, BUF_GET_IF_IN_POOL,
-                                                 __FILE__, __LINE__,
-                                                 &mtr, nullptr, false))
+        if (buf_pool.page_hash_contains(page_id))
         {
-          buf_block_dbg_add_level(block, SYNC_NO_ORDER_CHECK);
-          recv_recover_page(block, mtr, p);
-          ut_ad(mtr.has_committed());
-        }
-        else
-        {
-          mtr.commit();
-          recv_read_in_area(page_id);
-          break;
+          parallel.add(page_id);
+          p++;
+          continue;
         }
-        map::iterator r= p++;
-        r->second.log.clear();
-        pages.erase(r);
-        continue;
+        recv_read_in_area(page_id);
       }
 
       p= pages.lower_bound(page_id);
     }
 
+    mutex_exit(&mutex);
+    parallel.run(srv_n_read_io_threads);
+    mutex_enter(&mutex);
+
     /* Wait until all the pages have been processed */
     while (!pages.empty())
     {
@@ -161,7 +161,9 @@ struct group_commit_waiter_t
   lsn_t m_value;
   binary_semaphore m_sema;
   group_commit_waiter_t* m_next;
-  group_commit_waiter_t() :m_value(), m_sema(), m_next() {}
+  /* Whether the waiter may become the group commit leader */
+  bool m_can_lead;
+  group_commit_waiter_t() :m_value(), m_sema(), m_next(), m_can_lead() {}
 };
 
 group_commit_lock::group_commit_lock() :
@@ -212,6 +214,7 @@ group_commit_lock::lock_return_code group_commit_lock::acquire(value_type num)
   }
 
   thread_local_waiter.m_value = num;
+  thread_local_waiter.m_can_lead = true;
   std::unique_lock<std::mutex> lk(m_mtx, std::defer_lock);
   while (num > value())
   {
@@ -247,6 +250,36 @@ group_commit_lock::lock_return_code group_commit_lock::acquire(value_type num)
   return lock_return_code::EXPIRED;
 }
 
+void group_commit_lock::wait(value_type num)
+{
+  if (num <= value())
+    return;
+
+  thread_local_waiter.m_value = num;
+  thread_local_waiter.m_can_lead = false;
+  std::unique_lock<std::mutex> lk(m_mtx, std::defer_lock);
+  while (num > value())
+  {
+    lk.lock();
+
+    /* Re-read current value after acquiring the lock*/
+    if (num <= value())
+    {
+      return;
+    }
+
+    /* Add yourself to waiters list.*/
+    thread_local_waiter.m_next = m_waiters_list;
+    m_waiters_list = &thread_local_waiter;
+    lk.unlock();
+
+    /* Sleep until woken in release().*/
+    thd_wait_begin(0,THD_WAIT_GROUP_COMMIT);
+    thread_local_waiter.m_sema.wait();
+    thd_wait_end(0);
+  }
+}
+
 void group_commit_lock::release(value_type num)
 {
   std::unique_lock<std::mutex> lk(m_mtx);
@@ -259,6 +292,7 @@ void group_commit_lock::release(value_type num)
   /*
     Wake waiters for value <= current value.
     Wake one more waiter, who will become the group commit lead.
+    Waiters in wait() never become the lead.
   */
   group_commit_waiter_t* cur, * prev, * next;
   group_commit_waiter_t* wakeup_list = nullptr;
@@ -267,7 +301,7 @@ void group_commit_lock::release(value_type num)
   for (prev= nullptr, cur= m_waiters_list; cur; cur= next)
   {
     next= cur->m_next;
-    if (cur->m_value <= num || extra_wake++ == 0)
+    if (cur->m_value <= num || (cur->m_can_lead && extra_wake++ == 0))
     {
       /* Move current waiter to wakeup_list*/
 
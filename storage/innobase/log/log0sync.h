@@ -51,6 +51,11 @@ Operations supported on this semaphore
 - read pending value
 
 5. set_pending_value()
+
+6. wait(num)
+- waits until current value exceeds num, without ever being
+  granted the lock. This is used by threads that let a dedicated
+  thread do the work.
 */
 class group_commit_lock
 {
@@ -71,6 +76,7 @@ class group_commit_lock
     EXPIRED
   };
   lock_return_code acquire(value_type num);
+  void wait(value_type num);
   void release(value_type num);
   value_type value() const;
   value_type pending() const;
@@ -1470,6 +1470,13 @@ os_file_create_func(
 	}
 #endif /* USE_FILE_LOCK */
 
+#ifdef HAVE_URING
+	if (*success && purpose == OS_FILE_AIO && srv_thread_pool) {
+		/* Register the file with io_uring */
+		srv_thread_pool->bind(file);
+	}
+#endif
+
 	return(file);
 }
 
@@ -1660,6 +1667,10 @@ os_file_get_last_error.
 @return true if success */
 bool os_file_close_func(os_file_t file)
 {
+#ifdef HAVE_URING
+  if (srv_thread_pool)
+    srv_thread_pool->unbind(file);
+#endif
   int ret= close(file);
 
   if (!ret)
@@ -36,6 +36,7 @@ Created 4/20/1996 Heikki Tuuri
 #include "row0upd.h"
 #include "row0sel.h"
 #include "row0log.h"
+#include "row0merge.h"
 #include "rem0cmp.h"
 #include "lock0lock.h"
 #include "log0log.h"
@@ -2552,6 +2553,35 @@ row_ins_index_entry_big_rec(
 	return(error);
 }
 
+/** Determine if an insert into an empty table may log a single
+TRX_UNDO_EMPTY record instead of undo log records for each row,
+and skip record locking for the rest of the transaction.
+This is only enabled when unique_checks=0 and foreign_key_checks=0,
+which is typically the case when loading a logical dump.
+@param[in]	trx	transaction
+@param[in]	table	table whose clustered index root page is empty
+@return whether the table may be bulk inserted into */
+static bool row_ins_bulk_insert_possible(const trx_t* trx,
+					 const dict_table_t* table)
+{
+	if (trx->check_unique_secondary || trx->check_foreigns
+	    || trx->duplicates || trx->is_wsrep()
+	    || table->is_temporary() || table->versioned() || table->fts
+	    || trx->mod_tables.find(const_cast<dict_table_t*>(table))
+	    != trx->mod_tables.end()) {
+		return false;
+	}
+
+	for (const dict_index_t* index = dict_table_get_first_index(table);
+	     index; index = dict_table_get_next_index(index)) {
+		if (dict_index_is_online_ddl(index)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /***************************************************************//**
 Tries to insert an entry into a clustered index, ignoring foreign key
 constraints. If a record with the same unique key is found, the other
@@ -2665,6 +2695,58 @@ row_ins_clust_index_entry_low(
 	}
 #endif /* UNIV_DEBUG */
 
+	if (!(flags & BTR_NO_UNDO_LOG_FLAG)
+	    && !entry->is_metadata()
+	    && btr_cur_get_block(cursor)->page.id().page_no() == index->page
+	    && page_is_empty(btr_cur_get_page(cursor))
+	    && row_ins_bulk_insert_possible(thr_get_trx(thr), index->table)) {
+		trx_t*	trx = thr_get_trx(thr);
+
+		if (lock_table_has_x(trx, index->table)) {
+			/* Any record locks could only be held by
+			ourselves, for example, on the page supremum of
+			the empty table. Play it safe. */
+			if (!index->table->n_rec_locks) {
+				err = trx_undo_report_empty(trx, index->table);
+				if (err != DB_SUCCESS) {
+					goto err_exit;
+				}
+
+				row_prebuilt_t*	prebuilt = thr->prebuilt;
+
+				if (prebuilt && prebuilt->bulk_insert
+				    && row_merge_bulk_t::is_eligible(
+					    index->table)) {
+					/* Buffer this and any further
+					entries until
+					ha_innobase::end_bulk_insert(). */
+					ut_ad(!prebuilt->bulk_store);
+					ut_ad(prebuilt->table == index->table);
+					prebuilt->bulk_store = UT_NEW_NOKEY(
+						row_merge_bulk_t(
+							index->table));
+					err = prebuilt->bulk_store->add(
+						trx, prebuilt->m_mysql_table,
+						index, entry);
+					goto err_exit;
+				}
+
+				flags |= BTR_NO_UNDO_LOG_FLAG
+					| BTR_NO_LOCKING_FLAG;
+			}
+		} else if (mode == BTR_MODIFY_LEAF) {
+			/* Acquire the exclusive table lock without
+			holding any page latches, and let the caller
+			retry with BTR_MODIFY_TREE. */
+			mtr.commit();
+			err = lock_table(0, index->table, LOCK_X, thr);
+			if (err == DB_SUCCESS) {
+				err = DB_FAIL;
+			}
+			goto func_exit;
+		}
+	}
+
 	if (UNIV_UNLIKELY(entry->info_bits != 0)) {
 		ut_ad(entry->is_metadata());
 		ut_ad(flags == BTR_NO_LOCKING_FLAG);
@@ -3185,6 +3267,15 @@ row_ins_clust_index_entry(
 		}
 	}
 
+	if (thr->prebuilt && thr->prebuilt->bulk_store) {
+		/* This is a bulk insert into an empty table. */
+		ut_ad(!n_ext);
+		DBUG_RETURN(thr->prebuilt->bulk_store->add(
+				    thr_get_trx(thr),
+				    thr->prebuilt->m_mysql_table,
+				    index, entry));
+	}
+
 	n_uniq = dict_index_is_unique(index) ? index->n_uniq : 0;
 
 #ifdef WITH_WSREP
@@ -3217,7 +3308,8 @@ row_ins_clust_index_entry(
 	   skip the undo log and record lock checking for
 	   insertion operation.
 	*/
-	if (index->table->skip_alter_undo) {
+	if (index->table->skip_alter_undo
+	    || thr_get_trx(thr)->is_bulk_insert(index->table)) {
 		flags |= BTR_NO_UNDO_LOG_FLAG | BTR_NO_LOCKING_FLAG;
 	}
 
@@ -3241,6 +3333,13 @@ row_ins_clust_index_entry(
 	/* Try then pessimistic descent to the B-tree */
 	log_free_check();
 
+	if (!(flags & BTR_NO_UNDO_LOG_FLAG)
+	    && thr_get_trx(thr)->is_bulk_insert(index->table)) {
+		/* The first attempt acquired the table lock
+		and wrote the TRX_UNDO_EMPTY record. */
+		flags |= BTR_NO_UNDO_LOG_FLAG | BTR_NO_LOCKING_FLAG;
+	}
+
 	err = row_ins_clust_index_entry_low(
 		flags, BTR_MODIFY_TREE, index, n_uniq, entry,
 		n_ext, thr);
@@ -3285,6 +3384,13 @@ row_ins_sec_index_entry(
 
 	ut_ad(thr_get_trx(thr)->id != 0);
 
+	if (thr->prebuilt && thr->prebuilt->bulk_store) {
+		/* This is a bulk insert into an empty table. */
+		return thr->prebuilt->bulk_store->add(
+			thr_get_trx(thr), thr->prebuilt->m_mysql_table,
+			index, entry);
+	}
+
 	offsets_heap = mem_heap_create(1024);
 	heap = mem_heap_create(1024);
 
@@ -3299,7 +3405,8 @@ row_ins_sec_index_entry(
 	   skip the undo log and record lock checking for
 	   insertion operation.
 	*/
-	if (index->table->skip_alter_undo) {
+	if (index->table->skip_alter_undo
+	    || thr_get_trx(thr)->is_bulk_insert(index->table)) {
 		trx_id = thr_get_trx(thr)->id;
 		flags |= BTR_NO_UNDO_LOG_FLAG | BTR_NO_LOCKING_FLAG;
 	}
@@ -3320,7 +3427,7 @@ row_ins_sec_index_entry(
 
 		err = row_ins_sec_index_entry_low(
 			flags, BTR_MODIFY_TREE, index,
-			offsets_heap, heap, entry, 0, thr);
+			offsets_heap, heap, entry, trx_id, thr);
 	}
 
 	mem_heap_free(heap);
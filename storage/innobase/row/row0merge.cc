@@ -28,6 +28,7 @@ Completed by Sunny Bains and Marko Makela
 #include <log.h>
 #include <sql_class.h>
 #include <math.h>
+#include <condition_variable>
 
 #include "row0merge.h"
 #include "row0ext.h"
@@ -38,6 +39,7 @@ Completed by Sunny Bains and Marko Makela
 #include "log0crypt.h"
 #include "dict0crea.h"
 #include "trx0purge.h"
+#include "trx0undo.h"
 #include "lock0lock.h"
 #include "pars0pars.h"
 #include "ut0sort.h"
@@ -3240,6 +3242,267 @@ row_merge(
 	return(DB_SUCCESS);
 }
 
+/** A merge pass of row_merge_sort() that is executed by the ALTER TABLE
+thread together with tasks of srv_thread_pool. Unlike row_merge(), which
+writes the runs back to back, this writes the output of merging the runs
+j and half+j at the sum of the sizes of the input runs that precede them,
+so that all pairs of runs can be merged independently of each other.
+The output file may contain unused blocks between runs. */
+class row_merge_pass_t
+{
+	/** transaction */
+	trx_t* const			m_trx;
+	/** descriptor of the index being created */
+	const row_merge_dup_t* const	m_dup;
+	/** input file */
+	const merge_file_t* const	m_file;
+	/** output file */
+	const pfs_os_file_t		m_out;
+	/** first offset of each input run, followed by m_file->offset */
+	const ulint* const		m_in_offset;
+	/** first offset of each output run */
+	const ulint* const		m_out_offset;
+	/** number of pairs of input runs */
+	const ulint			m_half;
+	/** number of output runs */
+	const ulint			m_n_out;
+	/** tablespace ID for encryption */
+	const ulint			m_space;
+	/** next output run to be written */
+	std::atomic<ulint>		m_next;
+	/** number of records written */
+	std::atomic<ulint>		m_n_rec;
+	/** first error */
+	std::atomic<dberr_t>		m_error;
+	/** end offset of the last output run */
+	ulint				m_end;
+
+	/** Merge runs until all have been claimed or an error occurs.
+	@param[in,out]	block		3 buffers
+	@param[in,out]	crypt_block	encryption buffer, or NULL */
+	void merge(row_merge_block_t* block, row_merge_block_t* crypt_block)
+	{
+		for (ulint j; (j = m_next++) < m_n_out; ) {
+			if (m_error != DB_SUCCESS) {
+				return;
+			}
+
+			if (trx_is_interrupted(m_trx)) {
+				set_error(DB_INTERRUPTED);
+				return;
+			}
+
+			merge_file_t	of;
+			of.fd = m_out;
+			of.offset = m_out_offset[j];
+			of.n_rec = 0;
+
+			ulint	foffs0 = m_in_offset[j];
+			dberr_t	error;
+
+			if (j < m_half) {
+				ulint	foffs1 = m_in_offset[m_half + j];
+
+				error = row_merge_blocks(
+					m_dup, m_file, block, &foffs0, &foffs1,
+					&of, NULL, crypt_block, m_space);
+			} else {
+				/* Copy the last run of an odd number
+				of runs. */
+				error = row_merge_blocks_copy(
+					m_dup->index, m_file, block, &foffs0,
+					&of, NULL, crypt_block, m_space)
+					? DB_SUCCESS : DB_CORRUPTION;
+			}
+
+			if (error != DB_SUCCESS) {
+				set_error(error);
+				return;
+			}
+
+			m_n_rec += of.n_rec;
+
+			if (j == m_n_out - 1) {
+				m_end = of.offset;
+			}
+		}
+	}
+
+	/** Merge runs in a task of srv_thread_pool.
+	@param[in,out]	arg	row_merge_pass_t */
+	static void merge_task(void* arg)
+	{
+		row_merge_pass_t*		pass
+			= static_cast<row_merge_pass_t*>(arg);
+		ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+		ut_new_pfx_t			block_pfx;
+		ut_new_pfx_t			crypt_pfx;
+		const size_t			block_size
+			= 3 * srv_sort_buf_size;
+		row_merge_block_t*		block
+			= alloc.allocate_large(block_size, &block_pfx);
+		row_merge_block_t*		crypt_block = NULL;
+
+		if (block && log_tmp_is_encrypted()) {
+			crypt_block = alloc.allocate_large(block_size,
+							   &crypt_pfx);
+		}
+
+		if (!block || (log_tmp_is_encrypted() && !crypt_block)) {
+			pass->set_error(DB_OUT_OF_MEMORY);
+		} else {
+			pass->merge(block, crypt_block);
+		}
+
+		if (crypt_block) {
+			alloc.deallocate_large(crypt_block, &crypt_pfx);
+		}
+
+		if (block) {
+			alloc.deallocate_large(block, &block_pfx);
+		}
+	}
+
+	/** Remember the first error.
+	@param[in]	error	error code */
+	void set_error(dberr_t error)
+	{
+		dberr_t	expected = DB_SUCCESS;
+		m_error.compare_exchange_strong(expected, error);
+	}
+
+public:
+	/** Constructor.
+	@param[in]	trx		transaction
+	@param[in]	dup		descriptor of index being created
+	@param[in]	file		input file
+	@param[in]	out		output file
+	@param[in]	in_offset	first offset of each input run,
+	followed by file->offset
+	@param[in]	out_offset	first offset of each output run
+	@param[in]	num_run		number of input runs
+	@param[in]	space		tablespace ID for encryption */
+	row_merge_pass_t(trx_t* trx, const row_merge_dup_t* dup,
+			 const merge_file_t* file, const pfs_os_file_t& out,
+			 const ulint* in_offset, const ulint* out_offset,
+			 ulint num_run, ulint space)
+		: m_trx(trx), m_dup(dup), m_file(file), m_out(out),
+		  m_in_offset(in_offset), m_out_offset(out_offset),
+		  m_half(num_run / 2), m_n_out((num_run + 1) / 2),
+		  m_space(space), m_next(0), m_n_rec(0),
+		  m_error(DB_SUCCESS), m_end(0) {}
+
+	/** Merge the runs in the current thread and in tasks.
+	@param[in]	n_threads	maximum number of threads
+	@param[in,out]	block		3 buffers of the current thread
+	@param[in,out]	crypt_block	encryption buffer, or NULL
+	@return error code or DB_SUCCESS */
+	dberr_t execute(ulint n_threads, row_merge_block_t* block,
+			row_merge_block_t* crypt_block)
+	{
+		std::vector<tpool::waitable_task*>	tasks;
+
+		n_threads = std::min(n_threads, m_n_out);
+
+		for (ulint i = 1; i < n_threads; i++) {
+			tpool::waitable_task*	task = new tpool::waitable_task(
+				merge_task, this);
+			tasks.push_back(task);
+			srv_thread_pool->submit_task(task);
+		}
+
+		merge(block, crypt_block);
+
+		for (tpool::waitable_task* task : tasks) {
+			task->wait();
+			delete task;
+		}
+
+		if (m_error == DB_SUCCESS && m_n_rec != m_file->n_rec) {
+			return DB_CORRUPTION;
+		}
+
+		return m_error;
+	}
+
+	/** @return end offset of the last output run */
+	ulint end() const { return m_end; }
+};
+
+/** Merge disk files by multiple threads.
+@param[in]	trx		transaction
+@param[in]	dup		descriptor of index being created
+@param[in,out]	file		file containing index entries
+@param[in,out]	block		3 buffers
+@param[in,out]	tmpfd		temporary file handle
+@param[in,out]	num_run		Number of runs that remain to be merged
+@param[in,out]	run_offset	Array that contains the first offset number
+for each merge run, and space for file->offset after the last run
+@param[in,out]	crypt_block	encryption buffer
+@param[in]	space		tablespace ID for encryption
+@param[in]	n_threads	maximum number of threads
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_parallel(
+	trx_t*			trx,
+	const row_merge_dup_t*	dup,
+	merge_file_t*		file,
+	row_merge_block_t*	block,
+	pfs_os_file_t*		tmpfd,
+	ulint*			num_run,
+	ulint*			run_offset,
+	row_merge_block_t*	crypt_block,
+	ulint			space,
+	ulint			n_threads)
+{
+	const ulint	n_run	= *num_run;
+	const ulint	half	= n_run / 2;
+	const ulint	n_out	= (n_run + 1) / 2;
+	ulint*		out_offset = static_cast<ulint*>(
+		ut_malloc_nokey(n_out * sizeof *out_offset));
+
+	if (!out_offset) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	run_offset[n_run] = file->offset;
+
+	/* The output of merging two runs never occupies more blocks
+	than the two input runs. */
+	for (ulint j = 0, offset = 0; j < n_out; j++) {
+		out_offset[j] = offset;
+
+		if (j < half) {
+			offset += run_offset[j + 1] - run_offset[j]
+				+ run_offset[half + j + 1]
+				- run_offset[half + j];
+		} else {
+			offset += run_offset[n_run] - run_offset[n_run - 1];
+		}
+	}
+
+	row_merge_pass_t	pass(trx, dup, file, *tmpfd, run_offset,
+				     out_offset, n_run, space);
+
+	dberr_t	error = pass.execute(n_threads, block, crypt_block);
+
+	if (error == DB_SUCCESS) {
+		memcpy(run_offset, out_offset, n_out * sizeof *run_offset);
+		*num_run = n_out;
+
+		/* Swap file descriptors for the next pass. */
+		pfs_os_file_t	fd = file->fd;
+		file->fd = *tmpfd;
+		file->offset = pass.end();
+		*tmpfd = fd;
+	}
+
+	ut_free(out_offset);
+
+	return(error);
+}
+
 /** Merge disk files.
 @param[in]	trx	transaction
 @param[in]	dup	descriptor of index being created
@@ -3258,8 +3521,9 @@ row_merge_sort(
 	row_merge_block_t*	block,
 	pfs_os_file_t*			tmpfd,
 	const bool		update_progress,
-					/*!< in: update progress
-					status variable or not */
+					/*!< in: whether to update progress
+					status variables; false when not
+					invoked by the ALTER TABLE thread */
 	const double 		pct_progress,
 					/*!< in: total progress percent
 					until now */
@@ -3275,6 +3539,12 @@ row_merge_sort(
 	ulint		merge_count = 0;
 	ulint		total_merge_sort_count;
 	double		curr_progress = 0;
+	/* Let the ALTER TABLE thread merge the runs of a non-unique
+	index by multiple threads. Duplicate key reporting of unique
+	indexes writes to the shared TABLE::record[0]. */
+	const ulint	n_threads = update_progress
+		&& !dict_index_is_unique(dup->index)
+		? srv_ddl_threads : 1;
 
 	DBUG_ENTER("row_merge_sort");
 
@@ -3293,11 +3563,19 @@ row_merge_sort(
 	total_merge_sort_count = ulint(ceil(log2(double(num_runs))));
 
 	/* "run_offset" records each run's first offset number */
-	run_offset = (ulint*) ut_malloc_nokey(file->offset * sizeof(ulint));
+	run_offset = (ulint*) ut_malloc_nokey(
+		(file->offset + 1) * sizeof(ulint));
 
-	/* This tells row_merge() where to start for the first round
-	of merge. */
-	run_offset[half] = half;
+	if (n_threads > 1) {
+		/* Initially, each block is a run. */
+		for (ulint i = 0; i < num_runs; i++) {
+			run_offset[i] = i;
+		}
+	} else {
+		/* This tells row_merge() where to start for the first
+		round of merge. */
+		run_offset[half] = half;
+	}
 
 	/* The file should always contain at least one byte (the end
 	of file marker).  Thus, it must be at least one block. */
@@ -3308,8 +3586,9 @@ row_merge_sort(
 	sol10-64 in buildbot.
 	*/
 #ifndef UNIV_SOLARIS
-	/* Progress report only for "normal" indexes. */
-	if (!(dup->index->type & DICT_FTS)) {
+	/* Progress report only for "normal" indexes
+	that are built by the ALTER TABLE thread. */
+	if (update_progress) {
 		thd_progress_init(trx->mysql_thd, 1);
 	}
 #endif /* UNIV_SOLARIS */
@@ -3326,14 +3605,24 @@ row_merge_sort(
 		show processlist progress field */
 		/* Progress report only for "normal" indexes. */
 #ifndef UNIV_SOLARIS
-		if (!(dup->index->type & DICT_FTS)) {
+		if (update_progress) {
 			thd_progress_report(trx->mysql_thd, file->offset - num_runs, file->offset);
 		}
 #endif /* UNIV_SOLARIS */
 
-		error = row_merge(trx, dup, file, block, tmpfd,
-				  &num_runs, run_offset, stage,
-				  crypt_block, space);
+		if (n_threads > 1) {
+			error = row_merge_parallel(trx, dup, file, block,
+						   tmpfd, &num_runs,
+						   run_offset, crypt_block,
+						   space, n_threads);
+			if (stage != NULL && error == DB_SUCCESS) {
+				stage->inc(file->n_rec);
+			}
+		} else {
+			error = row_merge(trx, dup, file, block, tmpfd,
+					  &num_runs, run_offset, stage,
+					  crypt_block, space);
+		}
 
 		if(update_progress) {
 			merge_count++;
@@ -3356,7 +3645,7 @@ row_merge_sort(
 
 	/* Progress report only for "normal" indexes. */
 #ifndef UNIV_SOLARIS
-	if (!(dup->index->type & DICT_FTS)) {
+	if (update_progress) {
 		thd_progress_end(trx->mysql_thd);
 	}
 #endif /* UNIV_SOLARIS */
@@ -3631,9 +3920,11 @@ row_merge_insert_index_tuples(
 
 		mem_heap_empty(tuple_heap);
 
-		/* Increment innodb_onlineddl_pct_progress status variable */
+		/* Increment innodb_onlineddl_pct_progress status variable.
+		Only the ALTER TABLE thread reports progress; the tasks of
+		row_merge_parallel_t pass pct_cost=0. */
 		inserted_rows++;
-		if(inserted_rows % 1000 == 0) {
+		if (pct_cost > 0 && inserted_rows % 1000 == 0) {
 			/* Update progress for each 1000 rows */
 			curr_progress = (inserted_rows >= table_total_rows ||
 				table_total_rows <= 0) ?
@@ -4333,6 +4624,258 @@ row_merge_drop_table(
 			trx, SQLCOM_DROP_TABLE, false, false));
 }
 
+/** Sorting and building of non-unique secondary indexes in tasks of
+srv_thread_pool, in parallel with the ALTER TABLE thread */
+class row_merge_parallel_t
+{
+	/** An index to be sorted and built */
+	struct item_t
+	{
+		/** index being created */
+		dict_index_t*	index;
+		/** file containing the unsorted index entries */
+		merge_file_t*	file;
+		/** outcome of sorting and building the index;
+		protected by m_mutex */
+		dberr_t		error;
+		/** whether the index has been processed;
+		protected by m_mutex */
+		bool		done;
+	};
+
+	/** transaction */
+	trx_t* const			m_trx;
+	/** table where rows are read from */
+	const dict_table_t* const	m_old_table;
+	/** MySQL table, for reporting erroneous key values */
+	TABLE* const			m_table;
+	/** total progress percent when the tasks were started */
+	const double			m_pct_progress;
+	/** indexes to be built */
+	std::vector<item_t>		m_items;
+	/** next element of m_items to be built by a task */
+	std::atomic<ulint>		m_next;
+	/** first error of any task or of the ALTER TABLE thread;
+	after it has been set, the tasks will not build any more indexes */
+	std::atomic<dberr_t>		m_error;
+	/** tasks that were submitted to srv_thread_pool */
+	std::vector<tpool::waitable_task*>	m_tasks;
+	/** mutex protecting item_t::error and item_t::done */
+	std::mutex			m_mutex;
+	/** signalled when an item has been processed */
+	std::condition_variable		m_done;
+
+	/** Report that an index has been processed.
+	@param[in,out]	item	index that was processed
+	@param[in]	error	outcome of sorting and building the index */
+	void finish(item_t& item, dberr_t error)
+	{
+		std::lock_guard<std::mutex>	lk(m_mutex);
+
+		if (error != DB_SUCCESS) {
+			dberr_t	expected = DB_SUCCESS;
+			m_error.compare_exchange_strong(expected, error);
+		}
+
+		item.error = error;
+		item.done = true;
+		m_done.notify_all();
+	}
+
+	/** Sort and build indexes until all of m_items have been
+	claimed. Each task uses its own buffers and temporary file. */
+	void build()
+	{
+		ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+		ut_new_pfx_t			block_pfx;
+		ut_new_pfx_t			crypt_pfx;
+		const size_t			block_size
+			= 3 * srv_sort_buf_size;
+		row_merge_block_t*		block
+			= alloc.allocate_large(block_size, &block_pfx);
+		row_merge_block_t*		crypt_block = NULL;
+		pfs_os_file_t			tmpfd = OS_FILE_CLOSED;
+		const char*			path
+			= thd_innodb_tmpdir(m_trx->mysql_thd);
+
+		if (block && log_tmp_is_encrypted()) {
+			crypt_block = alloc.allocate_large(block_size,
+							   &crypt_pfx);
+		}
+
+		for (ulint i; (i = m_next++) < m_items.size(); ) {
+			item_t&		item = m_items[i];
+			dict_index_t*	index = item.index;
+			merge_file_t*	file = item.file;
+			dberr_t		error = m_error;
+
+			if (error != DB_SUCCESS) {
+				/* Some other index could not be built.
+				Do not bother with the rest. */
+				finish(item, error);
+				continue;
+			}
+
+			if (!block
+			    || (log_tmp_is_encrypted() && !crypt_block)
+			    || !row_merge_tmpfile_if_needed(&tmpfd, path)) {
+				finish(item, DB_OUT_OF_MEMORY);
+				continue;
+			}
+
+			/* Non-unique indexes cannot report duplicates. */
+			row_merge_dup_t	dup = {index, m_table, NULL, 0};
+
+			error = row_merge_sort(
+				m_trx, &dup, file, block, &tmpfd, false,
+				m_pct_progress, 0, crypt_block,
+				index->table->space_id);
+
+			if (error == DB_SUCCESS) {
+				BtrBulk	btr_bulk(index, m_trx);
+
+				error = row_merge_insert_index_tuples(
+					index, m_old_table, file->fd, block,
+					NULL, &btr_bulk, file->n_rec,
+					m_pct_progress, 0, crypt_block,
+					index->table->space_id, NULL);
+
+				error = btr_bulk.finish(error);
+			}
+
+			ut_ad(!dup.n_dup);
+			finish(item, error);
+		}
+
+		row_merge_file_destroy_low(tmpfd);
+
+		if (crypt_block) {
+			alloc.deallocate_large(crypt_block, &crypt_pfx);
+		}
+
+		if (block) {
+			alloc.deallocate_large(block, &block_pfx);
+		}
+	}
+
+	/** Task callback
+	@param[in,out]	arg	row_merge_parallel_t */
+	static void build_task(void* arg)
+	{
+		static_cast<row_merge_parallel_t*>(arg)->build();
+	}
+
+public:
+	/** Constructor.
+	@param[in,out]	trx		transaction
+	@param[in]	old_table	table where rows are read from
+	@param[in,out]	table		MySQL table
+	@param[in]	pct_progress	total progress percent until now */
+	row_merge_parallel_t(trx_t* trx, const dict_table_t* old_table,
+			     TABLE* table, double pct_progress)
+		: m_trx(trx), m_old_table(old_table), m_table(table),
+		  m_pct_progress(pct_progress), m_next(0),
+		  m_error(DB_SUCCESS) {}
+
+	/** Destructor. */
+	~row_merge_parallel_t() { wait(); }
+
+	/** Determine if an index may be built by a task.
+	@param[in]	index	index being created
+	@return whether the index may be built in parallel */
+	static bool is_eligible(const dict_index_t* index)
+	{
+		return !(index->type & (DICT_CLUSTERED | DICT_UNIQUE
+					| DICT_FTS | DICT_SPATIAL));
+	}
+
+	/** Register an index to be built by a task.
+	@param[in,out]	index	index being created
+	@param[in,out]	file	file containing the index entries */
+	void add(dict_index_t* index, merge_file_t* file)
+	{
+		ut_ad(is_eligible(index));
+		ut_ad(file->fd != OS_FILE_CLOSED);
+		ut_ad(m_tasks.empty());
+		item_t	item = {index, file, DB_SUCCESS, false};
+		m_items.push_back(item);
+	}
+
+	/** @return number of indexes to be built by tasks */
+	ulint size() const { return m_items.size(); }
+
+	/** Submit the tasks.
+	@param[in]	n_threads	maximum number of tasks */
+	void start(ulint n_threads)
+	{
+		ut_ad(m_tasks.empty());
+		n_threads = std::min<ulint>(n_threads, m_items.size());
+
+		for (ulint i = 0; i < n_threads; i++) {
+			tpool::waitable_task*	task = new tpool::waitable_task(
+				build_task, this);
+			m_tasks.push_back(task);
+			srv_thread_pool->submit_task(task);
+		}
+	}
+
+	/** Stop the tasks from building any further indexes
+	after the ALTER TABLE thread encountered an error.
+	@param[in]	error	error code */
+	void abort(dberr_t error)
+	{
+		ut_ad(error != DB_SUCCESS);
+		dberr_t	expected = DB_SUCCESS;
+		m_error.compare_exchange_strong(expected, error);
+	}
+
+	/** Wait for all tasks to complete. */
+	void wait()
+	{
+		for (tpool::waitable_task* task : m_tasks) {
+			task->wait();
+			delete task;
+		}
+
+		m_tasks.clear();
+	}
+
+	/** Look up an index that is being built by the tasks.
+	@param[in]	index	index being created
+	@return whether the index is being built by the tasks */
+	bool contains(const dict_index_t* index) const
+	{
+		for (const item_t& item : m_items) {
+			if (item.index == index) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/** Wait for an index to be processed by the tasks.
+	@param[in]	index	index that was being built by the tasks
+	@return error code or DB_SUCCESS */
+	dberr_t wait(const dict_index_t* index)
+	{
+		for (const item_t& item : m_items) {
+			if (item.index == index) {
+				std::unique_lock<std::mutex>	lk(m_mutex);
+
+				while (!item.done) {
+					m_done.wait(lk);
+				}
+
+				return item.error;
+			}
+		}
+
+		ut_ad(0);
+		return DB_ERROR;
+	}
+};
+
 /** Build indexes on a table by reading a clustered index, creating a temporary
 file containing index entries, merge sorting these index entries and inserting
 sorted index entries to indexes.
@@ -4396,6 +4939,7 @@ row_merge_build_indexes(
 	fts_psort_t*		psort_info = NULL;
 	fts_psort_t*		merge_info = NULL;
 	bool			fts_psort_initiated = false;
+	row_merge_parallel_t*	parallel = NULL;
 
 	double total_static_cost = 0;
 	double total_dynamic_cost = 0;
@@ -4555,6 +5099,29 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
+	if (srv_ddl_threads > 1 && n_merge_files > 1) {
+		/* Let tasks sort and build the non-unique secondary
+		indexes, while we process the rest of the indexes
+		in the loop below. */
+		parallel = UT_NEW_NOKEY(row_merge_parallel_t(
+			trx, old_table, table, pct_progress));
+
+		for (ulint k = 0, i = 0; i < n_indexes; i++) {
+			if (dict_index_is_spatial(indexes[i])) {
+				continue;
+			}
+
+			if (row_merge_parallel_t::is_eligible(indexes[i])
+			    && merge_files[k].fd != OS_FILE_CLOSED) {
+				parallel->add(indexes[i], &merge_files[k]);
+			}
+
+			k++;
+		}
+
+		parallel->start(srv_ddl_threads);
+	}
+
 	for (ulint k = 0, i = 0; i < n_indexes; i++) {
 		dict_index_t*	sort_idx = indexes[i];
 
@@ -4583,6 +5150,19 @@ row_merge_build_indexes(
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
+		} else if (parallel && parallel->contains(sort_idx)) {
+			error = parallel->wait(sort_idx);
+
+			pct_progress += (COST_BUILD_INDEX_STATIC +
+					 (total_dynamic_cost
+					  * static_cast<double>(
+						  merge_files[k].offset)
+					  / static_cast<double>(
+						  total_index_blocks)))
+				/ (total_static_cost + total_dynamic_cost)
+				* (PCT_COST_MERGESORT_INDEX
+				   + PCT_COST_INSERT_INDEX) * 100;
+			onlineddl_pct_progress = ulint(pct_progress * 100);
 		} else if (merge_files[k].fd != OS_FILE_CLOSED) {
 			char	buf[NAME_LEN + 1];
 			row_merge_dup_t	dup = {
@@ -4727,6 +5307,15 @@ row_merge_build_indexes(
 		error = DB_TOO_MANY_CONCURRENT_TRXS;
 		trx->error_state = error;);
 
+	if (parallel) {
+		if (error != DB_SUCCESS) {
+			parallel->abort(error);
+		}
+
+		/* Wait for the tasks before freeing merge_files[]. */
+		UT_DELETE(parallel);
+	}
+
 	if (fts_psort_initiated) {
 		/* Clean up FTS psort related resource */
 		row_fts_psort_info_destroy(psort_info, merge_info);
@@ -4793,3 +5382,269 @@ row_merge_build_indexes(
 	DBUG_EXECUTE_IF("ib_index_crash_after_bulk_load", DBUG_SUICIDE(););
 	DBUG_RETURN(error);
 }
+
+/** Constructor.
+@param[in]	table	empty table */
+row_merge_bulk_t::row_merge_bulk_t(dict_table_t* table)
+	: m_tmpfd(OS_FILE_CLOSED), m_alloc(mem_key_row_merge_sort),
+	  m_block(NULL), m_crypt_block(NULL), m_autoinc(0)
+{
+	ut_ad(is_eligible(table));
+
+	for (dict_index_t* index = dict_table_get_first_index(table);
+	     index; index = dict_table_get_next_index(index)) {
+		merge_file_t	file = {OS_FILE_CLOSED, 0, 0};
+		m_bufs.push_back(row_merge_buf_create(index));
+		m_files.push_back(file);
+	}
+}
+
+/** Destructor. Discards any entries that were not applied. */
+row_merge_bulk_t::~row_merge_bulk_t()
+{
+	for (ulint i = 0; i < m_bufs.size(); i++) {
+		row_merge_buf_free(m_bufs[i]);
+		row_merge_file_destroy(&m_files[i]);
+	}
+
+	row_merge_file_destroy_low(m_tmpfd);
+
+	if (m_crypt_block) {
+		m_alloc.deallocate_large(m_crypt_block, &m_crypt_pfx);
+	}
+
+	if (m_block) {
+		m_alloc.deallocate_large(m_block, &m_block_pfx);
+	}
+}
+
+/** Determine if the inserts into an empty table may be buffered.
+Columns that may be stored off-page and SPATIAL or FULLTEXT
+indexes are not supported.
+@param[in]	table	empty table
+@return whether row_merge_bulk_t can be used */
+bool row_merge_bulk_t::is_eligible(const dict_table_t* table)
+{
+	if (srv_read_only_mode || table->fts
+	    || dict_table_get_first_index(table)->is_instant()) {
+		return false;
+	}
+
+	for (ulint i = 0; i < table->n_cols; i++) {
+		if (DATA_BIG_COL(dict_table_get_nth_col(table, i))) {
+			return false;
+		}
+	}
+
+	for (const dict_index_t* index = dict_table_get_first_index(table);
+	     index; index = dict_table_get_next_index(index)) {
+		if (index->type & (DICT_FTS | DICT_SPATIAL)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** Sort the buffer of an index and write it to a temporary file.
+@param[in,out]	trx	transaction
+@param[in,out]	table	MySQL table, for reporting duplicates
+@param[in]	i	position of the index in m_bufs
+@return error code */
+dberr_t row_merge_bulk_t::write_run(trx_t* trx, TABLE* table, ulint i)
+{
+	row_merge_buf_t*	buf = m_bufs[i];
+	merge_file_t*		file = &m_files[i];
+	dict_index_t*		index = buf->index;
+
+	if (dict_index_is_unique(index)) {
+		row_merge_dup_t	dup = {index, table, NULL, 0};
+		row_merge_buf_sort(buf, &dup);
+		if (dup.n_dup) {
+			trx->error_info = index;
+			return DB_DUPLICATE_KEY;
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	if (!m_block) {
+		m_block = m_alloc.allocate_large(3 * srv_sort_buf_size,
+						 &m_block_pfx);
+		if (!m_block) {
+			return DB_OUT_OF_MEMORY;
+		}
+	}
+
+	if (!m_crypt_block && log_tmp_is_encrypted()) {
+		m_crypt_block = m_alloc.allocate_large(3 * srv_sort_buf_size,
+						       &m_crypt_pfx);
+		if (!m_crypt_block) {
+			return DB_OUT_OF_MEMORY;
+		}
+	}
+
+	if (!row_merge_file_create_if_needed(
+		    file, &m_tmpfd, 0, thd_innodb_tmpdir(trx->mysql_thd))) {
+		return DB_OUT_OF_MEMORY;
+	}
+
+	file->n_rec += buf->n_tuples;
+	row_merge_buf_write(buf, file, m_block);
+
+	if (!row_merge_write(file->fd, file->offset++, m_block,
+			     m_crypt_block, index->table->space_id)) {
+		return DB_TEMP_FILE_WRITE_FAIL;
+	}
+
+	MEM_UNDEFINED(&m_block[0], srv_sort_buf_size);
+	m_bufs[i] = row_merge_buf_empty(buf);
+	return DB_SUCCESS;
+}
+
+/** Buffer an index entry.
+@param[in,out]	trx	transaction
+@param[in,out]	table	MySQL table, for reporting duplicates
+@param[in]	index	index of the table
+@param[in,out]	entry	index entry; DB_ROLL_PTR will be written
+@return error code */
+dberr_t row_merge_bulk_t::add(trx_t* trx, TABLE* table, dict_index_t* index,
+			      dtuple_t* entry)
+{
+	ulint	i = 0;
+
+	while (m_bufs[i]->index != index) {
+		i++;
+		ut_ad(i < m_bufs.size());
+	}
+
+	const ulint	n_fields = dict_index_get_n_fields(index);
+	ut_ad(dtuple_get_n_fields(entry) == n_fields);
+	ut_ad(!dtuple_get_n_ext(entry));
+
+	if (dict_index_is_clust(index)) {
+		/* The rows are not undo logged individually;
+		see btr_cur_ins_lock_and_undo(). */
+		dfield_t*	r = dtuple_get_nth_field(
+			entry, index->db_roll_ptr());
+		ut_ad(r->len == DATA_ROLL_PTR_LEN);
+		trx_write_roll_ptr(static_cast<byte*>(r->data),
+				   roll_ptr_t(1) << ROLL_PTR_INSERT_FLAG_POS);
+
+		if (unsigned ai = index->table->persistent_autoinc) {
+			const dfield_t*	dfield = dtuple_get_nth_field(
+				entry, ai - 1);
+			if (!dfield_is_null(dfield)) {
+				m_autoinc = std::max(m_autoinc, row_parse_int(
+					static_cast<const byte*>(
+						dfield->data),
+					dfield->len, dfield->type.mtype,
+					dfield->type.prtype & DATA_UNSIGNED));
+			}
+		}
+	}
+
+	ulint	extra_size;
+	ulint	size = rec_get_converted_size_temp(
+		index, entry->fields, n_fields, &extra_size);
+
+	/* Add the encoded length of extra_size; see row_merge_buf_add()
+	and row_merge_buf_encode(). */
+	size += 1 + ((extra_size + 1) >= 0x80);
+
+	if (size >= srv_sort_buf_size) {
+		return DB_TOO_BIG_RECORD;
+	}
+
+	row_merge_buf_t*	buf = m_bufs[i];
+
+	if (buf->n_tuples >= buf->max_tuples
+	    || buf->total_size + size >= srv_sort_buf_size) {
+		dberr_t	err = write_run(trx, table, i);
+		if (err != DB_SUCCESS) {
+			return err;
+		}
+		buf = m_bufs[i];
+	}
+
+	dfield_t*	fields = static_cast<dfield_t*>(
+		mem_heap_dup(buf->heap, entry->fields,
+			     n_fields * sizeof *fields));
+
+	for (ulint f = 0; f < n_fields; f++) {
+		dfield_dup(&fields[f], buf->heap);
+	}
+
+	buf->tuples[buf->n_tuples++].fields = fields;
+	buf->total_size += size;
+	return DB_SUCCESS;
+}
+
+/** Sort the buffered entries and build the indexes.
+@param[in,out]	trx	transaction
+@param[in,out]	table	MySQL table, for reporting duplicates
+@return error code */
+dberr_t row_merge_bulk_t::apply(trx_t* trx, TABLE* table)
+{
+	dberr_t	err = DB_SUCCESS;
+
+	for (ulint i = 0; err == DB_SUCCESS && i < m_bufs.size(); i++) {
+		dict_index_t*	index = m_bufs[i]->index;
+		merge_file_t*	file = &m_files[i];
+		BtrBulk		btr_bulk(index, trx);
+
+		if (file->fd == OS_FILE_CLOSED) {
+			/* All entries fit in the buffer. */
+			row_merge_buf_t*	buf = m_bufs[i];
+
+			if (dict_index_is_unique(index)) {
+				row_merge_dup_t	dup = {index, table, NULL, 0};
+				row_merge_buf_sort(buf, &dup);
+				if (dup.n_dup) {
+					err = DB_DUPLICATE_KEY;
+				}
+			} else {
+				row_merge_buf_sort(buf, NULL);
+			}
+
+			if (err == DB_SUCCESS) {
+				err = row_merge_insert_index_tuples(
+					index, index->table, OS_FILE_CLOSED,
+					NULL, buf, &btr_bulk, 0, 0, 0, NULL,
+					index->table->space_id);
+			}
+		} else {
+			if (m_bufs[i]->n_tuples) {
+				err = write_run(trx, table, i);
+			}
+
+			if (err == DB_SUCCESS) {
+				row_merge_dup_t	dup = {index, table, NULL, 0};
+				err = row_merge_sort(
+					trx, &dup, file, m_block, &m_tmpfd,
+					false, 0, 0, m_crypt_block,
+					index->table->space_id);
+			}
+
+			if (err == DB_SUCCESS) {
+				err = row_merge_insert_index_tuples(
+					index, index->table, file->fd,
+					m_block, NULL, &btr_bulk, file->n_rec,
+					0, 0, m_crypt_block,
+					index->table->space_id);
+			}
+		}
+
+		err = btr_bulk.finish(err);
+
+		if (err == DB_DUPLICATE_KEY) {
+			trx->error_info = index;
+		}
+	}
+
+	if (err == DB_SUCCESS && m_autoinc) {
+		btr_write_autoinc(m_bufs[0]->index, m_autoinc);
+	}
+
+	return err;
+}
@@ -0,0 +1,429 @@
+/*****************************************************************************
+
+Copyright (c) 2021, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel scan of a clustered index
+*******************************************************/
+
+#include "row0pread.h"
+#include "btr0pcur.h"
+#include "lock0lock.h"
+#include "rem0cmp.h"
+#include "row0vers.h"
+#include "srv0srv.h"
+#include "trx0trx.h"
+
+#include <atomic>
+#include <vector>
+
+/** Number of ranges per thread to aim for, so that the threads
+get an even share of the work even if the ranges are not of equal size */
+static const ulint	ROW_PREAD_RANGES_PER_THREAD = 4;
+
+/** Number of records between checks for interruption and waiters
+on the index tree lock */
+static const ulint	ROW_PREAD_CHECK_INTERVAL = 1024;
+
+/** Consumer of the records of a parallel scan. Each scanning thread
+passes the records to its own consumer, so that a consumer can keep a
+partial result (such as a count or a sum) without synchronization, and
+the caller merges the partial results after the scan. */
+class row_pread_consumer_t
+{
+public:
+	virtual ~row_pread_consumer_t() {}
+
+	/** Process a record.
+	@param[in]	rec	version of a clustered index record that is
+				visible in the read view
+	@param[in]	offsets	rec_get_offsets(rec)
+	@return DB_SUCCESS, or error code to abort the scan */
+	virtual dberr_t process(const rec_t* rec, const rec_offs* offsets) = 0;
+};
+
+/** Parallel scan of the records of a clustered index that are visible
+in the read view of a transaction */
+class row_parallel_scan_t
+{
+	/** transaction whose read view is used */
+	trx_t* const			m_trx;
+	/** clustered index */
+	dict_index_t* const		m_index;
+	/** memory heap for m_bounds */
+	mem_heap_t* const		m_heap;
+	/** boundaries of the ranges: range i covers the keys from
+	m_bounds[i] (inclusive) to m_bounds[i + 1] (exclusive), and NULL
+	stands for the start or the end of the index */
+	std::vector<const dtuple_t*>	m_bounds;
+	/** next range to be scanned */
+	std::atomic<ulint>		m_next;
+	/** first error that was encountered */
+	std::atomic<dberr_t>		m_error;
+	/** tasks that were submitted to srv_thread_pool */
+	std::vector<tpool::waitable_task*>	m_tasks;
+
+	/** Argument of a task */
+	struct task_arg_t
+	{
+		/** the scan */
+		row_parallel_scan_t*	scan;
+		/** consumer of the records of the task */
+		row_pread_consumer_t*	consumer;
+	};
+	/** arguments of m_tasks */
+	std::vector<task_arg_t>		m_task_args;
+
+	/** Split the index into ranges at the node pointers of the root page.
+	@param[in]	n_ranges	desired number of ranges */
+	void split(ulint n_ranges)
+	{
+		mtr_t	mtr;
+
+		m_bounds.push_back(NULL);
+
+		mtr.start();
+		mtr_s_lock_index(m_index, &mtr);
+
+		if (const buf_block_t* root = btr_root_block_get(
+			    m_index, RW_S_LATCH, &mtr)) {
+			const page_t*	page = buf_block_get_frame(root);
+
+			if (btr_page_get_level(page)) {
+				const ulint	step = std::max<ulint>(
+					1, page_get_n_recs(page) / n_ranges);
+				const rec_t*	rec = page_rec_get_next_const(
+					page_get_infimum_rec(page));
+
+				/* The first node pointer covers the
+				start of the index. */
+				for (ulint i = 0; !page_rec_is_supremum(rec);
+				     i++, rec = page_rec_get_next_const(rec)) {
+					if (!i || i % step) {
+						continue;
+					}
+
+					m_bounds.push_back(
+						dict_index_build_data_tuple(
+							rec, m_index, false,
+							dict_index_get_n_unique_in_tree_nonleaf(
+								m_index),
+							m_heap));
+				}
+			}
+		}
+
+		mtr.commit();
+
+		m_bounds.push_back(NULL);
+	}
+
+	/** Get the version of a clustered index record that is visible
+	in the read view.
+	@param[in]	rec		clustered index record
+	@param[in,out]	offsets		rec_get_offsets(rec); replaced by
+					the offsets of the visible version
+	@param[in,out]	heap		memory heap for offsets
+	@param[in,out]	vers_heap	memory heap for old versions
+	@param[in,out]	mtr		mini-transaction holding the page latch
+	@param[out]	visible		the visible version, or NULL if the
+					record does not exist in the view
+	@return DB_SUCCESS or error code */
+	dberr_t get_visible(const rec_t* rec, rec_offs** offsets,
+			    mem_heap_t** heap, mem_heap_t* vers_heap,
+			    mtr_t* mtr, const rec_t** visible) const
+	{
+		const bool	comp = dict_table_is_comp(m_index->table);
+
+		if (m_trx->isolation_level > TRX_ISO_READ_UNCOMMITTED
+		    && !lock_clust_rec_cons_read_sees(
+			    rec, m_index, *offsets, &m_trx->read_view)) {
+			rec_t*	old_vers;
+
+			mem_heap_empty(vers_heap);
+
+			dberr_t	err = row_vers_build_for_consistent_read(
+				rec, mtr, m_index, offsets,
+				&m_trx->read_view, heap, vers_heap,
+				&old_vers, NULL);
+
+			*visible = err == DB_SUCCESS && old_vers
+				&& !rec_get_deleted_flag(old_vers, comp)
+				? old_vers : NULL;
+			return(err);
+		}
+
+		*visible = rec_get_deleted_flag(rec, comp) ? NULL : rec;
+		return(DB_SUCCESS);
+	}
+
+	/** Pass the visible records in a range to a consumer.
+	@param[in]	low		start of the range, or NULL
+	@param[in]	high		end of the range (exclusive), or NULL
+	@param[in,out]	consumer	consumer of the records
+	@return DB_SUCCESS or error code */
+	dberr_t scan_range(const dtuple_t* low, const dtuple_t* high,
+			   row_pread_consumer_t* consumer) const
+	{
+		mtr_t		mtr;
+		btr_pcur_t	pcur;
+		rec_offs	offsets_[REC_OFFS_NORMAL_SIZE];
+		rec_offs*	offsets = offsets_;
+		mem_heap_t*	heap = NULL;
+		mem_heap_t*	vers_heap = mem_heap_create(srv_page_size);
+		dberr_t		err = DB_SUCCESS;
+		ulint		n_recs = 0;
+
+		rec_offs_init(offsets_);
+
+		mtr.start();
+
+		if (low) {
+			err = btr_pcur_open(m_index, low, PAGE_CUR_GE,
+					    BTR_SEARCH_LEAF, &pcur, &mtr);
+		} else {
+			btr_pcur_open_at_index_side(
+				true, m_index, BTR_SEARCH_LEAF, &pcur, true, 0,
+				&mtr);
+		}
+
+		bool	on_rec = err == DB_SUCCESS
+			&& (btr_pcur_is_on_user_rec(&pcur)
+			    || btr_pcur_move_to_next_user_rec(&pcur, &mtr));
+
+		while (on_rec) {
+			const rec_t*	rec = btr_pcur_get_rec(&pcur);
+
+			if (!rec_is_metadata(rec, *m_index)) {
+				const rec_t*	visible;
+
+				offsets = rec_get_offsets(
+					rec, m_index, offsets, true,
+					ULINT_UNDEFINED, &heap);
+
+				if (high && cmp_dtuple_rec(
+					    high, rec, offsets) <= 0) {
+					break;
+				}
+
+				err = get_visible(rec, &offsets, &heap,
+						  vers_heap, &mtr, &visible);
+
+				if (err == DB_SUCCESS && visible) {
+					err = consumer->process(visible,
+								offsets);
+				}
+
+				if (err != DB_SUCCESS) {
+					break;
+				}
+			}
+
+			if (!(++n_recs % ROW_PREAD_CHECK_INTERVAL)) {
+				if (trx_is_interrupted(m_trx)) {
+					err = DB_INTERRUPTED;
+					break;
+				}
+
+				if (m_index->lock.waiters) {
+					/* Let the waiters on the index
+					tree lock proceed. The scan continues
+					after the current record, or after
+					its predecessor if it was purged
+					meanwhile. */
+					btr_pcur_store_position(&pcur, &mtr);
+					mtr.commit();
+					os_thread_yield();
+					mtr.start();
+					btr_pcur_restore_position(
+						BTR_SEARCH_LEAF, &pcur, &mtr);
+				}
+			}
+
+			on_rec = btr_pcur_move_to_next_user_rec(&pcur, &mtr);
+		}
+
+		mtr.commit();
+		btr_pcur_close(&pcur);
+
+		if (heap) {
+			mem_heap_free(heap);
+		}
+
+		mem_heap_free(vers_heap);
+		return(err);
+	}
+
+	/** Scan ranges until all of them have been claimed or an error
+	has been encountered.
+	@param[in,out]	consumer	consumer of the records */
+	void scan(row_pread_consumer_t* consumer)
+	{
+		for (ulint i; (i = m_next++) + 1 < m_bounds.size(); ) {
+			if (m_error != DB_SUCCESS) {
+				return;
+			}
+
+			dberr_t	err = scan_range(m_bounds[i], m_bounds[i + 1],
+						 consumer);
+
+			if (err != DB_SUCCESS) {
+				dberr_t	expected = DB_SUCCESS;
+				m_error.compare_exchange_strong(expected, err);
+				return;
+			}
+		}
+	}
+
+	/** Task callback
+	@param[in,out]	arg	task_arg_t */
+	static void scan_task(void* arg)
+	{
+		task_arg_t*	task_arg = static_cast<task_arg_t*>(arg);
+		task_arg->scan->scan(task_arg->consumer);
+	}
+
+public:
+	/** Constructor.
+	@param[in,out]	trx	transaction
+	@param[in]	index	clustered index */
+	row_parallel_scan_t(trx_t* trx, dict_index_t* index)
+		: m_trx(trx), m_index(index), m_heap(mem_heap_create(1024)),
+		  m_next(0), m_error(DB_SUCCESS)
+	{
+		ut_ad(index->is_primary());
+	}
+
+	/** Destructor. */
+	~row_parallel_scan_t()
+	{
+		ut_ad(m_tasks.empty());
+		mem_heap_free(m_heap);
+	}
+
+	/** Scan the visible records.
+	@param[in]	n_threads	maximum number of threads
+	@param[in,out]	consumers	n_threads consumers
+	@return DB_SUCCESS or error code */
+	dberr_t run(ulint n_threads, row_pread_consumer_t** consumers)
+	{
+		split(n_threads * ROW_PREAD_RANGES_PER_THREAD);
+
+		/* The calling thread scans ranges as well. */
+		n_threads = std::min<ulint>(n_threads, m_bounds.size() - 1);
+
+		/* Reserve the arguments, so that they are not moved
+		while the tasks are running. */
+		m_task_args.reserve(n_threads);
+
+		for (ulint i = 1; i < n_threads; i++) {
+			m_task_args.push_back(task_arg_t{this, consumers[i]});
+			tpool::waitable_task*	task = new tpool::waitable_task(
+				scan_task, &m_task_args.back());
+			m_tasks.push_back(task);
+			srv_thread_pool->submit_task(task);
+		}
+
+		scan(consumers[0]);
+
+		for (tpool::waitable_task* task : m_tasks) {
+			task->wait();
+			delete task;
+		}
+
+		m_tasks.clear();
+
+		return(m_error);
+	}
+};
+
+/** Consumer that counts the records */
+class row_count_consumer_t : public row_pread_consumer_t
+{
+public:
+	/** number of records */
+	ulint	n_rows = 0;
+
+	dberr_t process(const rec_t*, const rec_offs*) override
+	{
+		n_rows++;
+		return(DB_SUCCESS);
+	}
+};
+
+/** Scan the records of a clustered index that are visible in the read
+view of a transaction, scanning key ranges of the index in parallel.
+The records of a key range are passed to one consumer in index order,
+but the ranges are processed in no particular order.
+@param[in,out]	trx		transaction; the read view must be open
+				unless the isolation level is READ UNCOMMITTED
+@param[in]	index		clustered index
+@param[in]	n_threads	maximum number of threads to use
+@param[in,out]	consumers	n_threads consumers, one for each thread
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_scan_parallel(
+	trx_t*			trx,
+	dict_index_t*		index,
+	ulint			n_threads,
+	row_pread_consumer_t**	consumers)
+{
+	ut_ad(trx->isolation_level == TRX_ISO_READ_UNCOMMITTED
+	      || trx->read_view.is_open());
+	ut_ad(n_threads);
+
+	row_parallel_scan_t	scan(trx, index);
+
+	return(scan.run(n_threads, consumers));
+}
+
+/** Count the records of a clustered index that are visible in the read
+view of a transaction, scanning key ranges of the index in parallel.
+@param[in,out]	trx		transaction; the read view must be open
+				unless the isolation level is READ UNCOMMITTED
+@param[in]	index		clustered index
+@param[in]	n_threads	maximum number of threads to use
+@param[out]	n_rows		number of visible records
+@return DB_SUCCESS or error code */
+dberr_t
+row_count_parallel(
+	trx_t*		trx,
+	dict_index_t*	index,
+	ulint		n_threads,
+	ulint*		n_rows)
+{
+	std::vector<row_count_consumer_t>	counts(n_threads);
+	std::vector<row_pread_consumer_t*>	consumers;
+
+	for (row_count_consumer_t& count : counts) {
+		consumers.push_back(&count);
+	}
+
+	dberr_t	err = row_scan_parallel(trx, index, n_threads,
+					consumers.data());
+
+	/* Merge the counts of the threads. */
+	*n_rows = 0;
+
+	for (const row_count_consumer_t& count : counts) {
+		*n_rows += count.n_rows;
+	}
+
+	return(err);
+}
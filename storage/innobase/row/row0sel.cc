@@ -3753,7 +3753,7 @@ row_sel_dequeue_cached_row_for_mysql(
 }
 
 /********************************************************************//**
-Initialise the prefetch cache. */
+Initialise the prefetch cache for prebuilt->fetch_cache_size rows. */
 UNIV_INLINE
 void
 row_sel_prefetch_cache_init(
@@ -3763,12 +3763,17 @@ row_sel_prefetch_cache_init(
 	ulint	i;
 	ulint	sz;
 	byte*	ptr;
+	ulint	n = prebuilt->fetch_cache_size;
 
-	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	/* Reserve space for the row pointers and the magic numbers. */
+	sz = n * (sizeof(byte*) + prebuilt->mysql_row_len + 8);
 	ptr = static_cast<byte*>(ut_malloc_nokey(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	prebuilt->fetch_cache = reinterpret_cast<byte**>(ptr);
+	prebuilt->fetch_cache_alloc = n;
+	ptr += n * sizeof(byte*);
+
+	for (i = 0; i < n; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3785,6 +3790,79 @@ row_sel_prefetch_cache_init(
 	}
 }
 
+/** Free the prefetch cache.
+@param[in,out]	prebuilt	prebuilt struct */
+void
+row_sel_prefetch_cache_free(
+	row_prebuilt_t*	prebuilt)
+{
+	if (prebuilt->fetch_cache == NULL) {
+		return;
+	}
+
+	byte*	ptr = prebuilt->fetch_cache[0] - 4;
+
+	for (ulint i = 0; i < prebuilt->fetch_cache_alloc; i++) {
+		ulint	magic1 = mach_read_from_4(ptr);
+		ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
+		ptr += 4;
+
+		byte*	row = ptr;
+		ut_a(row == prebuilt->fetch_cache[i]);
+		ptr += prebuilt->mysql_row_len;
+
+		ulint	magic2 = mach_read_from_4(ptr);
+		ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
+		ptr += 4;
+	}
+
+	ut_free(prebuilt->fetch_cache);
+	prebuilt->fetch_cache = NULL;
+	prebuilt->fetch_cache_alloc = 0;
+}
+
+/** Choose the number of rows that row_search_mvcc() caches in a batch
+for the scans of the current index.
+
+If the optimizer expects a scan to read more rows than the default size
+of the cache, the rows are cached starting from the first one, and the
+cache is made large enough to hold about a page worth of rows, so that
+the page latch and the cursor position have to be reacquired only once
+per page.
+@param[in,out]	prebuilt	prebuilt struct
+@param[in]	rows		number of rows the optimizer expects a scan
+				to read, or 0 if unknown */
+void
+row_sel_set_fetch_cache_size(
+	row_prebuilt_t*	prebuilt,
+	ib_uint64_t	rows)
+{
+	ulint	size = MYSQL_FETCH_CACHE_SIZE;
+	ulint	threshold = MYSQL_FETCH_CACHE_THRESHOLD;
+
+	if (rows > MYSQL_FETCH_CACHE_SIZE) {
+		size = srv_page_size / prebuilt->mysql_row_len;
+		size = std::min<ulint>(size, MYSQL_FETCH_CACHE_MAX_SIZE);
+		size = std::max<ulint>(size, MYSQL_FETCH_CACHE_SIZE);
+		if (rows < size) {
+			size = ulint(rows);
+		}
+		threshold = 0;
+	}
+
+	/* Discard the rows cached by the previous scan, if any */
+	prebuilt->n_fetch_cached = 0;
+	prebuilt->fetch_cache_first = 0;
+
+	if (size > prebuilt->fetch_cache_alloc) {
+		/* The cache will be allocated on the next use */
+		row_sel_prefetch_cache_free(prebuilt);
+	}
+
+	prebuilt->fetch_cache_size = size;
+	prebuilt->fetch_cache_threshold = threshold;
+}
+
 /********************************************************************//**
 Get the last fetch cache buffer from the queue.
 @return pointer to buffer. */
@@ -3795,9 +3873,9 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
+	if (prebuilt->fetch_cache == NULL) {
 		/* Allocate memory for the fetch cache */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
@@ -3835,8 +3913,7 @@ row_sel_enqueue_cache_row_for_mysql(
 /*********************************************************************//**
 Tries to do a shortcut to fetch a clustered index record with a unique key,
 using the hash index if possible (not always). We assume that the search
-mode is PAGE_CUR_GE, it is a consistent read, there is a read view in trx,
-btr search latch has been locked in S-mode if AHI is enabled.
+mode is PAGE_CUR_GE, it is a consistent read, there is a read view in trx.
 @return SEL_FOUND, SEL_EXHAUSTED, SEL_RETRY */
 static
 ulint
@@ -3857,15 +3934,15 @@ row_sel_try_search_shortcut_for_mysql(
 	ut_ad(dict_index_is_clust(index));
 	ut_ad(!prebuilt->templ_contains_blob);
 
-	rw_lock_t* ahi_latch = btr_search_sys.get_latch(*index);
-	rw_lock_s_lock(ahi_latch);
+	/* The adaptive hash index is looked up without acquiring
+	its latch. Whether the lookup succeeds or not, the leaf page
+	of rec is latched in mtr. */
 	btr_pcur_open_with_no_init(index, search_tuple, PAGE_CUR_GE,
-				   BTR_SEARCH_LEAF, pcur, ahi_latch, mtr);
+				   BTR_SEARCH_LEAF, pcur, NULL, mtr);
 	rec = btr_pcur_get_rec(pcur);
 
 	if (!page_rec_is_user_rec(rec) || rec_is_metadata(rec, *index)) {
 retry:
-		rw_lock_s_unlock(ahi_latch);
 		return(SEL_RETRY);
 	}
 
@@ -3875,7 +3952,6 @@ row_sel_try_search_shortcut_for_mysql(
 
 	if (btr_pcur_get_up_match(pcur) < dtuple_get_n_fields(search_tuple)) {
 exhausted:
-		rw_lock_s_unlock(ahi_latch);
 		return(SEL_EXHAUSTED);
 	}
 
@@ -3899,7 +3975,6 @@ row_sel_try_search_shortcut_for_mysql(
 
 	*out_rec = rec;
 
-	rw_lock_s_unlock(ahi_latch);
 	return(SEL_FOUND);
 }
 #endif /* BTR_CUR_HASH_ADAPT */
@@ -4336,7 +4411,8 @@ row_search_mvcc(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_size) {
 early_not_found:
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -5376,7 +5452,7 @@ row_search_mvcc(
 	The latch will not be released until mtr.commit(). */
 
 	if ((match_mode == ROW_SEL_EXACT
-	     || prebuilt->n_rows_fetched >= MYSQL_FETCH_CACHE_THRESHOLD)
+	     || prebuilt->n_rows_fetched >= prebuilt->fetch_cache_threshold)
 	    && prebuilt->select_lock_type == LOCK_NONE
 	    && !prebuilt->m_no_prefetch
 	    && !prebuilt->templ_contains_blob
@@ -5394,7 +5470,7 @@ row_search_mvcc(
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -5446,7 +5522,7 @@ row_search_mvcc(
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_size) {
 			goto next_rec;
 		}
 
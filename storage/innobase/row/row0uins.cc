@@ -383,6 +383,7 @@ static bool row_undo_ins_parse_undo_rec(undo_node_t* node, bool dict_locked)
 		goto close_table;
 	case TRX_UNDO_INSERT_METADATA:
 	case TRX_UNDO_INSERT_REC:
+	case TRX_UNDO_EMPTY:
 		break;
 	case TRX_UNDO_RENAME_TABLE:
 		dict_table_t* table = node->table;
@@ -416,6 +417,12 @@ static bool row_undo_ins_parse_undo_rec(undo_node_t* node, bool dict_locked)
 		return false;
 	} else {
 		ut_ad(!node->table->skip_alter_undo);
+
+		if (node->rec_type == TRX_UNDO_EMPTY) {
+			ut_ad(!node->table->is_temporary());
+			return true;
+		}
+
 		clust_index = dict_table_get_first_index(node->table);
 
 		if (clust_index != NULL) {
@@ -591,6 +598,29 @@ row_undo_ins(
 		log_free_check();
 		ut_ad(!node->table->is_temporary());
 		err = row_undo_ins_remove_clust_rec(node);
+		break;
+
+	case TRX_UNDO_EMPTY:
+		/* The table was empty when the transaction started
+		inserting into it, and none of the inserts were undo
+		logged. Empty all the indexes. */
+		for (dict_index_t* index = node->index; index;
+		     index = dict_table_get_next_index(index)) {
+			if (index->type & DICT_FTS
+			    || index->is_corrupted()) {
+				continue;
+			}
+
+			log_free_check();
+			err = btr_clear(index);
+			if (err != DB_SUCCESS) {
+				break;
+			}
+		}
+
+		if (err == DB_SUCCESS && node->table->stat_initialized) {
+			node->table->stat_n_rows = 0;
+		}
 	}
 
 	dict_table_close(node->table, dict_locked, FALSE);
@@ -134,6 +134,14 @@ my_bool	high_level_read_only;
 
 /** Sort buffer size in index creation */
 ulong	srv_sort_buf_size;
+/** Number of threads for sorting and building secondary indexes
+in index creation */
+ulong	srv_ddl_threads;
+/** Number of threads for counting the rows of a table */
+ulong	srv_parallel_read_threads;
+/** Number of page cleaner slots that flush buf_pool.flush_list
+in parallel */
+ulong	srv_n_page_cleaners;
 /** Maximum modification log file size for online index creation */
 unsigned long long	srv_online_max_size;
 
@@ -173,6 +181,9 @@ ulong		srv_page_size;
 ulong		srv_page_size_shift;
 /** innodb_log_write_ahead_size */
 ulong		srv_log_write_ahead_size;
+/** innodb_log_writer_threads; whether log_write_up_to() lets the
+dedicated log writer and flusher threads write and flush the log */
+my_bool		srv_log_writer_threads;
 
 /** innodb_adaptive_flushing; try to flush dirty pages so as to avoid
 IO bursts at the checkpoints. */
@@ -360,6 +371,8 @@ static ulint		srv_n_system_rows_inserted_old;
 static ulint		srv_n_system_rows_updated_old;
 static ulint		srv_n_system_rows_deleted_old;
 static ulint		srv_n_system_rows_read_old;
+static ulint		srv_n_purge_pages_old;
+static ulint		srv_n_purge_recs_old;
 
 ulint	srv_truncated_status_writes;
 /** Number of initialized rollback segments for persistent undo log */
@@ -842,6 +855,9 @@ srv_refresh_innodb_monitor_stats(void)
 	srv_n_system_rows_deleted_old = srv_stats.n_system_rows_deleted;
 	srv_n_system_rows_read_old = srv_stats.n_system_rows_read;
 
+	srv_n_purge_pages_old = srv_stats.n_purge_pages;
+	srv_n_purge_recs_old = srv_stats.n_purge_recs;
+
 	mutex_exit(&srv_innodb_monitor_mutex);
 }
 
@@ -1074,6 +1090,21 @@ srv_printf_innodb_monitor(
 	srv_n_system_rows_deleted_old = srv_stats.n_system_rows_deleted;
 	srv_n_system_rows_read_old = srv_stats.n_system_rows_read;
 
+	fprintf(file,
+		"Number of undo log pages purged " ULINTPF
+		", records purged " ULINTPF "\n"
+		"%.2f purged pages/s, %.2f purged records/s\n",
+		(ulint) srv_stats.n_purge_pages,
+		(ulint) srv_stats.n_purge_recs,
+		static_cast<double>(srv_stats.n_purge_pages
+				    - srv_n_purge_pages_old)
+		/ time_elapsed,
+		static_cast<double>(srv_stats.n_purge_recs
+				    - srv_n_purge_recs_old)
+		/ time_elapsed);
+	srv_n_purge_pages_old = srv_stats.n_purge_pages;
+	srv_n_purge_recs_old = srv_stats.n_purge_recs;
+
 	fputs("----------------------------\n"
 	      "END OF INNODB MONITOR OUTPUT\n"
 	      "============================\n", file);
@@ -1365,7 +1396,7 @@ void srv_monitor_task(void*)
 		if (srv_print_innodb_monitor) {
 			/* Reset mutex_skipped counter everytime
 			srv_print_innodb_monitor changes. This is to
-			ensure we will not be blocked by lock_sys.mutex
+			ensure we will not be blocked by lock_sys.latch
 			for short duration information printing,
 			such as requested by sync_array_print_long_waits() */
 			if (!monitor_state.last_srv_print_monitor) {
@@ -879,6 +879,7 @@ srv_shutdown_all_bg_threads()
 
 	lock_sys.timeout_timer.reset();
 	srv_master_timer.reset();
+	log_writer_threads_shutdown();
 
 	if (purge_sys.enabled()) {
 		srv_purge_shutdown();
@@ -1336,6 +1337,7 @@ dberr_t srv_start(bool create_new_db)
 
 	if (!srv_read_only_mode) {
 		buf_flush_page_cleaner_init();
+		log_writer_threads_init();
 
 #ifdef UNIV_LINUX
 		/* Wait for the setpriority() call to finish. */
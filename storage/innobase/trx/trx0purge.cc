@@ -25,6 +25,7 @@ Created 3/26/1996 Heikki Tuuri
 *******************************************************/
 
 #include "trx0purge.h"
+#include "dict0dict.h"
 #include "fsp0fsp.h"
 #include "fut0fut.h"
 #include "mach0data.h"
@@ -43,7 +44,9 @@ Created 3/26/1996 Heikki Tuuri
 #include "trx0trx.h"
 #include <mysql/service_wsrep.h>
 
+#include <algorithm>
 #include <unordered_map>
+#include <vector>
 
 /** Maximum allowable purge history length.  <=0 means 'infinite'. */
 ulong		srv_max_purge_lag = 0;
@@ -1095,6 +1098,200 @@ trx_purge_fetch_next_rec(
 	return(trx_purge_get_next_rec(n_pages_handled, heap));
 }
 
+/** Undo log records of one table in a purge batch */
+struct trx_purge_table_recs_t
+{
+	/** table identifier */
+	table_id_t			table_id;
+	/** whether all records refer to a clustered index record
+	by a primary key (no table-level records) */
+	bool				by_key;
+	/** the records, in the order in which they were logged */
+	std::vector<trx_purge_rec_t>	recs;
+};
+
+/** An undo log record together with the first field of the primary key
+of the record that it refers to */
+struct trx_purge_key_rec_t
+{
+	/** the first field of the primary key in the undo log record */
+	const byte*		key;
+	/** length of key */
+	uint32_t		len;
+	/** the undo log record */
+	trx_purge_rec_t		rec;
+
+	/** Compare the keys of two records.
+	@return whether the key of this record sorts before that of other */
+	bool operator<(const trx_purge_key_rec_t& other) const
+	{
+		int cmp = memcmp(key, other.key, std::min(len, other.len));
+		return cmp < 0 || (!cmp && len < other.len);
+	}
+
+	/** @return whether the keys of the two records are equal */
+	bool same_key(const trx_purge_key_rec_t& other) const
+	{
+		return len == other.len && !memcmp(key, other.key, len);
+	}
+};
+
+/** Get the first field of the primary key of the record that an undo
+log record refers to.
+@param[in]	undo_rec	undo log record
+@param[out]	key		first field of the primary key
+@param[out]	len		length of key
+@return whether the undo log record refers to a single record by key */
+static
+bool
+trx_purge_get_rec_key(
+	trx_undo_rec_t*	undo_rec,
+	const byte**	key,
+	uint32_t*	len)
+{
+	ulint		type;
+	ulint		cmpl_info;
+	bool		updated_extern;
+	undo_no_t	undo_no;
+	table_id_t	table_id;
+	trx_id_t	trx_id;
+	roll_ptr_t	roll_ptr;
+	byte		info_bits;
+	uint32_t	orig_len;
+	const byte*	ptr = trx_undo_rec_get_pars(
+		undo_rec, &type, &cmpl_info, &updated_extern, &undo_no,
+		&table_id);
+
+	switch (type) {
+	case TRX_UNDO_UPD_DEL_REC:
+	case TRX_UNDO_UPD_EXIST_REC:
+	case TRX_UNDO_DEL_MARK_REC:
+		ptr = trx_undo_update_rec_get_sys_cols(
+			ptr, &trx_id, &roll_ptr, &info_bits);
+		/* fall through */
+	case TRX_UNDO_INSERT_REC:
+		trx_undo_rec_get_col_val(ptr, key, len, &orig_len);
+		return *key != NULL && *len != UNIV_SQL_NULL && !orig_len;
+	}
+
+	return false;
+}
+
+/** Determine whether the undo log records of a table in a purge batch can
+be split by the first field of the primary key, because equal key values of
+the field are stored as equal byte strings and the byte order of the values
+keeps records with nearby keys together.
+@param[in]	table_id	table identifier
+@return whether the records can be split */
+static
+bool
+trx_purge_table_is_splittable(table_id_t table_id)
+{
+	bool	splittable = false;
+
+	mutex_enter(&dict_sys.mutex);
+
+	if (const dict_table_t* table = dict_sys.get_table(table_id)) {
+		const dict_index_t*	index = dict_table_get_first_index(
+			table);
+
+		if (index && index->is_primary()) {
+			switch (dict_index_get_nth_col(index, 0)->mtype) {
+			case DATA_INT:
+			case DATA_SYS:
+			case DATA_FIXBINARY:
+			case DATA_BINARY:
+				splittable = true;
+			}
+		}
+	}
+
+	mutex_exit(&dict_sys.mutex);
+
+	return(splittable);
+}
+
+/** Distribute the undo log records of a purge batch to purge nodes.
+
+All records of a table are processed by the same purge node, except that
+the records of a table that has more than its fair share of the batch are
+split into ranges of the first field of the primary key, and the ranges
+are processed by different nodes. The nodes then work on disjoint ranges
+of pages of the clustered index. The records of each row stay in the same
+node, in the order in which they were logged.
+@param[in,out]	tables		undo log records of each table
+@param[in]	n_recs		total number of undo log records
+@param[in]	n_purge_threads	number of purge threads */
+static
+void
+trx_purge_distribute_recs(
+	std::vector<trx_purge_table_recs_t>&	tables,
+	ulint					n_recs,
+	ulint					n_purge_threads)
+{
+	std::vector<purge_node_t*>	nodes;
+	const que_thr_t*		thr = UT_LIST_GET_FIRST(
+		purge_sys.query->thrs);
+
+	for (ulint i = 0; i < n_purge_threads; i++) {
+		ut_a(thr != NULL);
+		nodes.push_back(static_cast<purge_node_t*>(thr->child));
+		thr = UT_LIST_GET_NEXT(thrs, thr);
+	}
+
+	const ulint	fair_share = n_recs / n_purge_threads;
+	ulint		n = 0;
+	std::vector<trx_purge_key_rec_t>	key_recs;
+
+	for (trx_purge_table_recs_t& table : tables) {
+		if (n_purge_threads == 1 || !table.by_key
+		    || table.recs.size() <= fair_share
+		    || !trx_purge_table_is_splittable(table.table_id)) {
+			purge_node_t*	node = nodes[n++ % n_purge_threads];
+
+			for (const trx_purge_rec_t& rec : table.recs) {
+				node->undo_recs.push(rec);
+			}
+
+			continue;
+		}
+
+		key_recs.clear();
+
+		for (const trx_purge_rec_t& rec : table.recs) {
+			trx_purge_key_rec_t	key_rec;
+			ut_d(bool by_key =) trx_purge_get_rec_key(
+				rec.undo_rec, &key_rec.key, &key_rec.len);
+			ut_ad(by_key);
+			key_rec.rec = rec;
+			key_recs.push_back(key_rec);
+		}
+
+		/* The sort is stable, so that the records of each row
+		remain in the order in which they were logged. */
+		std::stable_sort(key_recs.begin(), key_recs.end());
+
+		const ulint	range_size = ut_max(
+			key_recs.size() / n_purge_threads, ulint(1));
+
+		for (ulint i = 0; i < key_recs.size(); ) {
+			purge_node_t*	node = nodes[n++ % n_purge_threads];
+			ulint		end = std::min(i + range_size,
+						       key_recs.size());
+
+			/* Do not split the records of a row. */
+			while (end < key_recs.size()
+			       && key_recs[end].same_key(key_recs[end - 1])) {
+				end++;
+			}
+
+			for (; i < end; i++) {
+				node->undo_recs.push(key_recs[i].rec);
+			}
+		}
+	}
+}
+
 /** Run a purge batch.
 @param n_purge_threads	number of purge threads
 @return number of undo log pages handled in the batch */
@@ -1103,7 +1300,6 @@ ulint
 trx_purge_attach_undo_recs(ulint n_purge_threads)
 {
 	que_thr_t*	thr;
-	ulint		i;
 	ulint		n_pages_handled = 0;
 	ulint		n_thrs = UT_LIST_GET_LEN(purge_sys.query->thrs);
 
@@ -1112,7 +1308,7 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 	purge_sys.head = purge_sys.tail;
 
 #ifdef UNIV_DEBUG
-	i = 0;
+	ulint	i = 0;
 	/* Debug code to validate some pre-requisites and reset done flag. */
 	for (thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
 	     thr != NULL && i < n_purge_threads;
@@ -1134,29 +1330,24 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 	ut_ad(i == n_purge_threads);
 #endif
 
-	/* Fetch and parse the UNDO records. The UNDO records are added
-	to a per purge node vector. */
+	/* Fetch and parse the UNDO records. The UNDO records are collected
+	per table and then distributed to the purge nodes. */
 	thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
 	ut_a(n_thrs > 0 && thr != NULL);
 
 	ut_ad(purge_sys.head <= purge_sys.tail);
 
-	i = 0;
-
 	const ulint		batch_size = srv_purge_batch_size;
-	std::unordered_map<table_id_t, purge_node_t*> table_id_map;
+	std::unordered_map<table_id_t, ulint> table_id_map;
+	std::vector<trx_purge_table_recs_t> tables;
+	ulint			n_recs = 0;
 	mem_heap_empty(purge_sys.heap);
 
 	while (UNIV_LIKELY(srv_undo_sources) || !srv_fast_shutdown) {
-		purge_node_t*		node;
 		trx_purge_rec_t		purge_rec;
 
 		ut_a(!thr->is_active);
 
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
-
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
 
@@ -1178,23 +1369,25 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 		table_id_t table_id = trx_undo_rec_get_table_id(
 			purge_rec.undo_rec);
 
-		purge_node_t *& table_node = table_id_map[table_id];
+		auto it = table_id_map.emplace(table_id, tables.size());
 
-		if (table_node) {
-			node = table_node;
-		} else {
-			thr = UT_LIST_GET_NEXT(thrs, thr);
+		if (it.second) {
+			tables.push_back(trx_purge_table_recs_t());
+			tables.back().table_id = table_id;
+			tables.back().by_key = true;
+		}
 
-			if (!(++i % n_purge_threads)) {
-				thr = UT_LIST_GET_FIRST(
-					purge_sys.query->thrs);
-			}
+		trx_purge_table_recs_t&	table = tables[it.first->second];
 
-			ut_a(thr != NULL);
-			table_node = node;
+		if (table.by_key) {
+			const byte*	key;
+			uint32_t	len;
+			table.by_key = trx_purge_get_rec_key(
+				purge_rec.undo_rec, &key, &len);
 		}
 
-		node->undo_recs.push(purge_rec);
+		table.recs.push_back(purge_rec);
+		n_recs++;
 
 		if (n_pages_handled >= batch_size) {
 			break;
@@ -1203,6 +1396,11 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 
 	ut_ad(purge_sys.head <= purge_sys.tail);
 
+	trx_purge_distribute_recs(tables, n_recs, n_purge_threads);
+
+	srv_stats.n_purge_pages.add(n_pages_handled);
+	srv_stats.n_purge_recs.add(n_recs);
+
 	return(n_pages_handled);
 }
 
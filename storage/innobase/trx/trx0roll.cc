@@ -30,6 +30,7 @@ Created 3/26/1996 Heikki Tuuri
 #include <mysql/service_wsrep.h>
 
 #include "fsp0fsp.h"
+#include "ha_prototypes.h"
 #include "lock0lock.h"
 #include "mach0data.h"
 #include "pars0pars.h"
@@ -160,6 +161,26 @@ dberr_t trx_t::rollback(trx_savept_t *savept)
     return DB_SUCCESS;
   }
   ut_ad(state == TRX_STATE_ACTIVE);
+  if (savept)
+  {
+    for (const auto &t : mod_tables)
+    {
+      if (t.second.is_bulk_insert() &&
+          t.second.get_first() < savept->least_undo_no)
+      {
+        /* The rows that were inserted into an empty table were not
+        undo logged individually. They can only be removed by emptying
+        the table, that is, by rolling back the whole transaction. */
+        if (mysql_thd)
+        {
+          thd_mark_transaction_to_rollback(mysql_thd, true);
+          innodb_bulk_insert_rollback_warning(mysql_thd);
+        }
+        savept= nullptr;
+        break;
+      }
+    }
+  }
 #ifdef WITH_WSREP
   if (!savept && is_wsrep() && wsrep_thd_is_SR(mysql_thd))
     wsrep_handle_SR_rollback(nullptr, mysql_thd);
@@ -569,6 +569,8 @@ trx_resurrect_table_locks(
 {
 	mtr_t			mtr;
 	table_id_set		tables;
+	/* tables that were bulk inserted into (TRX_UNDO_EMPTY) */
+	table_id_set		empty_tables;
 
 	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE) ||
 	      trx_state_eq(trx, TRX_STATE_PREPARED));
@@ -604,6 +606,9 @@ trx_resurrect_table_locks(
 			undo_rec, &type, &cmpl_info,
 			&updated_extern, &undo_no, &table_id);
 		tables.insert(table_id);
+		if (type == TRX_UNDO_EMPTY) {
+			empty_tables.insert(table_id);
+		}
 
 		undo_rec = trx_undo_get_prev_rec(
 			block, page_offset(undo_rec), undo->hdr_page_no,
@@ -629,11 +634,15 @@ trx_resurrect_table_locks(
 					trx_mod_tables_t::value_type(table,
 								     0));
 			}
-			lock_table_ix_resurrect(table, trx);
+			const bool x = empty_tables.find(*i)
+				!= empty_tables.end();
+			lock_table_resurrect(table, trx,
+					     x ? LOCK_X : LOCK_IX);
 
 			DBUG_LOG("ib_trx",
 				 "resurrect " << ib::hex(trx->id)
-				 << " IX lock on " << table->name);
+				 << (x ? " X" : " IX") << " lock on "
+				 << table->name);
 
 			dict_table_close(table, FALSE, FALSE);
 		}
@@ -1271,10 +1280,10 @@ trx_update_mod_tables_timestamp(
 		/* recheck while holding the mutex that blocks
 		table->acquire() */
 		mutex_enter(&dict_sys.mutex);
-		mutex_enter(&lock_sys.mutex);
+		lock_mutex_enter();
 		const bool do_evict = !table->get_ref_count()
 			&& !UT_LIST_GET_LEN(table->locks);
-		mutex_exit(&lock_sys.mutex);
+		lock_mutex_exit();
 		if (do_evict) {
 			dict_sys.remove(table, true);
 		}
@@ -1867,7 +1876,7 @@ trx_print_low(
 
 /**********************************************************************//**
 Prints info about a transaction.
-The caller must hold lock_sys.mutex.
+The caller must hold lock_sys.latch.
 When possible, use trx_print() instead. */
 void
 trx_print_latched(
@@ -1887,7 +1896,7 @@ trx_print_latched(
 
 /**********************************************************************//**
 Prints info about a transaction.
-Acquires and releases lock_sys.mutex. */
+Acquires and releases lock_sys.latch. */
 void
 trx_print(
 /*======*/
@@ -0,0 +1,252 @@
+/* Copyright(C) 2020 MariaDB Corporation.
+
+This program is free software; you can redistribute itand /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111 - 1301 USA*/
+
+#include "tpool_structs.h"
+
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include "tpool.h"
+#include <liburing.h>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+  Linux AIO implementation, based on io_uring.
+  Needs liburing.h and -luring at the compile time.
+
+  submit_io() is used to submit async IO. liburing is not thread-safe,
+  so preparing and submitting a submission queue entry is protected
+  by a mutex.
+
+  Files that are bound to the AIO handler are registered with the kernel
+  ("fixed files"), so that the kernel does not need to look up and
+  reference count the file descriptor on every request. Files that do
+  not fit into the registered file table are accessed by descriptor.
+
+  There is a single thread, that collects the completion notifications
+  with io_uring_wait_cqe(), and forwards io completion callback
+  the worker threadpool.
+*/
+namespace tpool
+{
+
+class aio_uring : public aio
+{
+  /** Maximum number of registered files */
+  static constexpr unsigned MAX_FIXED_FILES= 1024;
+
+  thread_pool* m_pool;
+  io_uring m_uring;
+  /** Protects the submission queue and the registered file table */
+  std::mutex m_mutex;
+  std::thread m_getevent_thread;
+  /** Whether the registered file table is available */
+  bool m_fixed_files;
+  /** Registered file table slots that are available */
+  std::vector<unsigned> m_free_slots;
+  /** Mapping of bound file descriptors to registered file table slots */
+  std::unordered_map<int, unsigned> m_slots;
+
+  static void getevent_thread_routine(aio_uring* aio)
+  {
+    for (;;)
+    {
+      io_uring_cqe* cqe;
+      int ret= io_uring_wait_cqe(&aio->m_uring, &cqe);
+      if (ret)
+      {
+        if (ret == -EINTR || ret == -EAGAIN)
+          continue;
+        fprintf(stderr, "io_uring_wait_cqe returned %d\n", ret);
+        abort();
+      }
+
+      aiocb* iocb= static_cast<aiocb*>(io_uring_cqe_get_data(cqe));
+      int res= cqe->res;
+      io_uring_cqe_seen(&aio->m_uring, cqe);
+
+      if (iocb == reinterpret_cast<aiocb*>(aio))
+        break; /* the no-op submitted by ~aio_uring() */
+      if (!iocb)
+        continue; /* a request that submit_io() failed to submit */
+
+      /* The request could not be started; retry it */
+      if (res == -EAGAIN && !aio->submit_io(iocb))
+        continue;
+
+      if (res < 0)
+      {
+        iocb->m_err= -res;
+        iocb->m_ret_len= 0;
+      }
+      else
+      {
+        iocb->m_ret_len= res;
+        iocb->m_err= 0;
+      }
+
+      iocb->m_internal_task.m_func= iocb->m_callback;
+      iocb->m_internal_task.m_arg= iocb;
+      iocb->m_internal_task.m_group= iocb->m_group;
+      aio->m_pool->submit_task(&iocb->m_internal_task);
+    }
+  }
+
+public:
+  aio_uring(thread_pool* pool) : m_pool(pool), m_fixed_files(false)
+  {
+  }
+
+  /** Initialize the ring and start the completion thread.
+  @param max_io  maximum number of outstanding requests
+  @return 0 on success, or negative error code */
+  int init(int max_io)
+  {
+    int ret= io_uring_queue_init(max_io, &m_uring, 0);
+    if (ret)
+      return ret;
+
+    /* Create a sparse registered file table that bind() will fill in.
+    Older kernels do not support this; then we will simply not use
+    registered files. */
+    std::vector<int> fds(MAX_FIXED_FILES, -1);
+    if (!io_uring_register_files(&m_uring, fds.data(), MAX_FIXED_FILES))
+    {
+      m_fixed_files= true;
+      m_free_slots.reserve(MAX_FIXED_FILES);
+      for (unsigned i= MAX_FIXED_FILES; i--; )
+        m_free_slots.push_back(i);
+    }
+
+    m_getevent_thread= std::thread(getevent_thread_routine, this);
+    return 0;
+  }
+
+  ~aio_uring()
+  {
+    if (!m_getevent_thread.joinable())
+      return; /* init() failed */
+    {
+      std::unique_lock<std::mutex> lk(m_mutex);
+      io_uring_sqe* sqe= io_uring_get_sqe(&m_uring);
+      if (!sqe)
+      {
+        io_uring_submit(&m_uring);
+        sqe= io_uring_get_sqe(&m_uring);
+      }
+      io_uring_prep_nop(sqe);
+      io_uring_sqe_set_data(sqe, this);
+      int ret= io_uring_submit(&m_uring);
+      if (ret < 1)
+      {
+        fprintf(stderr, "io_uring_submit returned %d on shutdown\n", ret);
+        abort();
+      }
+    }
+    m_getevent_thread.join();
+    io_uring_queue_exit(&m_uring);
+  }
+
+  // Inherited via aio
+  virtual int submit_io(aiocb* cb) override
+  {
+    cb->iov_base= cb->m_buffer;
+    cb->iov_len= cb->m_len;
+
+    std::unique_lock<std::mutex> lk(m_mutex);
+    io_uring_sqe* sqe= io_uring_get_sqe(&m_uring);
+    if (!sqe)
+    {
+      errno= EAGAIN;
+      return -1;
+    }
+
+    int fd= cb->m_fh;
+    unsigned flags= 0;
+    auto slot= m_slots.find(fd);
+    if (slot != m_slots.end())
+    {
+      fd= static_cast<int>(slot->second);
+      flags= IOSQE_FIXED_FILE;
+    }
+
+    if (cb->m_opcode == aio_opcode::AIO_PREAD)
+      io_uring_prep_readv(sqe, fd, static_cast<iovec*>(cb), 1, cb->m_offset);
+    else
+      io_uring_prep_writev(sqe, fd, static_cast<iovec*>(cb), 1, cb->m_offset);
+    io_uring_sqe_set_flags(sqe, flags);
+    io_uring_sqe_set_data(sqe, cb);
+
+    int ret= io_uring_submit(&m_uring);
+    /* The kernel consumes the submission queue in order, and our entry
+    is the last one. If it is still pending, the kernel did not see it. */
+    if (ret >= 0 && !io_uring_sq_ready(&m_uring))
+      return 0;
+    /* The entry would be submitted by the next io_uring_submit(), after
+    the caller has already treated the request as failed. Turn it into a
+    no-op that getevent_thread_routine() will ignore. */
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, nullptr);
+    errno= ret < 0 ? -ret : EAGAIN;
+    return -1;
+  }
+
+  // Inherited via aio
+  virtual int bind(native_file_handle& fd) override
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    if (!m_fixed_files || m_free_slots.empty())
+      return 0;
+    assert(m_slots.find(fd) == m_slots.end());
+    unsigned slot= m_free_slots.back();
+    int f= fd;
+    if (io_uring_register_files_update(&m_uring, slot, &f, 1) != 1)
+      return 0;
+    m_free_slots.pop_back();
+    m_slots.emplace(fd, slot);
+    return 0;
+  }
+  virtual int unbind(const native_file_handle& fd) override
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    auto slot= m_slots.find(fd);
+    if (slot == m_slots.end())
+      return 0;
+    /* Requests that were already submitted hold a reference to the file */
+    int f= -1;
+    io_uring_register_files_update(&m_uring, slot->second, &f, 1);
+    m_free_slots.push_back(slot->second);
+    m_slots.erase(slot);
+    return 0;
+  }
+};
+
+aio* create_linux_aio(thread_pool* pool, int max_io)
+{
+  aio_uring* aio= new aio_uring(pool);
+  int ret= aio->init(max_io);
+  if (ret)
+  {
+    fprintf(stderr, "io_uring_queue_init(%d) returned %d\n", max_io, ret);
+    delete aio;
+    return nullptr;
+  }
+  return aio;
+}
+}